@@ -0,0 +1,1035 @@
+// Headless physics benchmark, runs stress scenes on the engine's physics without a window or device.
+// Every run starts its world with Physics::StartUp, so the allocator, body pools, collision layers and
+// profiler are the engine's own. Scenes add plain bullet bodies to that world.
+//
+// Windows: build the PhysicsBenchmark project in GameEngine.sln
+// Linux, from the repository root, as one command. DirectXMath is header only, it needs its headers and
+// a sal.h on the include path, e.g. DirectXMath/Inc and DirectX-Headers/include/wsl/stubs:
+//   g++ -O2 -std=c++14 -DBT_THREADSAFE=1 -pthread -IThirdparty/BulletPhysics -ISource -I<DirectXMath>
+//       Benchmarks/PhysicsBenchmark/PhysicsBenchmark.cpp
+//       Source/Physics.cpp Source/RigidBody.cpp Source/Allocator.cpp Source/Assert.cpp Source/WriteLog.cpp
+//       $(find Thirdparty/BulletPhysics/LinearMath Thirdparty/BulletPhysics/BulletCollision Thirdparty/BulletPhysics/BulletDynamics -name '*.cpp')
+//       -o physics_benchmark
+//
+// Usage: physics_benchmark [scene|all] [counts] [frames] [threads]
+//   scene   boxes, contacts, pistons, triggers, projectiles, overlaps, overlaps_brute, sweeps, rays, rays_single,
+//           characters_legacy, characters_sweep or all
+//   counts  comma separated body counts, e.g. 250,500,1000, defaults per scene
+//   frames  simulated frames per run, default 600
+//   threads comma separated thread counts, e.g. 1,2,4,8, more than 1 uses the multithreaded world
+
+#include "Physics.h"
+#include "Types.h"
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+
+static const float TIME_STEP = 1.f / 60.f;
+
+
+struct BenchmarkWorld
+{
+	Physics physics;
+	btDiscreteDynamicsWorld* world = nullptr;
+	std::vector<btCollisionShape*> shapes;
+};
+
+
+struct Result
+{
+	std::vector<double> stepTimes;
+	std::vector<double> queryTimes;
+	U64 totalQueryHits = 0;
+	U64 totalPairs = 0;
+	U64 totalManifolds = 0;
+	U64 totalContacts = 0;
+	U64 totalIslands = 0;
+	double phaseMs[NUM_PHYSICS_PHASES] = {};
+	U32 numBodies = 0;
+
+	// physics allocations over the second half of the run, once the scene has settled
+	U64 steadyAllocations = 0;
+	U32 steadyFrames = 0;
+};
+
+
+// scenes build their bodies up front and may move or spawn bodies before every step
+struct Scene
+{
+	virtual ~Scene() {}
+	virtual void Build(BenchmarkWorld& bw, U32 count) = 0;
+	virtual void Update(BenchmarkWorld&, U32) {}
+
+	// work the engine does before and after every step, timed with the step
+	virtual void PreStep(BenchmarkWorld&) {}
+	virtual void PostStep(BenchmarkWorld&) {}
+
+	// spatial queries gameplay would run after the step, timed on their own, returns the number of hits
+	virtual U32 Query(BenchmarkWorld&) { return 0; }
+};
+
+
+// small deterministic generator so every run sees the same scene
+static float RandomFloat(U32& seed)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return (seed >> 8) * (1.f / 16777216.f);
+}
+
+
+static bool CreateWorld(BenchmarkWorld& bw, U32 numThreads)
+{
+	PhysicsConfig config;
+	config.multithreaded = numThreads > 1;
+	config.numThreads = numThreads;
+	if (!bw.physics.StartUp(nullptr, config))
+	{
+		return false;
+	}
+
+	if (config.multithreaded && !bw.physics.IsMultithreaded())
+	{
+		printf("multithreaded world needs BT_THREADSAFE=1\n");
+		return false;
+	}
+
+	bw.world = bw.physics.GetDynamicsWorld();
+	return true;
+}
+
+
+static void DestroyBody(BenchmarkWorld& bw, btRigidBody* body)
+{
+	bw.world->removeRigidBody(body);
+	delete body->getMotionState();
+	delete body;
+}
+
+
+// scenes own their bodies and shapes, they're freed before the engine shuts the world down
+static void DestroyWorld(BenchmarkWorld& bw)
+{
+	for (int i = bw.world->getNumCollisionObjects() - 1; i >= 0; i--)
+	{
+		btCollisionObject* obj = bw.world->getCollisionObjectArray()[i];
+		btRigidBody* body = btRigidBody::upcast(obj);
+		if (body)
+		{
+			DestroyBody(bw, body);
+		}
+		else
+		{
+			bw.world->removeCollisionObject(obj);
+			delete obj;
+		}
+	}
+
+	for (btCollisionShape* shape : bw.shapes)
+	{
+		delete shape;
+	}
+	bw.shapes.clear();
+
+	// the world is empty by now, so nothing goes back to the engine's body pools
+	bw.physics.ShutDown();
+	bw.world = nullptr;
+}
+
+
+// shapes are shared between bodies like the engine's shape cache
+static btCollisionShape* AddShape(BenchmarkWorld& bw, btCollisionShape* shape)
+{
+	bw.shapes.push_back(shape);
+	return shape;
+}
+
+
+enum BodyType
+{
+	BODY_STATIC,
+	BODY_DYNAMIC,
+	BODY_KINEMATIC
+};
+
+
+static btRigidBody* CreateBody(BenchmarkWorld& bw, btCollisionShape* shape, const btVector3& position, BodyType type,
+							   CollisionLayer layer)
+{
+	btTransform transform;
+	transform.setIdentity();
+	transform.setOrigin(position);
+
+	float mass = type == BODY_DYNAMIC ? 1.f : 0.f;
+	btVector3 localInertia(0, 0, 0);
+	if (type == BODY_DYNAMIC)
+	{
+		shape->calculateLocalInertia(mass, localInertia);
+	}
+
+	btDefaultMotionState* motionState = new btDefaultMotionState(transform);
+	btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState, shape, localInertia);
+	btRigidBody* body = new btRigidBody(rbInfo);
+
+	if (type == BODY_KINEMATIC)
+	{
+		body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
+		body->setActivationState(DISABLE_DEACTIVATION);
+	}
+
+	bw.world->addRigidBody(body, LayerMask(layer), bw.physics.GetCollisionMask(layer));
+	return body;
+}
+
+
+static void CreateGround(BenchmarkWorld& bw, float halfExtent)
+{
+	btCollisionShape* ground = AddShape(bw, new btBoxShape(btVector3(halfExtent, 1, halfExtent)));
+	CreateBody(bw, ground, btVector3(0, -1, 0), BODY_STATIC, LAYER_STATIC);
+}
+
+
+static void MoveKinematic(btRigidBody* body, const btVector3& position)
+{
+	btTransform transform;
+	transform.setIdentity();
+	transform.setOrigin(position);
+	body->getMotionState()->setWorldTransform(transform);
+}
+
+
+// boxes dropped in columns onto a plane, they pile up and most of them fall asleep
+struct BoxesScene : public Scene
+{
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		CreateGround(bw, 100);
+
+		btCollisionShape* box = AddShape(bw, new btBoxShape(btVector3(0.5f, 0.5f, 0.5f)));
+		U32 side = (U32)ceil(sqrt(count / 10.0));
+		for (U32 i = 0; i < count; ++i)
+		{
+			U32 column = i % (side * side);
+			U32 height = i / (side * side);
+			btVector3 position((column % side) * 1.5f - side * 0.75f, 2.f + height * 1.2f, (column / side) * 1.5f - side * 0.75f);
+			CreateBody(bw, box, position, BODY_DYNAMIC, LAYER_DYNAMIC);
+		}
+	}
+};
+
+
+// columns of boxes stacked four high that never sleep, every box rests on the one below with four contact points
+// and they're all delivered to a listener each step, like systems that ask for contact stay. 1250 boxes make 5000 contacts
+struct ContactsScene : public Scene
+{
+	static const U32 NUM_LAYERS = 4;
+
+	struct ContactCounter : public CollisionListener
+	{
+		U64 numContacts = 0;
+
+		void OnCollision(CollisionInfo* collision) override
+		{
+			numContacts += collision->numContactPoints;
+		}
+	};
+
+	ContactCounter counter;
+
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		CreateGround(bw, 100);
+
+		btCollisionShape* box = AddShape(bw, new btBoxShape(btVector3(0.5f, 0.5f, 0.5f)));
+		U32 side = (U32)ceil(sqrt((double)count / NUM_LAYERS));
+		for (U32 i = 0; i < count; ++i)
+		{
+			U32 column = i % (side * side);
+			U32 layer = i / (side * side);
+			btVector3 position((column % side) * 1.1f - side * 0.55f, 0.5f + layer * 1.f, (column / side) * 1.1f - side * 0.55f);
+			btRigidBody* body = CreateBody(bw, box, position, BODY_DYNAMIC, LAYER_DYNAMIC);
+			body->setActivationState(DISABLE_DEACTIVATION);
+
+			// entity i, generation 0, so the engine routes the box's contacts to the counter
+			Entity e;
+			e.id = i;
+			RigidBody(body).SetEntity(e);
+			bw.physics.AddCollisionListener(e, &counter, true);
+		}
+	}
+
+	// reported as hits, the contact points delivered to the listener since the last frame
+	U32 Query(BenchmarkWorld&) override
+	{
+		U32 delivered = (U32)counter.numContacts;
+		counter.numContacts = 0;
+		return delivered;
+	}
+};
+
+
+// kinematic pistons like MakePiston moving up and down under a dynamic box each
+struct PistonsScene : public Scene
+{
+	std::vector<btRigidBody*> pistons;
+	std::vector<btVector3> bases;
+
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		CreateGround(bw, 200);
+
+		btCollisionShape* pistonShape = AddShape(bw, new btBoxShape(btVector3(1, 1, 1)));
+		btCollisionShape* box = AddShape(bw, new btBoxShape(btVector3(0.5f, 0.5f, 0.5f)));
+		U32 side = (U32)ceil(sqrt((double)count));
+		for (U32 i = 0; i < count; ++i)
+		{
+			btVector3 base((i % side) * 3.f - side * 1.5f, 1.f, (i / side) * 3.f - side * 1.5f);
+			bases.push_back(base);
+			pistons.push_back(CreateBody(bw, pistonShape, base, BODY_KINEMATIC, LAYER_KINEMATIC));
+			CreateBody(bw, box, base + btVector3(0, 2, 0), BODY_DYNAMIC, LAYER_DYNAMIC);
+		}
+	}
+
+	void Update(BenchmarkWorld&, U32 frame) override
+	{
+		for (size_t i = 0; i < pistons.size(); ++i)
+		{
+			float height = 1.5f + 1.5f * sinf(frame * TIME_STEP * 2.f + i * 0.37f);
+			MoveKinematic(pistons[i], bases[i] + btVector3(0, height, 0));
+		}
+	}
+};
+
+
+// a grid of trigger ghosts like coins and checkpoints with characters walking through them
+struct TriggersScene : public Scene
+{
+	static const U32 NUM_CHARACTERS = 32;
+	std::vector<btRigidBody*> characters;
+	std::vector<btPairCachingGhostObject*> triggers;
+	float radius = 0;
+	U32 overlaps = 0;
+
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		CreateGround(bw, 200);
+
+		btCollisionShape* trigger = AddShape(bw, new btBoxShape(btVector3(1, 1, 1)));
+		U32 side = (U32)ceil(sqrt((double)count));
+		for (U32 i = 0; i < count; ++i)
+		{
+			btVector3 position((i % side) * 3.f - side * 1.5f, 1.f, (i / side) * 3.f - side * 1.5f);
+			btPairCachingGhostObject* ghost = new btPairCachingGhostObject();
+			ghost->setCollisionShape(trigger);
+			ghost->setWorldTransform(btTransform(btQuaternion::getIdentity(), position));
+			ghost->setCollisionFlags(ghost->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_NO_CONTACT_RESPONSE);
+			bw.world->addCollisionObject(ghost, LayerMask(LAYER_TRIGGER), bw.physics.GetCollisionMask(LAYER_TRIGGER));
+			triggers.push_back(ghost);
+		}
+
+		radius = side * 1.5f;
+		btCollisionShape* capsule = AddShape(bw, new btCapsuleShape(0.5f, 1.f));
+		for (U32 i = 0; i < NUM_CHARACTERS; ++i)
+		{
+			characters.push_back(CreateBody(bw, capsule, btVector3(0, 1.5f, 0), BODY_KINEMATIC, LAYER_CHARACTER));
+		}
+	}
+
+	void Update(BenchmarkWorld&, U32 frame) override
+	{
+		// each character circles the grid at its own distance from the centre
+		for (size_t i = 0; i < characters.size(); ++i)
+		{
+			float distance = radius * (i + 1) / characters.size();
+			float angle = frame * TIME_STEP * 0.5f + i;
+			MoveKinematic(characters[i], btVector3(cosf(angle) * distance, 1.5f, sinf(angle) * distance));
+		}
+	}
+
+	void PostStep(BenchmarkWorld&) override
+	{
+		// the overlap pass Physics::UpdateTriggers runs every step
+		overlaps = 0;
+		for (btPairCachingGhostObject* ghost : triggers)
+		{
+			btBroadphasePairArray& pairs = ghost->getOverlappingPairCache()->getOverlappingPairArray();
+			for (int i = 0; i < pairs.size(); ++i)
+			{
+				const btCollisionObject* obj0 = static_cast<const btCollisionObject*>(pairs[i].m_pProxy0->m_clientObject);
+				const btCollisionObject* obj1 = static_cast<const btCollisionObject*>(pairs[i].m_pProxy1->m_clientObject);
+				if (ObjectsOverlap(ghost, obj0 == ghost ? obj1 : obj0))
+				{
+					overlaps++;
+				}
+			}
+		}
+	}
+};
+
+
+// guns firing spheres like RBGunSystem, shots are despawned like YDespawnSystem
+struct ProjectilesScene : public Scene
+{
+	static const U32 FIRE_INTERVAL = 20;
+	static const U32 LIFETIME = 300;
+	struct Shot
+	{
+		btRigidBody* body;
+		U32 spawnFrame;
+	};
+
+	btCollisionShape* sphere = nullptr;
+	std::vector<Shot> shots;
+	U32 numGuns = 0;
+
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		CreateGround(bw, 100);
+
+		// some platforms for the shots to bounce off
+		btCollisionShape* platform = AddShape(bw, new btBoxShape(btVector3(5, 1, 5)));
+		for (int i = 0; i < 16; ++i)
+		{
+			CreateBody(bw, platform, btVector3((i % 4) * 20.f - 30.f, 5.f, (i / 4) * 20.f - 30.f), BODY_STATIC, LAYER_STATIC);
+		}
+
+		sphere = AddShape(bw, new btSphereShape(0.5f));
+		numGuns = count;
+	}
+
+	void Update(BenchmarkWorld& bw, U32 frame) override
+	{
+		for (size_t i = 0; i < shots.size();)
+		{
+			btRigidBody* body = shots[i].body;
+			if (body->getWorldTransform().getOrigin().getY() < -50.f || frame - shots[i].spawnFrame > LIFETIME)
+			{
+				DestroyBody(bw, body);
+				shots[i] = shots.back();
+				shots.pop_back();
+			}
+			else
+			{
+				++i;
+			}
+		}
+
+		// guns take turns so the spawn rate is steady
+		for (U32 gun = frame % FIRE_INTERVAL; gun < numGuns; gun += FIRE_INTERVAL)
+		{
+			float angle = gun * 2.39996f;
+			btVector3 position(cosf(angle) * 40.f, 10.f + (gun % 7), sinf(angle) * 40.f);
+			btRigidBody* body = CreateBody(bw, sphere, position, BODY_DYNAMIC, LAYER_PROJECTILE);
+			body->setLinearVelocity(-position.normalized() * 30.f + btVector3(0, 5, 0));
+			shots.push_back({ body, frame });
+		}
+	}
+};
+
+
+// static spheres and boxes scattered through a volume at constant density, probed by queries every frame
+struct QueryScene : public Scene
+{
+	static const U32 NUM_QUERIES = 256;
+	static const U32 GRAIN_SIZE = 16;
+	float extent = 0;
+	std::vector<btVector3> points;
+
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		btCollisionShape* sphere = AddShape(bw, new btSphereShape(0.5f));
+		btCollisionShape* box = AddShape(bw, new btBoxShape(btVector3(0.5f, 0.5f, 0.5f)));
+
+		// about one body per 8 cubic units
+		extent = powf((float)count * 8.f, 1.f / 3.f) * 0.5f;
+		U32 seed = 1;
+		for (U32 i = 0; i < count; ++i)
+		{
+			btVector3 position = RandomPoint(seed);
+			CreateBody(bw, i % 2 ? box : sphere, position, BODY_STATIC, i % 3 ? LAYER_STATIC : LAYER_KINEMATIC);
+		}
+
+		for (U32 i = 0; i < NUM_QUERIES; ++i)
+		{
+			points.push_back(RandomPoint(seed));
+		}
+	}
+
+	btVector3 RandomPoint(U32& seed)
+	{
+		return btVector3(RandomFloat(seed) * 2.f - 1.f, RandomFloat(seed) * 2.f - 1.f, RandomFloat(seed) * 2.f - 1.f) * extent;
+	}
+
+	// queries are spread over the threads the way Physics splits its batches
+	void RunBatch(BenchmarkWorld& bw, const btIParallelForBody& body)
+	{
+		if (bw.physics.IsMultithreaded())
+		{
+			btParallelFor(0, NUM_QUERIES, GRAIN_SIZE, body);
+		}
+		else
+		{
+			body.forLoop(0, NUM_QUERIES);
+		}
+	}
+};
+
+
+// sphere overlaps through the broadphase like Physics::OverlapSphereBatch
+struct OverlapsScene : public QueryScene
+{
+	static const U32 MAX_ENTITIES = 64;
+	Entity entities[NUM_QUERIES * MAX_ENTITIES];
+	U32 numEntities[NUM_QUERIES];
+
+	struct Body : public btIParallelForBody
+	{
+		OverlapsScene* scene;
+		btCollisionWorld* world;
+
+		void forLoop(int begin, int end) const override
+		{
+			btSphereShape shape(3.f);
+			for (int i = begin; i < end; ++i)
+			{
+				btTransform transform(btQuaternion::getIdentity(), scene->points[i]);
+				scene->numEntities[i] = QueryOverlap(world, &shape, transform, scene->entities + i * MAX_ENTITIES, MAX_ENTITIES, ALL_LAYERS, false);
+			}
+		}
+	};
+
+	U32 Query(BenchmarkWorld& bw) override
+	{
+		Body body;
+		body.scene = this;
+		body.world = bw.world;
+		RunBatch(bw, body);
+
+		U32 hits = 0;
+		for (U32 i = 0; i < NUM_QUERIES; ++i)
+		{
+			hits += numEntities[i];
+		}
+		return hits;
+	}
+};
+
+
+// the same overlaps answered by a distance check against every body's bounding sphere
+struct OverlapsBruteScene : public QueryScene
+{
+	U32 Query(BenchmarkWorld& bw) override
+	{
+		const btCollisionObjectArray& objects = bw.world->getCollisionObjectArray();
+		U32 hits = 0;
+		for (const btVector3& point : points)
+		{
+			for (int i = 0; i < objects.size(); ++i)
+			{
+				btVector3 center;
+				btScalar radius;
+				objects[i]->getCollisionShape()->getBoundingSphere(center, radius);
+				btScalar reach = radius + 3.f;
+				if ((objects[i]->getWorldTransform() * center).distance2(point) <= reach * reach)
+				{
+					hits++;
+				}
+			}
+		}
+		return hits;
+	}
+};
+
+
+// capsules swept a few metres through the volume like Physics::SweepConvexBatch
+struct SweepsScene : public QueryScene
+{
+	btCapsuleShape capsule{ 0.5f, 1.f };
+	std::vector<btVector3> ends;
+	bool hits[NUM_QUERIES];
+
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		QueryScene::Build(bw, count);
+
+		U32 seed = 7;
+		for (const btVector3& point : points)
+		{
+			btVector3 direction(RandomFloat(seed) - 0.5f, RandomFloat(seed) - 0.5f, RandomFloat(seed) - 0.5f);
+			ends.push_back(point + direction.safeNormalize() * 8.f);
+		}
+	}
+
+	struct Body : public btIParallelForBody
+	{
+		SweepsScene* scene;
+		btCollisionWorld* world;
+
+		void forLoop(int begin, int end) const override
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				btTransform start(btQuaternion::getIdentity(), scene->points[i]);
+				btTransform stop(btQuaternion::getIdentity(), scene->ends[i]);
+				ClosestSweepFilterCallback callback(start.getOrigin(), stop.getOrigin(), ALL_LAYERS, false, nullptr);
+				world->convexSweepTest(&scene->capsule, start, stop, callback);
+				scene->hits[i] = callback.hasHit();
+			}
+		}
+	};
+
+	U32 Query(BenchmarkWorld& bw) override
+	{
+		Body body;
+		body.scene = this;
+		body.world = bw.world;
+		RunBatch(bw, body);
+
+		U32 numHits = 0;
+		for (U32 i = 0; i < NUM_QUERIES; ++i)
+		{
+			numHits += hits[i] ? 1 : 0;
+		}
+		return numHits;
+	}
+};
+
+
+// rays cast through the volume in one Physics::RayCastBatch, split across the physics threads
+struct RaysScene : public QueryScene
+{
+	static const U32 NUM_RAYS = 10000;
+	std::vector<Ray> rays;
+	std::vector<RayHit> hits;
+
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		QueryScene::Build(bw, count);
+
+		U32 seed = 11;
+		for (U32 i = 0; i < NUM_RAYS; ++i)
+		{
+			btVector3 start = RandomPoint(seed);
+			btVector3 direction(RandomFloat(seed) - 0.5f, RandomFloat(seed) - 0.5f, RandomFloat(seed) - 0.5f);
+			btVector3 end = start + direction.safeNormalize() * 16.f;
+			rays.push_back({ Physics::VecToDX(start), Physics::VecToDX(end) });
+		}
+		hits.resize(NUM_RAYS);
+	}
+
+	U32 Query(BenchmarkWorld& bw) override
+	{
+		bw.physics.RayCastBatch(rays.data(), hits.data(), NUM_RAYS);
+		return CountHits();
+	}
+
+	U32 CountHits() const
+	{
+		U32 numHits = 0;
+		for (const RayHit& hit : hits)
+		{
+			numHits += hit.hit ? 1 : 0;
+		}
+		return numHits;
+	}
+};
+
+
+// the same rays cast one at a time with Physics::RayCast
+struct RaysSingleScene : public RaysScene
+{
+	U32 Query(BenchmarkWorld& bw) override
+	{
+		for (U32 i = 0; i < NUM_RAYS; ++i)
+		{
+			bw.physics.RayCast(rays[i], hits[i]);
+		}
+		return CountHits();
+	}
+};
+
+
+// characters walking over a level with pillars and low steps, base for both character pipelines
+struct CharacterScene : public Scene
+{
+	static const U32 GRAIN_SIZE = 4;
+	const float speed = 0.08f;		// units per frame like VelocityComponent
+	const float gravity = 0.01f;
+	std::vector<btRigidBody*> characters;
+	std::vector<btVector3> positions;
+	std::vector<btVector3> velocities;
+	std::vector<bool> grounded;
+	btCapsuleShape* capsule = nullptr;
+
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		// about 16 square units of floor per character
+		float extent = sqrtf(count * 16.f) * 0.5f + 10.f;
+		CreateGround(bw, extent);
+
+		btCollisionShape* pillar = AddShape(bw, new btBoxShape(btVector3(0.5f, 1.f, 0.5f)));
+		btCollisionShape* step = AddShape(bw, new btBoxShape(btVector3(1.f, 0.1f, 1.f)));
+		U32 seed = 3;
+		for (U32 i = 0; i < count / 2 + 1; ++i)
+		{
+			btVector3 position((RandomFloat(seed) * 2.f - 1.f) * extent, 0, (RandomFloat(seed) * 2.f - 1.f) * extent);
+			bool isPillar = i % 2 == 0;
+			position.setY(isPillar ? 1.f : 0.1f);
+			CreateBody(bw, isPillar ? pillar : step, position, BODY_STATIC, LAYER_STATIC);
+		}
+
+		capsule = static_cast<btCapsuleShape*>(AddShape(bw, new btCapsuleShape(0.4f, 1.f)));
+		for (U32 i = 0; i < count; ++i)
+		{
+			btVector3 position((RandomFloat(seed) * 2.f - 1.f) * extent, 1.f, (RandomFloat(seed) * 2.f - 1.f) * extent);
+			btRigidBody* body = CreateBody(bw, capsule, position, BODY_KINEMATIC, LAYER_CHARACTER);
+			body->setUserIndex(i);
+			characters.push_back(body);
+			positions.push_back(position);
+			velocities.push_back(btVector3(0, 0, 0));
+			grounded.push_back(false);
+		}
+	}
+
+	void Update(BenchmarkWorld&, U32 frame) override
+	{
+		// walk in slowly turning directions, gravity builds up like KinematicGravitySystem
+		for (size_t i = 0; i < characters.size(); ++i)
+		{
+			float angle = i * 2.39996f + frame * 0.01f;
+			float fall = velocities[i].getY() - gravity;
+			velocities[i] = btVector3(cosf(angle) * speed, fall, sinf(angle) * speed);
+		}
+	}
+
+	void PushTransforms()
+	{
+		for (size_t i = 0; i < characters.size(); ++i)
+		{
+			MoveKinematic(characters[i], positions[i]);
+		}
+	}
+
+	void RunBatch(BenchmarkWorld& bw, const btIParallelForBody& body)
+	{
+		if (bw.physics.IsMultithreaded())
+		{
+			btParallelFor(0, (int)characters.size(), GRAIN_SIZE, body);
+		}
+		else
+		{
+			body.forLoop(0, (int)characters.size());
+		}
+	}
+};
+
+
+// the old pipeline: integrate the velocity, cast a leg down for the ground,
+// then push out of static geometry along the first contact of every manifold
+struct CharactersLegacyScene : public CharacterScene
+{
+	const float legLength = 1.f;
+
+	struct LegBody : public btIParallelForBody
+	{
+		CharactersLegacyScene* scene;
+		btCollisionWorld* world;
+
+		void forLoop(int begin, int end) const override
+		{
+			for (int i = begin; i < end; ++i)
+			{
+				btVector3 start = scene->positions[i];
+				btVector3 stop = start - btVector3(0, scene->legLength, 0);
+				ClosestRayFilterCallback callback(start, stop, ALL_LAYERS & ~LayerMask(LAYER_CHARACTER), false);
+				world->rayTest(start, stop, callback);
+
+				scene->grounded[i] = callback.hasHit();
+				if (callback.hasHit())
+				{
+					scene->positions[i] += callback.m_hitPointWorld - stop;
+					scene->velocities[i].setY(0);
+				}
+			}
+		}
+	};
+
+	void PreStep(BenchmarkWorld& bw) override
+	{
+		for (size_t i = 0; i < characters.size(); ++i)
+		{
+			positions[i] += velocities[i];
+		}
+
+		LegBody body;
+		body.scene = this;
+		body.world = bw.world;
+		RunBatch(bw, body);
+
+		PushTransforms();
+	}
+
+	void PostStep(BenchmarkWorld& bw) override
+	{
+		btDispatcher* dispatcher = bw.world->getDispatcher();
+		for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+		{
+			btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(i);
+			if (manifold->getNumContacts() == 0)
+			{
+				continue;
+			}
+
+			const btCollisionObject* obj0 = manifold->getBody0();
+			const btCollisionObject* obj1 = manifold->getBody1();
+			bool firstIsCharacter = obj0->getBroadphaseHandle()->m_collisionFilterGroup == LayerMask(LAYER_CHARACTER);
+			bool secondIsCharacter = obj1->getBroadphaseHandle()->m_collisionFilterGroup == LayerMask(LAYER_CHARACTER);
+			if (firstIsCharacter == secondIsCharacter)
+			{
+				continue;
+			}
+
+			// only the first contact point, like KinematicCharacterControllerSystem
+			const btManifoldPoint& point = manifold->getContactPoint(0);
+			btScalar sign = firstIsCharacter ? btScalar(-1) : btScalar(1);
+			U32 index = (firstIsCharacter ? obj0 : obj1)->getUserIndex();
+			positions[index] += point.m_normalWorldOnB * point.getDistance() * sign;
+		}
+	}
+};
+
+
+// the sweep based controller like Physics::MoveCharacters, characters no longer touch static geometry in the step
+struct CharactersSweepScene : public CharacterScene
+{
+	CharacterMotionSettings settings;
+	btAlignedObjectArray<CharacterMotion> motions;
+
+	void Build(BenchmarkWorld& bw, U32 count) override
+	{
+		bw.physics.SetLayerCollision(LAYER_CHARACTER, LAYER_STATIC, false);
+		CharacterScene::Build(bw, count);
+
+		motions.resize(count);
+		for (U32 i = 0; i < count; ++i)
+		{
+			CharacterMotion& motion = motions[i];
+			motion.shape = capsule;
+			motion.body = characters[i];
+			motion.stepHeight = 0.3f;
+			motion.maxSlopeCos = cosf(SIMD_PI / 4);
+		}
+	}
+
+	void PreStep(BenchmarkWorld& bw) override
+	{
+		for (size_t i = 0; i < characters.size(); ++i)
+		{
+			motions[i].position = positions[i];
+			motions[i].displacement = velocities[i];
+			motions[i].grounded = grounded[i];
+		}
+
+		CharacterMotionBody body(bw.world, &motions[0], settings);
+		RunBatch(bw, body);
+
+		for (size_t i = 0; i < characters.size(); ++i)
+		{
+			positions[i] = motions[i].position;
+			grounded[i] = motions[i].grounded;
+			if ((motions[i].grounded && velocities[i].getY() < 0) || (motions[i].hitCeiling && velocities[i].getY() > 0))
+			{
+				velocities[i].setY(0);
+			}
+		}
+
+		PushTransforms();
+	}
+};
+
+
+static Scene* CreateScene(const std::string& name)
+{
+	if (name == "boxes") return new BoxesScene;
+	if (name == "contacts") return new ContactsScene;
+	if (name == "pistons") return new PistonsScene;
+	if (name == "triggers") return new TriggersScene;
+	if (name == "projectiles") return new ProjectilesScene;
+	if (name == "overlaps") return new OverlapsScene;
+	if (name == "overlaps_brute") return new OverlapsBruteScene;
+	if (name == "sweeps") return new SweepsScene;
+	if (name == "rays") return new RaysScene;
+	if (name == "rays_single") return new RaysSingleScene;
+	if (name == "characters_legacy") return new CharactersLegacyScene;
+	if (name == "characters_sweep") return new CharactersSweepScene;
+	return nullptr;
+}
+
+
+static std::vector<U32> DefaultCounts(const std::string& name)
+{
+	if (name == "boxes") return { 500, 1000, 2000 };
+	if (name == "contacts") return { 1250 };
+	if (name == "pistons") return { 256, 1024 };
+	if (name == "triggers") return { 1000, 4000 };
+	if (name == "overlaps" || name == "overlaps_brute" || name == "sweeps" || name == "rays" || name == "rays_single") return { 1000, 10000 };
+	if (name == "characters_legacy" || name == "characters_sweep") return { 1, 100, 10000 };
+	return { 100, 400 };
+}
+
+
+static std::vector<U32> ParseList(const char* text)
+{
+	std::vector<U32> values;
+	for (const char* c = text; *c;)
+	{
+		values.push_back((U32)strtoul(c, nullptr, 10));
+		c = strchr(c, ',');
+		if (!c)
+		{
+			break;
+		}
+		c++;
+	}
+	return values;
+}
+
+
+static bool Run(const std::string& name, U32 count, U32 frames, U32 numThreads, Result& result)
+{
+	BenchmarkWorld bw;
+	if (!CreateWorld(bw, numThreads))
+	{
+		return false;
+	}
+
+	Scene* scene = CreateScene(name);
+	scene->Build(bw, count);
+
+	result.stepTimes.reserve(frames);
+	U64 steadyStart = 0;
+	for (U32 frame = 0; frame < frames; ++frame)
+	{
+		if (frame == frames / 2)
+		{
+			steadyStart = GetMemoryStats(MEMORY_PHYSICS).totalAllocations;
+		}
+
+		scene->Update(bw, frame);
+
+		// the engine's step, contact routing to listeners and step stats included
+		auto start = std::chrono::steady_clock::now();
+		scene->PreStep(bw);
+		bw.physics.RunSimulation(TIME_STEP);
+		scene->PostStep(bw);
+		auto end = std::chrono::steady_clock::now();
+
+		const PhysicsStepStats& stats = bw.physics.GetStepStats();
+		result.stepTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+		result.totalPairs += stats.numOverlappingPairs;
+		result.totalManifolds += stats.numManifolds;
+		result.totalContacts += stats.numContacts;
+		result.totalIslands += stats.numIslands;
+		for (int i = 0; i < NUM_PHYSICS_PHASES; ++i)
+		{
+			result.phaseMs[i] += stats.phaseMs[i];
+		}
+
+		start = std::chrono::steady_clock::now();
+		result.totalQueryHits += scene->Query(bw);
+		end = std::chrono::steady_clock::now();
+		result.queryTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+
+	// scenes that spawn bodies allocate every frame, settled ones shouldn't
+	result.steadyAllocations = GetMemoryStats(MEMORY_PHYSICS).totalAllocations - steadyStart;
+	result.steadyFrames = frames - frames / 2;
+	result.numBodies = bw.world->getNumCollisionObjects();
+
+	delete scene;
+	DestroyWorld(bw);
+	return true;
+}
+
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+	size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+
+int main(int argc, char** argv)
+{
+	std::string sceneArg = argc > 1 ? argv[1] : "all";
+	std::vector<U32> counts = argc > 2 ? ParseList(argv[2]) : std::vector<U32>();
+	U32 frames = argc > 3 ? (U32)strtoul(argv[3], nullptr, 10) : 600;
+	std::vector<U32> threads = argc > 4 ? ParseList(argv[4]) : std::vector<U32>{ 1 };
+
+	std::vector<std::string> scenes;
+	if (sceneArg == "all")
+	{
+		scenes = { "boxes", "contacts", "pistons", "triggers", "projectiles", "overlaps", "overlaps_brute", "sweeps", "rays", "rays_single", "characters_legacy", "characters_sweep" };
+	}
+	else if (Scene* scene = CreateScene(sceneArg))
+	{
+		delete scene;
+		scenes = { sceneArg };
+	}
+	else
+	{
+		printf("unknown scene %s, expected boxes, contacts, pistons, triggers, projectiles, overlaps, overlaps_brute, sweeps, rays, rays_single, characters_legacy, characters_sweep or all\n", sceneArg.c_str());
+		return 1;
+	}
+
+	// the phase columns are mean ms per frame inside stepSimulation, from bullet's profile zones
+	// allocs is the mean number of physics allocations per frame over the second half of the run
+	printf("%-17s %7s %7s %8s %8s %8s %8s %8s %8s %8s %8s %8s %10s %10s %10s %8s %7s %8s %8s %8s\n",
+		   "scene", "count", "threads", "mean ms", "p50 ms", "p90 ms", "p99 ms", "max ms", "broad", "narrow", "solver", "integr",
+		   "pairs", "manifolds", "contacts", "islands", "bodies", "query ms", "hits", "allocs");
+
+	for (const std::string& name : scenes)
+	{
+		for (U32 count : counts.empty() ? DefaultCounts(name) : counts)
+		{
+			for (U32 numThreads : threads)
+			{
+				Result result;
+				if (!Run(name, count, frames, numThreads, result))
+				{
+					return 1;
+				}
+
+				std::vector<double> sorted = result.stepTimes;
+				std::sort(sorted.begin(), sorted.end());
+				double total = 0;
+				for (double t : sorted)
+				{
+					total += t;
+				}
+
+				double queryTotal = 0;
+				for (double t : result.queryTimes)
+				{
+					queryTotal += t;
+				}
+
+				printf("%-17s %7u %7u %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %10.1f %10.1f %10.1f %8.1f %7u %8.3f %8.1f %8.2f\n",
+					   name.c_str(), count, numThreads, total / sorted.size(),
+					   Percentile(sorted, 0.5), Percentile(sorted, 0.9), Percentile(sorted, 0.99), sorted.back(),
+					   result.phaseMs[PHYSICS_PHASE_BROADPHASE] / frames, result.phaseMs[PHYSICS_PHASE_NARROWPHASE] / frames,
+					   result.phaseMs[PHYSICS_PHASE_SOLVER] / frames, result.phaseMs[PHYSICS_PHASE_INTEGRATION] / frames,
+					   (double)result.totalPairs / frames, (double)result.totalManifolds / frames, (double)result.totalContacts / frames,
+					   (double)result.totalIslands / frames, result.numBodies, queryTotal / frames, (double)result.totalQueryHits / frames,
+					   (double)result.steadyAllocations / result.steadyFrames);
+			}
+		}
+	}
+
+	return 0;
+}
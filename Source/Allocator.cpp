@@ -0,0 +1,110 @@
+#include "Allocator.h"
+#include "Assert.h"
+#include "btBulletDynamicsCommon.h"
+#include <atomic>
+#include <stdlib.h>
+
+
+// stored just before every block so a free knows its size and category
+struct AllocationHeader
+{
+	void* base;
+	U64 size;
+	U32 category;
+};
+
+struct MemoryCounters
+{
+	std::atomic<U64> bytesInUse;
+	std::atomic<U64> peakBytes;
+	std::atomic<U64> numAllocations;
+	std::atomic<U64> totalAllocations;
+};
+
+static MemoryCounters s_counters[NUM_MEMORY_CATEGORIES];
+
+
+void* AllocateMemory(size_t size, size_t alignment, MemoryCategory category)
+{
+	ASSERT((alignment & (alignment - 1)) == 0);
+	if (alignment < alignof(AllocationHeader))
+	{
+		alignment = alignof(AllocationHeader);
+	}
+
+	// room for the header plus enough slack to align the block after it
+	void* base = malloc(size + sizeof(AllocationHeader) + alignment - 1);
+	if (!base)
+	{
+		return nullptr;
+	}
+
+	size_t address = reinterpret_cast<size_t>(base) + sizeof(AllocationHeader);
+	address = (address + alignment - 1) & ~(alignment - 1);
+
+	AllocationHeader* header = reinterpret_cast<AllocationHeader*>(address) - 1;
+	header->base = base;
+	header->size = size;
+	header->category = category;
+
+	MemoryCounters& counters = s_counters[category];
+	U64 inUse = counters.bytesInUse.fetch_add(size) + size;
+	counters.numAllocations++;
+	counters.totalAllocations++;
+
+	// the peak only ever grows, retry if another thread raised it first
+	U64 peak = counters.peakBytes.load();
+	while (inUse > peak && !counters.peakBytes.compare_exchange_weak(peak, inUse))
+	{
+	}
+
+	return reinterpret_cast<void*>(address);
+}
+
+
+void FreeMemory(void* ptr)
+{
+	if (!ptr)
+	{
+		return;
+	}
+
+	AllocationHeader* header = static_cast<AllocationHeader*>(ptr) - 1;
+
+	MemoryCounters& counters = s_counters[header->category];
+	counters.bytesInUse -= header->size;
+	counters.numAllocations--;
+
+	free(header->base);
+}
+
+
+MemoryStats GetMemoryStats(MemoryCategory category)
+{
+	const MemoryCounters& counters = s_counters[category];
+
+	MemoryStats stats;
+	stats.bytesInUse = counters.bytesInUse.load();
+	stats.peakBytes = counters.peakBytes.load();
+	stats.numAllocations = counters.numAllocations.load();
+	stats.totalAllocations = counters.totalAllocations.load();
+	return stats;
+}
+
+
+static void* PhysicsAlloc(size_t size, int alignment)
+{
+	return AllocateMemory(size, alignment, MEMORY_PHYSICS);
+}
+
+
+static void PhysicsFree(void* ptr)
+{
+	FreeMemory(ptr);
+}
+
+
+void InstallPhysicsAllocator()
+{
+	btAlignedAllocSetCustomAligned(PhysicsAlloc, PhysicsFree);
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Types.h"
+#include <stddef.h>
+
+enum MemoryCategory
+{
+	MEMORY_GENERAL,
+	MEMORY_PHYSICS,
+	NUM_MEMORY_CATEGORIES
+};
+
+struct MemoryStats
+{
+	U64 bytesInUse;
+	U64 peakBytes;
+	U64 numAllocations;	// live allocations
+	U64 totalAllocations;	// every allocation made so far
+};
+
+// Allocates size bytes aligned to alignment, which must be a power of two, and counts them against category
+void* AllocateMemory(size_t size, size_t alignment, MemoryCategory category);
+
+// Frees memory from AllocateMemory, null is ignored
+void FreeMemory(void* ptr);
+
+// Counters for a category, safe to read from any thread
+MemoryStats GetMemoryStats(MemoryCategory category);
+
+// Routes bullet's allocations through AllocateMemory under MEMORY_PHYSICS
+void InstallPhysicsAllocator();
\ No newline at end of file
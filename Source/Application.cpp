@@ -41,6 +41,16 @@ bool Application::StartUp()
 	ShowWindow(m_window.Window(), 1);
 
 	m_resourceManager.StartUp(m_graphics);
+
+	// cooked assets packed by the asset cooker's pack command, it isn't checked in so run it after cooking.
+	// whatever it doesn't hold loads from the loose file, in debug builds so does any file written since it was packed
+	m_resourceManager.MountPackage("Game.pak");
+
+	// released resources stay cached up to these, the rest of the types are small enough to keep
+	m_resourceManager.SetMemoryBudget<Texture>(256 * 1024 * 1024);
+	m_resourceManager.SetMemoryBudget<Model>(128 * 1024 * 1024);
+	m_resourceStatsTime = std::chrono::steady_clock::now();
+
 	m_physics.StartUp(&m_eventBus);
 	m_timer.Start();
 	m_inputManager.StartUp(m_window);
@@ -53,6 +63,7 @@ bool Application::StartUp()
 void Application::ShutDown()
 {
 	m_inputManager.ShutDown();
+	m_resourceManager.ShutDown();
 	m_physics.ShutDown();
 	m_window.ShutDown();
 	m_eventBus.ShutDown();
@@ -78,6 +89,14 @@ void Application::Update()
 {
 	m_timer.Update();
 	m_inputManager.UpdateAll();
+	m_resourceManager.Update();
+
+	auto now = std::chrono::steady_clock::now();
+	if (now - m_resourceStatsTime >= std::chrono::seconds(RESOURCE_STAT_SECONDS))
+	{
+		m_resourceManager.LogStats();
+		m_resourceStatsTime = now;
+	}
 }
 
 
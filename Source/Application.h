@@ -9,6 +9,7 @@
 #include "Timer.h"
 #include "InputManager.h"
 #include "EntityManager.h"
+#include <chrono>
 
 class Application 
 {
@@ -23,6 +24,10 @@ protected:
 	SampleWindow m_window;
 	bool initialized;
 
+	// how often resource memory and eviction rates are logged
+	static const int RESOURCE_STAT_SECONDS = 10;
+	std::chrono::steady_clock::time_point m_resourceStatsTime;
+
 protected:
 	bool ProcessWindowMessages();
 
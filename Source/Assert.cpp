@@ -35,6 +35,6 @@ void PrintAssertMessage(const char* func, const char* file, int line, const char
 
 	buffer[899] = '\0';
 
-	int charsWritten = DEBUG_ERROR(buffer);
+	int charsWritten = DEBUG_ERROR("%s", buffer);
 	va_end(argList);
 }
\ No newline at end of file
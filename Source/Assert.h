@@ -17,7 +17,7 @@ void PrintAssertMessage(const char* func, const char* file, int line, const char
 #define ASSERT_VERBOSE(condition, fmt, ...) \
     do { \
         if (! (condition)) { \
-			PrintAssertMessage( __FUNCTION__, __FILE__, __LINE__, fmt, __VA_ARGS__); \
+			PrintAssertMessage( __FUNCTION__, __FILE__, __LINE__, fmt, ##__VA_ARGS__); \
             assert(condition); \
         } \
     } while (false)
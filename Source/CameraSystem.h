@@ -5,6 +5,7 @@
 #include "SampleWindow.h"
 #include "WriteLog.h"
 #include <DirectXMath.h>
+#include <cmath>
 using namespace DirectX;
 
 struct CameraComponent
@@ -63,6 +64,12 @@ public:
 		return m_pool[idx];
 	}
 
+	// pixels covered by one unit one unit away from the camera, for turning world sizes into screen sizes
+	inline float GetPixelsPerUnit(const CameraComponent* camera) const
+	{
+		return m_window->GetScreenHeight() / (2.0f * tanf(camera->fov * 0.5f));
+	}
+
 private:
 
 	TransformSystem* m_transformSystem;
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "ComponentSystem.h"
+#include "TransformSystem.h"
+#include "VelocitySystem.h"
+#include "RigidBodySystem.h"
+#include "Physics.h"
+#include "MathUtility.h"
+#include "Types.h"
+#include <vector>
+
+struct CharacterControllerComponent
+{
+	U64 hTransform;
+	U64 hVelocity;
+	U64 hRigidBody;
+	float stepHeight;
+	float maxSlopeAngle;
+	bool grounded;
+};
+
+// Moves characters by their velocity with swept collision, replaces integrating the velocity,
+// leg casting for the ground and pushing out of geometry after the physics step
+class CharacterControllerSystem : public ComponentSystem<CharacterControllerComponent>
+{
+public:
+	bool StartUp(U32 numComponents, EntityManager& em, TransformSystem& transformSystem, VelocitySystem& vs,
+				 RigidBodySystem& rigidBodySystem, Physics& physics)
+	{
+		Parent::StartUp(numComponents, em);
+		m_transformSystem = &transformSystem;
+		m_velocitySystem = &vs;
+		m_rigidBodySystem = &rigidBodySystem;
+		m_physics = &physics;
+		return true;
+	}
+
+	U64 CreateComponent(Entity e, U64 hTransform, U64 hVelocity, U64 hRigidBody, float stepHeight = 0.3f, float maxSlopeAngle = 45)
+	{
+		U64 handle = Parent::CreateComponent(e);
+		CharacterControllerComponent* comp = GetComponentByHandle(handle);
+
+		comp->hTransform = hTransform;
+		comp->hVelocity = hVelocity;
+		comp->hRigidBody = hRigidBody;
+		comp->stepHeight = stepHeight;
+		comp->maxSlopeAngle = maxSlopeAngle;
+		comp->grounded = false;
+
+		return handle;
+	}
+
+	inline void Execute(float deltaTime) override
+	{
+		// every character is moved in one batch, the buffer is reused between frames
+		m_moves.resize(m_pool.Size());
+
+		for (U32 i = 0; i < m_pool.Size(); i++)
+		{
+			CharacterControllerComponent* comp = m_pool[i];
+			TransformComponent* transform = m_transformSystem->GetComponentByHandle(comp->hTransform);
+			VelocityComponent* velocity = m_velocitySystem->GetComponentByHandle(comp->hVelocity);
+			RigidBodyComponent* rigidBody = m_rigidBodySystem->GetComponentByHandle(comp->hRigidBody);
+
+			// velocities are in units per second so the move doesn't depend on the frame rate
+			CharacterMove& move = m_moves[i];
+			move.body = rigidBody->body;
+			move.position = transform->position;
+			move.displacement = velocity->velocity * deltaTime;
+			move.stepHeight = comp->stepHeight;
+			move.maxSlopeAngle = DegreesToRadians(comp->maxSlopeAngle);
+			move.grounded = comp->grounded;
+		}
+
+		m_physics->MoveCharacters(m_moves.data(), m_pool.Size());
+
+		for (U32 i = 0; i < m_pool.Size(); i++)
+		{
+			CharacterControllerComponent* comp = m_pool[i];
+			TransformComponent* transform = m_transformSystem->GetComponentByHandle(comp->hTransform);
+			VelocityComponent* velocity = m_velocitySystem->GetComponentByHandle(comp->hVelocity);
+			const CharacterMove& move = m_moves[i];
+
+			transform->position = move.position;
+			comp->grounded = move.grounded;
+
+			// standing on the ground or hitting the ceiling stops vertical motion
+			float verticalSpeed = XMVectorGetY(velocity->velocity);
+			if ((move.grounded && verticalSpeed < 0) || (move.hitCeiling && verticalSpeed > 0))
+			{
+				velocity->velocity = XMVectorSetY(velocity->velocity, 0);
+			}
+		}
+	}
+
+	inline bool IsGrounded(U64 handle)
+	{
+		return GetComponentByHandle(handle)->grounded;
+	}
+
+protected:
+	TransformSystem* m_transformSystem;
+	VelocitySystem* m_velocitySystem;
+	RigidBodySystem* m_rigidBodySystem;
+	Physics* m_physics;
+	std::vector<CharacterMove> m_moves;
+};
\ No newline at end of file
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "PhysicsQueries.h"
+#include <LinearMath/btThreads.h>
+
+// Sweep based character movement on bullet types, shared by Physics::MoveCharacters and the benchmark.
+// Each character only reads the world, so a batch runs one character per task.
+
+
+// iteration bounds and tolerances shared by every character in a batch
+struct CharacterMotionSettings
+{
+	float skinWidth = 0.02f;			// gap kept between the shape and what it hits
+	float maxSubstepDistance = 0.4f;	// longer moves are split so each sweep stays short
+	U32 maxSubsteps = 4;
+	U32 maxSlideIterations = 4;			// sweeps along walls per substep
+	int layerMask = ALL_LAYERS;
+};
+
+
+struct CharacterMotion
+{
+	const btConvexShape* shape;
+	const btCollisionObject* body;	// the character's own body, skipped by its sweeps
+	btVector3 position;				// in: current position, out: where the character ended up
+	btVector3 displacement;			// requested move for this frame
+	btVector3 groundNormal;			// out: normal of the ground stood on
+	float stepHeight;
+	float maxSlopeCos;				// cosine of the steepest walkable slope
+	bool grounded;					// in: grounded last frame, out: standing on walkable ground
+	bool hitCeiling;				// out: an upward move was blocked
+};
+
+
+// closest hit that blocks the sweep, hits the shape is already moving away from are ignored
+// so a character that starts slightly inside something can still move out of it
+struct CharacterSweepCallback : public ClosestSweepFilterCallback
+{
+	CharacterSweepCallback(const btVector3& start, const btVector3& end, int layerMask, const btCollisionObject* ignore)
+		: ClosestSweepFilterCallback(start, end, layerMask, false, ignore), m_direction{ end - start } {}
+
+	btScalar addSingleResult(btCollisionWorld::LocalConvexResult& convexResult, bool normalInWorldSpace) override
+	{
+		btVector3 normal = normalInWorldSpace ? convexResult.m_hitNormalLocal :
+			convexResult.m_hitCollisionObject->getWorldTransform().getBasis() * convexResult.m_hitNormalLocal;
+		if (normal.dot(m_direction) >= btScalar(0))
+		{
+			return btScalar(1);
+		}
+
+		return ClosestSweepFilterCallback::addSingleResult(convexResult, normalInWorldSpace);
+	}
+
+	btVector3 m_direction;
+};
+
+
+// sweeps the shape along move and returns the distance travelled before a blocking hit, less the skin width
+inline btScalar SweepCharacter(const btCollisionWorld* world, const CharacterMotion& motion, const btVector3& from, const btVector3& move,
+							   const CharacterMotionSettings& settings, btVector3& hitNormal, bool& hit)
+{
+	btScalar length = move.length();
+	hit = false;
+	if (length < SIMD_EPSILON)
+	{
+		return btScalar(0);
+	}
+
+	btTransform start(btQuaternion::getIdentity(), from);
+	btTransform end(btQuaternion::getIdentity(), from + move);
+	CharacterSweepCallback callback(from, from + move, settings.layerMask, motion.body);
+	world->convexSweepTest(motion.shape, start, end, callback);
+
+	if (!callback.hasHit())
+	{
+		return length;
+	}
+
+	hit = true;
+	hitNormal = callback.m_hitNormalWorld.safeNormalize();
+	return btMax(callback.m_closestHitFraction * length - settings.skinWidth, btScalar(0));
+}
+
+
+// moves one character by its displacement: step up, slide along walls, then step back down onto the ground
+inline void MoveCharacter(const btCollisionWorld* world, CharacterMotion& motion, const CharacterMotionSettings& settings)
+{
+	const btVector3 up(0, 1, 0);
+
+	U32 numSubsteps = 1;
+	btScalar length = motion.displacement.length();
+	if (length > settings.maxSubstepDistance)
+	{
+		numSubsteps = btMin((U32)ceilf(length / settings.maxSubstepDistance), settings.maxSubsteps);
+	}
+
+	btVector3 substep = motion.displacement / btScalar(numSubsteps);
+	btVector3 position = motion.position;
+	bool grounded = motion.grounded;
+	motion.groundNormal = up;
+	motion.hitCeiling = false;
+
+	for (U32 s = 0; s < numSubsteps; ++s)
+	{
+		btScalar vertical = substep.dot(up);
+		btVector3 move = substep - up * vertical;
+		btVector3 normal;
+		bool hit;
+
+		// lift over steps only while walking on the ground, and only when the way ahead is blocked
+		// since most moves are clear and the climb costs a sweep of its own
+		btScalar climb = 0;
+		if (grounded && move.length2() > SIMD_EPSILON && motion.stepHeight > 0)
+		{
+			SweepCharacter(world, motion, position, move, settings, normal, hit);
+			if (!hit)
+			{
+				position += move;
+				move.setZero();
+			}
+			else
+			{
+				climb = SweepCharacter(world, motion, position, up * motion.stepHeight, settings, normal, hit);
+				position += up * climb;
+			}
+		}
+
+		// slide along whatever blocks the move, a bounded number of times
+		for (U32 i = 0; i < settings.maxSlideIterations && move.length2() > SIMD_EPSILON; ++i)
+		{
+			btScalar distance = SweepCharacter(world, motion, position, move, settings, normal, hit);
+			btVector3 direction = move.normalized();
+			position += direction * distance;
+			if (!hit)
+			{
+				break;
+			}
+
+			// slopes too steep to walk are walls, so only their horizontal part pushes back
+			if (normal.dot(up) < motion.maxSlopeCos)
+			{
+				normal -= up * normal.dot(up);
+				if (normal.length2() < SIMD_EPSILON)
+				{
+					break;
+				}
+				normal.normalize();
+			}
+
+			// walkable slopes keep the upward part of the slide, so ramps are climbed rather than stepped
+			move -= direction * distance;
+			move -= normal * move.dot(normal);
+		}
+
+		// undo the climb and apply the vertical move, grounded characters also snap down a step to follow slopes and stairs
+		btScalar drop = climb - vertical;
+		if (drop < 0)
+		{
+			btScalar rise = SweepCharacter(world, motion, position, up * -drop, settings, normal, hit);
+			position += up * rise;
+			motion.hitCeiling |= hit;
+			grounded = false;
+			continue;
+		}
+
+		btScalar snap = grounded ? motion.stepHeight : btScalar(0);
+		btScalar fall = SweepCharacter(world, motion, position, up * -(drop + snap), settings, normal, hit);
+		if (hit && normal.dot(up) >= motion.maxSlopeCos)
+		{
+			position -= up * fall;
+			motion.groundNormal = normal;
+			grounded = true;
+		}
+		else
+		{
+			// nothing walkable within reach, fall only by the requested amount
+			position -= up * btMin(fall, drop);
+			grounded = false;
+
+			// landing on a steep slope turns the rest of the fall into a slide down it
+			if (hit && fall < drop)
+			{
+				btVector3 slide = up * (fall - drop);
+				slide -= normal * slide.dot(normal);
+				position += slide.normalized() * SweepCharacter(world, motion, position, slide, settings, normal, hit);
+			}
+		}
+	}
+
+	motion.position = position;
+	motion.grounded = grounded;
+}
+
+
+// runs a range of characters from a batch, each one writes only its own motion
+struct CharacterMotionBody : public btIParallelForBody
+{
+	CharacterMotionBody(const btCollisionWorld* world, CharacterMotion* motions, const CharacterMotionSettings& settings)
+		: m_world{ world }, m_motions{ motions }, m_settings{ settings } {}
+
+	void forLoop(int begin, int end) const override
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			MoveCharacter(m_world, m_motions[i], m_settings);
+		}
+	}
+
+	const btCollisionWorld* m_world;
+	CharacterMotion* m_motions;
+	const CharacterMotionSettings& m_settings;
+};
\ No newline at end of file
@@ -15,11 +15,11 @@ class CheckpointTriggerSystem : public ComponentSystem<CheckpointTriggerComponen
 {
 public:
 
-	bool StartUp(U32 numComponents, EntityManager& em, EventBus& bus, SpawnSystem& spawn)
+	bool StartUp(U32 numComponents, EntityManager& em, Physics& physics, SpawnSystem& spawn)
 	{
 		Parent::StartUp(numComponents, em);
 
-		SubscribeToCollisionEvents(bus);
+		SubscribeToCollisionEvents(physics);
 		m_spawnSystem = &spawn;
 
 		return true;
@@ -44,6 +44,11 @@ public:
 
 	void OnCollision(CollisionInfo* collision) override
 	{
+		if (collision->type != CONTACT_BEGIN)
+		{
+			return;
+		}
+
 		CheckpointTriggerComponent* comp = FindComponent(collision->self.GetEntity());
 		if (comp)
 		{
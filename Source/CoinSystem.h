@@ -17,11 +17,11 @@ class CoinSystem : public ComponentSystem<CoinComponent>
 {
 public:
 
-	bool StartUp(U32 numComponents, EntityManager& em, EventBus& eventBus)
+	bool StartUp(U32 numComponents, EntityManager& em, Physics& physics)
 	{
 		Parent::StartUp(numComponents, em);
 
-		SubscribeToCollisionEvents(eventBus);
+		SubscribeToCollisionEvents(physics);
 
 		return true;
 	}
@@ -53,6 +53,11 @@ public:
 private:
 	void OnCollision(CollisionInfo* collision) override
 	{
+		if (collision->type != CONTACT_BEGIN)
+		{
+			return;
+		}
+
 		CoinComponent* coin = FindComponent(collision->self.GetEntity());
 		if (!coin->collected)
 		{
@@ -1,7 +0,0 @@
-#include "ColliderPtr.h"
-#include "Physics.h"
-
-void ColliderPtr::SetScale(DirectX::XMVECTOR scale)
-{
-	m_collider->setLocalScaling(Physics::VecFromDX(scale));
-}
\ No newline at end of file
@@ -4,14 +4,17 @@
 #include <DirectXMath.h>
 
 class Physics;
+struct SweepBody;
 
+// Shape shared through the Physics shape cache, it stays alive while any body uses it.
+// Not a reference itself, so it dangles once the last body using its shape is destroyed
 class ColliderPtr
 {
 public:
 	friend class Physics;
+	friend struct SweepBody;
 	ColliderPtr() {};
 	ColliderPtr(btCollisionShape* collider) : m_collider(collider) {};
-	void SetScale(DirectX::XMVECTOR scale);
 protected:
 	btCollisionShape* m_collider;
 };
\ No newline at end of file
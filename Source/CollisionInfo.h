@@ -1,16 +1,24 @@
 #pragma once
 
 #include <btBulletDynamicsCommon.h>
-#include <vector>
 #include "RigidBody.h"
 
+enum ContactType
+{
+	CONTACT_BEGIN,	// first frame the bodies touch
+	CONTACT_STAY,	// every following frame, only sent to listeners that ask for it
+	CONTACT_END		// first frame the bodies no longer touch, carries no contact points
+};
+
+// Contact points are a view into the persistent manifold and are only valid during the collision callback
 class CollisionInfo
 {
 public:
-	CollisionInfo(RigidBody a, RigidBody b, I32 dir, U32 numPoints, std::vector<btManifoldPoint> points) : self{ a }, other{ b }, direction{ dir }, numContactPoints{ numPoints }, contactPoints{ points } {}
+	CollisionInfo(RigidBody a, RigidBody b, I32 dir, ContactType t, U32 numPoints, const btManifoldPoint* points) : self{ a }, other{ b }, direction{ dir }, type{ t }, numContactPoints{ numPoints }, contactPoints{ points } {}
 	RigidBody self;
 	RigidBody other;
 	I32 direction;
+	ContactType type;
 	U32 numContactPoints;
-	std::vector<btManifoldPoint> contactPoints;
+	const btManifoldPoint* contactPoints;
 };
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+// Every body belongs to one layer, which layers can touch is set in Physics
+enum CollisionLayer
+{
+	LAYER_STATIC,		// level geometry that never moves
+	LAYER_KINEMATIC,	// geometry moved by game code, like doors
+	LAYER_DYNAMIC,		// simulated props
+	LAYER_CHARACTER,	// player controlled bodies
+	LAYER_PROJECTILE,	// fired bodies
+	LAYER_TRIGGER,		// volumes that only report overlaps
+	NUM_COLLISION_LAYERS
+};
+
+// layer masks select which layers a body collides with or a query can hit
+static const int ALL_LAYERS = -1;
+
+inline int LayerMask(CollisionLayer layer)
+{
+	return 1 << layer;
+}
\ No newline at end of file
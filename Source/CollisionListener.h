@@ -0,0 +1,10 @@
+#pragma once
+
+#include "CollisionInfo.h"
+
+// Receives the collisions that Physics routes to it for the entities it registered
+class CollisionListener
+{
+public:
+	virtual void OnCollision(CollisionInfo* collision) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,14 @@
+#include "ComponentSystem.h"
+#include "Physics.h"
+
+
+void ComponentSystemBase::AddCollisionRoute(Physics& physics, Entity e, CollisionListener* listener, bool receiveStay)
+{
+	physics.AddCollisionListener(e, listener, receiveStay);
+}
+
+
+void ComponentSystemBase::RemoveCollisionRoute(Physics& physics, Entity e, CollisionListener* listener)
+{
+	physics.RemoveCollisionListener(e, listener);
+}
\ No newline at end of file
@@ -4,21 +4,26 @@
 #include "CompactPool.h"
 #include "Types.h"
 #include "Entity.h"
-#include "EventBus.h"
 #include "CollisionInfo.h"
+#include "CollisionListener.h"
 #include "EntityManager.h"
-#include "EngineEvents.h"
 
 class EntityManager;
+class Physics;
 
 class ComponentSystemBase
 {
 public:
 	virtual void DestroyComponent(Entity e) = 0;
+
+protected:
+	// out of line so systems don't have to include physics
+	static void AddCollisionRoute(Physics& physics, Entity e, CollisionListener* listener, bool receiveStay);
+	static void RemoveCollisionRoute(Physics& physics, Entity e, CollisionListener* listener);
 };
 
 template <class T>
-class ComponentSystem : public ComponentSystemBase
+class ComponentSystem : public ComponentSystemBase, public CollisionListener
 {
 public:
 	// execute system
@@ -41,6 +46,12 @@ public:
 
 		m_entityManager->AddComponentToEntity(e, this, handle);
 
+		// route collisions of this entity to the system
+		if (m_collisionPhysics)
+		{
+			AddCollisionRoute(*m_collisionPhysics, e, this, m_receiveContactStay);
+		}
+
 		return handle;
 	}
 
@@ -94,6 +105,11 @@ public:
 
 			// remove entity from map
 			m_entityMap.erase(itr);
+
+			if (m_collisionPhysics)
+			{
+				RemoveCollisionRoute(*m_collisionPhysics, e, this);
+			}
 		}
 	}
 
@@ -111,35 +127,15 @@ public:
 protected:
 	typedef ComponentSystem<T> Parent;
 
-	virtual void SubscribeToCollisionEvents(EventBus& bus)
+	// only collisions involving entities that own a component of this system are delivered
+	// contact stay is sent every frame the bodies touch, so only systems that need it should ask
+	virtual void SubscribeToCollisionEvents(Physics& physics, bool receiveStay = false)
 	{
-		bus.Subscribe(this, &ComponentSystem<T>::OnCollisionEvent);
-	}
-
-	virtual void OnCollisionEvent(CollisionEvent* collision)
-	{
-		// test
-		Entity a = collision->rigidBodyA.GetEntity();
-		Entity b = collision->rigidBodyB.GetEntity();
-
-		// check first rigidbody
-		T* component = FindComponent(collision->rigidBodyA.GetEntity());
-		if (component)
-		{
-			CollisionInfo info(collision->rigidBodyA, collision->rigidBodyB, -1, collision->numContactPoints, collision->contactPoints);
-			OnCollision(&info);
-		}
-
-		// check second rigidbody
-		component = FindComponent(collision->rigidBodyB.GetEntity());
-		if (component)
-		{
-			CollisionInfo info(collision->rigidBodyB, collision->rigidBodyA, 1, collision->numContactPoints, collision->contactPoints);
-			OnCollision(&info);
-		}
+		m_collisionPhysics = &physics;
+		m_receiveContactStay = receiveStay;
 	}
 
-	virtual void OnCollision(CollisionInfo* collision)
+	virtual void OnCollision(CollisionInfo* collision) override
 	{
 	}
 
@@ -147,4 +143,6 @@ protected:
 	CompactPool<T> m_pool;
 	std::unordered_map<U64, U64> m_entityMap;
 	EntityManager* m_entityManager = nullptr;
+	Physics* m_collisionPhysics = nullptr;
+	bool m_receiveContactStay = false;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "ComponentSystem.h"
 #include "Types.h"
 #include "AppEvents.h"
+#include "EventBus.h"
 
 struct DeadlyTouchComponent
 {
@@ -12,11 +13,11 @@ struct DeadlyTouchComponent
 class DeadlyTouchSystem : public ComponentSystem<DeadlyTouchComponent>
 {
 public:
-	bool StartUp(U32 numComponents, EntityManager& em, EventBus& eventBus)
+	bool StartUp(U32 numComponents, EntityManager& em, EventBus& eventBus, Physics& physics)
 	{
 		Parent::StartUp(numComponents, em);
 
-		SubscribeToCollisionEvents(eventBus);
+		SubscribeToCollisionEvents(physics);
 		m_eventBus = &eventBus;
 
 		return true;
@@ -29,12 +30,13 @@ public:
 protected:
 	void OnCollision(CollisionInfo* collision) override
 	{
-		Entity victim = collision->other.GetEntity();
-
-		if (collision->contactPoints.size() > 0)
+		if (collision->type != CONTACT_BEGIN)
 		{
-			m_eventBus->Publish(&OnDeathEvent(victim));
+			return;
 		}
+
+		Entity victim = collision->other.GetEntity();
+		m_eventBus->Publish(&OnDeathEvent(victim));
 	}
 
 protected:
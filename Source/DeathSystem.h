@@ -6,7 +6,7 @@
 #include "Types.h"
 #include "EventBus.h"
 #include "AppEvents.h"
-#include <unordered_set>
+#include <vector>
 
 
 struct DeathComponent
@@ -14,6 +14,7 @@ struct DeathComponent
 	U64 hTransform;
 	U64 hVelocity;
 	U32 deathCount;
+	bool condemned;
 };
 
 
@@ -40,6 +41,7 @@ public:
 		comp->hTransform = hTransform;
 		comp->hVelocity = hVelocity;
 		comp->deathCount = 0;
+		comp->condemned = false;
 
 		return handle;
 	}
@@ -51,8 +53,14 @@ public:
 	inline void EndFrame()
 	{
 		// respawn entities at end of the frame
-		for (auto comp : m_condemned)
+		for (U64 handle : m_condemned)
 		{
+			DeathComponent* comp = GetComponentByHandle(handle);
+			if (!comp)
+			{
+				continue;
+			}
+
 			TransformComponent* transform = m_transformSystem->GetComponentByHandle(comp->hTransform);
 			VelocityComponent* velocity = m_velocitySystem->GetComponentByHandle(comp->hVelocity);
 			const SpawnComponent* spawn = m_spawnSystem->GetActiveSpawn();
@@ -62,6 +70,7 @@ public:
 			velocity->velocity = Vector3(0);
 
 			comp->deathCount++;
+			comp->condemned = false;
 		}
 		m_condemned.clear();
 	}
@@ -69,16 +78,24 @@ public:
 protected:
 	void OnDeath(OnDeathEvent* deathInfo)
 	{
-		DeathComponent* comp = FindComponent(deathInfo->deceased);
-		if (comp);
+		// deaths arrive once per contact begin, the flag only guards several killers touching in the same frame
+		auto itr = m_entityMap.find(deathInfo->deceased.id);
+		if (itr == m_entityMap.end())
 		{
-			m_condemned.insert(comp);
-		}		
+			return;
+		}
+
+		DeathComponent* comp = GetComponentByHandle(itr->second);
+		if (!comp->condemned)
+		{
+			comp->condemned = true;
+			m_condemned.push_back(itr->second);
+		}
 	}
 
 protected:
 	TransformSystem* m_transformSystem;
 	VelocitySystem* m_velocitySystem;
 	SpawnSystem* m_spawnSystem;
-	std::unordered_set<DeathComponent*> m_condemned;
+	std::vector<U64> m_condemned;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "ComponentSystem.h"
 #include "WriteLog.h"
 #include "AppEvents.h"
+#include "EventBus.h"
 #include <DirectXMath.h>
 using namespace DirectX;
 
@@ -17,11 +18,11 @@ class DoorTriggerSystem : public ComponentSystem<DoorTriggerComponent>
 {
 public:
 
-	bool StartUp(U32 numComponents, EntityManager& em, EventBus& bus)
+	bool StartUp(U32 numComponents, EntityManager& em, EventBus& bus, Physics& physics)
 	{
 		Parent::StartUp(numComponents, em);
 
-		SubscribeToCollisionEvents(bus);
+		SubscribeToCollisionEvents(physics);
 		m_eventBus = &bus;
 
 		return true;
@@ -51,6 +52,11 @@ public:
 
 	void OnCollision(CollisionInfo* collision) override
 	{
+		if (collision->type != CONTACT_BEGIN)
+		{
+			return;
+		}
+
 		DoorTriggerComponent* comp = FindComponent(collision->self.GetEntity());
 
 		m_eventBus->Publish(&OpenDoorEvent(comp->door));
@@ -14,7 +14,8 @@ struct DynamicRigidBodyComponent
 };
 
 
-class DynamicRigidBodySystem : public ComponentSystem<DynamicRigidBodyComponent>
+// Copies simulated transforms into the entity's transform, bullet only reports bodies that are awake
+class DynamicRigidBodySystem : public ComponentSystem<DynamicRigidBodyComponent>, public MotionStateListener
 {
 public:
 
@@ -36,20 +37,24 @@ public:
 		comp->transform = hTransform;
 		comp->rigidBody = hRigidBody;
 
+		RigidBodyComponent* rb = m_rigidBodySystem->GetComponentByHandle(hRigidBody);
+		rb->body.SetMotionStateListener(this, hTransform);
+
 		return handle;
 	}
 
 	inline void Execute(float deltaTime) override
 	{
-		for (U32 i = 0; i < m_pool.Size(); i++)
-		{
-			DynamicRigidBodyComponent* drb = m_pool[i];
-			RigidBodyComponent* rb = m_rigidBodySystem->GetComponentByHandle(drb->rigidBody);
-
-			TransformComponent* transform = m_transformSystem->GetComponentByHandle(drb->transform);
+	}
 
-			transform->position = rb->body.GetPosition();
-			transform->rotation = rb->body.GetRotation();
+	void OnBodyMoved(U64 hTransform, const btTransform& t) override
+	{
+		// the transform may already be gone if its entity is being destroyed this frame
+		TransformComponent* transform = m_transformSystem->GetComponentByHandle(hTransform);
+		if (transform)
+		{
+			transform->position = Physics::VecToDX(t.getOrigin());
+			transform->rotation = Physics::QuatToDX(t.getRotation());
 		}
 	}
 
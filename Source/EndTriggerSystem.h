@@ -17,11 +17,11 @@ class EndTriggerSystem : public ComponentSystem<EndTriggerComponent>
 {
 public:
 
-	bool StartUp(U32 numComponents, EntityManager& em, EventBus& bus, Timer& timer, DeathSystem& death, CoinSystem& coin)
+	bool StartUp(U32 numComponents, EntityManager& em, Physics& physics, Timer& timer, DeathSystem& death, CoinSystem& coin)
 	{
 		Parent::StartUp(numComponents, em);
 
-		SubscribeToCollisionEvents(bus);
+		SubscribeToCollisionEvents(physics);
 		m_timer = &timer;
 		m_deathSystem = &death;
 		m_coinSystem = &coin;
@@ -48,6 +48,11 @@ public:
 
 	void OnCollision(CollisionInfo* collision) override
 	{
+		if (collision->type != CONTACT_BEGIN)
+		{
+			return;
+		}
+
 		EndTriggerComponent* comp = FindComponent(collision->self.GetEntity());
 		DeathComponent* death = m_deathSystem->FindComponent(comp->player);
 
@@ -5,8 +5,9 @@
 const unsigned int entityIndexBits = 32;
 const unsigned int entityGenerationBits = 32;
 
-const unsigned int entityIndexMask = (1 << entityIndexBits) - 1;
-const unsigned int entityGenerationMask = (1 << entityGenerationBits) - 1;
+// shifted as 64 bit, a 32 bit shift by the full width is undefined
+const unsigned int entityIndexMask = (unsigned int)((1ull << entityIndexBits) - 1);
+const unsigned int entityGenerationMask = (unsigned int)((1ull << entityGenerationBits) - 1);
 
 struct Entity
 {
@@ -232,7 +232,7 @@ ID3DBlob* Graphics::CreateShaderFromFile(const wchar_t* fileName, const char* en
 		// handle error
 		if (errorBlob != nullptr)
 		{
-			DEBUG_ERROR((char*)errorBlob->GetBufferPointer());
+			DEBUG_ERROR("%s", (char*)errorBlob->GetBufferPointer());
 			errorBlob->Release();
 		}
 		else
@@ -247,6 +247,44 @@ ID3DBlob* Graphics::CreateShaderFromFile(const wchar_t* fileName, const char* en
 }
 
 
+ID3DBlob* Graphics::CreateShaderFromMemory(const void* source, size_t size, const char* name, const char* entryPoint,
+	const char* target, ID3DInclude* include)
+{
+	ID3DBlob* codeBlob = nullptr;
+	ID3DBlob* errorBlob = nullptr;
+	HRESULT hr = D3DCompile(
+		source,
+		size,
+		name,
+		NULL,
+		include,
+		entryPoint,
+		target,
+		D3DCOMPILE_OPTIMIZATION_LEVEL3,
+		0,
+		&codeBlob,
+		&errorBlob
+	);
+
+	if (hr != S_OK)
+	{
+		if (errorBlob != nullptr)
+		{
+			DEBUG_ERROR("%s", (char*)errorBlob->GetBufferPointer());
+			errorBlob->Release();
+		}
+		else
+		{
+			DEBUG_ERROR("Failed to create shader %s\n", name);
+		}
+
+		return nullptr;
+	}
+
+	return codeBlob;
+}
+
+
 ID3D11VertexShader* Graphics::CreateVertexShader(ID3DBlob* vsCode)
 {
 	ID3D11VertexShader* vertexShader = nullptr;
@@ -497,19 +535,61 @@ ID3D11Buffer* Graphics::CreateConstantBuffer(unsigned int size, bool dynamic, co
 ID3D11Resource* Graphics::CreateTextureFromTGAFile(const wchar_t* fileName)
 {
 	DirectX::ScratchImage img;
+	if (!LoadImageFromTGAFile(fileName, img))
+	{
+		return nullptr;
+	}
 
-	// Load file
+	return CreateTextureFromImage(img);
+}
+
+
+bool Graphics::LoadImageFromTGAFile(const wchar_t* fileName, DirectX::ScratchImage& img)
+{
 	HRESULT hr = DirectX::LoadFromTGAFile(fileName, NULL, img);
 	if (hr != S_OK)
 	{
 		DEBUG_ERROR("Failed to load TGA file\n");
-		return nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+
+bool Graphics::LoadImageFromTGAMemory(const void* data, size_t size, DirectX::ScratchImage& img)
+{
+	HRESULT hr = DirectX::LoadFromTGAMemory(data, size, NULL, img);
+	if (hr != S_OK)
+	{
+		DEBUG_ERROR("Failed to load TGA file\n");
+		return false;
 	}
 
+	return true;
+}
+
+
+ID3D11Resource* Graphics::CreateTextureFromImage(const DirectX::ScratchImage& img)
+{
 	ID3D11Resource* texture = nullptr;
 
 	// Create texture
-	hr = DirectX::CreateTexture(m_device, img.GetImages(), img.GetImageCount(), img.GetMetadata(), &texture);
+	HRESULT hr = DirectX::CreateTexture(m_device, img.GetImages(), img.GetImageCount(), img.GetMetadata(), &texture);
+	if (hr != S_OK)
+	{
+		DEBUG_ERROR("Failed to create texture\n");
+		return nullptr;
+	}
+
+	return texture;
+}
+
+
+ID3D11Texture2D* Graphics::CreateTexture2D(const D3D11_TEXTURE2D_DESC& desc, const D3D11_SUBRESOURCE_DATA* data)
+{
+	ID3D11Texture2D* texture = nullptr;
+	HRESULT hr = m_device->CreateTexture2D(&desc, data, &texture);
 	if (hr != S_OK)
 	{
 		DEBUG_ERROR("Failed to create texture\n");
@@ -24,6 +24,10 @@ public:
 	ID3D11RenderTargetView* CreateRTViewFromSwapChain(IDXGISwapChain* swapChain);
 	void ClearRenderTarget(ID3D11RenderTargetView* rtv, float rgba[4]);
 	ID3DBlob* CreateShaderFromFile(const wchar_t* fileName, const char* entryPoint, const char* target);
+
+	// source already in memory such as a packaged file, name is only used in errors and include resolves #includes
+	ID3DBlob* CreateShaderFromMemory(const void* source, size_t size, const char* name, const char* entryPoint,
+		const char* target, ID3DInclude* include);
 	ID3D11VertexShader* CreateVertexShader(ID3DBlob* vsCode);
 	ID3D11PixelShader* CreatePixelShader(ID3DBlob* psCode);
 	ID3D11InputLayout* CreateInputLayout(ID3DBlob* vsCode, const VertexFormat& vbFmt);
@@ -42,6 +46,12 @@ public:
 	ID3D11Buffer* CreateIndexBuffer(unsigned int numIndices, bool dynamic, bool gpuwrite, const unsigned int* data);
 	ID3D11Buffer* CreateConstantBuffer(unsigned int size, bool dynamic, const void* data);
 	ID3D11Resource* CreateTextureFromTGAFile(const wchar_t* fileName);
+
+	// decoding doesn't touch the device so it may run on any thread, creating the texture from it may not
+	bool LoadImageFromTGAFile(const wchar_t* fileName, DirectX::ScratchImage& img);
+	bool LoadImageFromTGAMemory(const void* data, size_t size, DirectX::ScratchImage& img);
+	ID3D11Resource* CreateTextureFromImage(const DirectX::ScratchImage& img);
+	ID3D11Texture2D* CreateTexture2D(const D3D11_TEXTURE2D_DESC& desc, const D3D11_SUBRESOURCE_DATA* data);
 	ID3D11ShaderResourceView* CreateShaderResource(ID3D11Resource* res);
 	ID3D11SamplerState* CreateSampler(const D3D11_SAMPLER_DESC& samplerInfo);
 	void SetIndexBuffer(ID3D11Buffer* ib, unsigned int offset = 0);
@@ -2,7 +2,7 @@
 
 #include "ComponentSystem.h"
 #include "VelocitySystem.h"
-#include "LegCastSystem.h"
+#include "CharacterControllerSystem.h"
 #include "MathUtility.h"
 #include "VelocitySystem.h"
 #include "InputManager.h"
@@ -10,7 +10,7 @@
 struct JumpComponent
 {
 	U64 hVelocity;
-	U64 hLegCast;
+	U64 hController;
 	float impulse;
 	bool heldPrevFrame;
 };
@@ -18,22 +18,22 @@ struct JumpComponent
 class JumpSystem : public ComponentSystem<JumpComponent>
 {
 public:
-	bool StartUp(U32 numComponents, EntityManager& em, VelocitySystem& vs, LegCastSystem& lcs, InputManager& input)
+	bool StartUp(U32 numComponents, EntityManager& em, VelocitySystem& vs, CharacterControllerSystem& ccs, InputManager& input)
 	{
 		Parent::StartUp(numComponents, em);
 		m_velocitySystem = &vs;
-		m_legCastSystem = &lcs;
+		m_characterControllerSystem = &ccs;
 		m_inputManager = &input;
 		return true;
 	}
 
-	U64 CreateComponent(Entity e, U64 hVelocity, U64 hLegCast, float impulse)
+	U64 CreateComponent(Entity e, U64 hVelocity, U64 hController, float impulse)
 	{
 		U64 handle = Parent::CreateComponent(e);
 		JumpComponent* comp = GetComponentByHandle(handle);
 
 		comp->hVelocity = hVelocity;
-		comp->hLegCast = hLegCast;
+		comp->hController = hController;
 		comp->impulse = impulse;
 		comp->heldPrevFrame = false;
 
@@ -46,11 +46,10 @@ public:
 		{
 			JumpComponent* comp = m_pool[i];
 			VelocityComponent* velocity = m_velocitySystem->GetComponentByHandle(comp->hVelocity);
-			LegCastComponent* legCast = m_legCastSystem->GetComponentByHandle(comp->hLegCast);
 
 			bool buttonHeld = m_inputManager->GetGamepad().GetButtonState(GamepadButtons::A_BUTTON);
 
-			if (buttonHeld && legCast->grounded && !comp->heldPrevFrame)
+			if (buttonHeld && m_characterControllerSystem->IsGrounded(comp->hController) && !comp->heldPrevFrame)
 			{
 				velocity->velocity += Vector3(0, comp->impulse, 0);
 			}
@@ -61,6 +60,6 @@ public:
 
 protected:
 	VelocitySystem* m_velocitySystem;
-	LegCastSystem* m_legCastSystem;
+	CharacterControllerSystem* m_characterControllerSystem;
 	InputManager* m_inputManager;
 };
\ No newline at end of file
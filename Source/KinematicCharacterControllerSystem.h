@@ -17,12 +17,13 @@ class KinematicCharacterControllerSystem : public ComponentSystem<KinematicChara
 {
 public:
 
-	bool StartUp(U32 numComponents, EntityManager& em, TransformSystem& transformSystem, EventBus& eventBus)
+	bool StartUp(U32 numComponents, EntityManager& em, TransformSystem& transformSystem, Physics& physics)
 	{
 		Parent::StartUp(numComponents, em);
 
 		m_transformSystem = &transformSystem;
-		SubscribeToCollisionEvents(eventBus);
+		// the controller is pushed out of static geometry every frame it overlaps
+		SubscribeToCollisionEvents(physics, true);
 
 		return true;
 	}
@@ -44,7 +45,7 @@ public:
 private:
 	void OnCollision(CollisionInfo* collision) override
 	{
-		if (!collision->other.IsDynamic() && !collision->other.IsTrigger())
+		if (collision->type != CONTACT_END && !collision->other.IsDynamic() && !collision->other.IsTrigger())
 		{
 			BlockSelf(collision);
 		}
@@ -56,7 +57,7 @@ private:
 
 		// only handle the first contact point to avoid shaking
 		// this may result in some instablity
-		if (collision->contactPoints.size() > 0)
+		if (collision->numContactPoints > 0)
 		{
 			const auto& point = collision->contactPoints[0];
 			const auto& ptA = point.getPositionWorldOnA();
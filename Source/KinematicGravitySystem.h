@@ -4,29 +4,26 @@
 #include "TransformSystem.h"
 #include "MathUtility.h"
 #include "VelocitySystem.h"
-#include "LegCastSystem.h"
 
 struct KinematicGravityComponent
 {
 	U64 hTransform;
 	U64 hVelocity;
-	U64 hLegCast;
 	float gravity;
 };
 
 class KinematicGravitySystem : public ComponentSystem<KinematicGravityComponent>
 {
 public:
-	bool StartUp(U32 numComponents, EntityManager& em, TransformSystem& transformSystem, VelocitySystem& velocity, LegCastSystem& lcs)
+	bool StartUp(U32 numComponents, EntityManager& em, TransformSystem& transformSystem, VelocitySystem& velocity)
 	{
 		Parent::StartUp(numComponents, em);
 		m_transformSystem = &transformSystem;
 		m_velocitySystem = &velocity;
-		m_legCastSystem = &lcs;
 		return true;
 	}
 
-	U64 CreateComponent(Entity e, U64 hTransform, U64 hVelocity, U64 hLegCast, float gravity)
+	U64 CreateComponent(Entity e, U64 hTransform, U64 hVelocity, float gravity)
 	{
 		U64 handle = Parent::CreateComponent(e);
 		KinematicGravityComponent* comp = GetComponentByHandle(handle);
@@ -34,7 +31,6 @@ public:
 		comp->hTransform = hTransform;
 		comp->hVelocity = hVelocity;
 		comp->gravity = gravity;
-		comp->hLegCast = hLegCast;
 
 		return handle;
 	}
@@ -47,19 +43,12 @@ public:
 			// still need transform?
 			//TransformComponent* transform = m_transformSystem->GetComponentByHandle(comp->hTransform);
 			VelocityComponent* velocity = m_velocitySystem->GetComponentByHandle(comp->hVelocity);
+			// grounded characters have their fall cancelled by the character controller
 			velocity->velocity += Vector3(0, -comp->gravity * deltaTime, 0);
-
-			// still need leg cast?
-			//LegCastComponent* legCast = m_legCastSystem->GetComponentByHandle(comp->hLegCast);
-			//if (!legCast->grounded)
-			//{
-			//	velocity->velocity += Vector3(0, -comp->gravity * deltaTime, 0);
-			//}
 		}
 	}
 
 protected:
 	TransformSystem* m_transformSystem;
 	VelocitySystem* m_velocitySystem;
-	LegCastSystem* m_legCastSystem;
 };
\ No newline at end of file
@@ -1,7 +1,5 @@
 #pragma once
 
-#pragma once
-
 #include "ComponentSystem.h"
 #include "TransformSystem.h"
 #include "Physics.h"
@@ -12,6 +10,8 @@ struct KinematicRigidBodyComponent
 {
 	U64 transform = 0;
 	U64 rigidBody = 0;
+	XMVECTOR lastPosition;
+	XMVECTOR lastRotation;
 };
 
 
@@ -37,6 +37,11 @@ public:
 		comp->transform = hTransform;
 		comp->rigidBody = hRigidBody;
 
+		// the body starts where the transform is
+		TransformComponent* transform = m_transformSystem->GetComponentByHandle(hTransform);
+		comp->lastPosition = transform->position;
+		comp->lastRotation = transform->rotation;
+
 		return handle;
 	}
 
@@ -45,12 +50,19 @@ public:
 		for (U32 i = 0; i < m_pool.Size(); i++)
 		{
 			KinematicRigidBodyComponent* krb = m_pool[i];
-			RigidBodyComponent* rb = m_rigidBodySystem->GetComponentByHandle(krb->rigidBody);
-
 			TransformComponent* transform = m_transformSystem->GetComponentByHandle(krb->transform);
 
-			rb->body.SetPosition(transform->position);
-			rb->body.SetRotation(transform->rotation);
+			// most kinematic bodies sit still, only push the ones that moved
+			if (XMVector4Equal(transform->position, krb->lastPosition) && XMVector4Equal(transform->rotation, krb->lastRotation))
+			{
+				continue;
+			}
+
+			RigidBodyComponent* rb = m_rigidBodySystem->GetComponentByHandle(krb->rigidBody);
+			rb->body.SetTransform(transform->position, transform->rotation);
+
+			krb->lastPosition = transform->position;
+			krb->lastRotation = transform->rotation;
 		}
 	}
 
@@ -6,6 +6,7 @@
 #include <math.h>
 #include "MathUtility.h"
 #include "VelocitySystem.h"
+#include <vector>
 
 struct LegCastComponent
 {
@@ -46,51 +47,33 @@ public:
 
 	inline void Execute(float deltaTime) override
 	{
+		// cast every leg in one batch, the buffers are reused between frames
+		m_rays.resize(m_pool.Size());
+		m_hits.resize(m_pool.Size());
+
 		for (U32 i = 0; i < m_pool.Size(); i++)
 		{
 			LegCastComponent* comp = m_pool[i];
 			TransformComponent* transform = m_transformSystem->GetComponentByHandle(comp->hParentTransform);
-			VelocityComponent* velocity = m_velocitySystem->GetComponentByHandle(comp->hParentVelocity);
-
-			XMVECTOR rayStart = transform->position;
-			XMVECTOR rayEnd = XMVectorAdd(Vector3(0, -comp->legLength, 0), rayStart);
 
-			// This would be more efficient to use the closest raycast function combined with collision masks to filter out triggers
-			auto result = m_physics->RayCastAll(rayStart, rayEnd);
-			if (result.hasHit())
-			{
-				RigidBody rigidBody;
-				int idx = -1;
-				float closestFraction = 1;
-				for (int i = 0; i < result.m_collisionObjects.size(); ++i)
-				{
-					if (result.m_hitFractions[i] < closestFraction)
-					{
-						const btRigidBody* crb = static_cast<const btRigidBody*>(result.m_collisionObjects.at(i));
-						btRigidBody* rb = const_cast<btRigidBody*>(crb);
-						rigidBody = RigidBody(rb);
-						if (!rigidBody.IsTrigger())
-						{
-							idx = i;
-							closestFraction = result.m_hitFractions[i];
-						}
-					}
-				}
+			m_rays[i].start = transform->position;
+			m_rays[i].end = XMVectorAdd(Vector3(0, -comp->legLength, 0), transform->position);
+		}
 
-				// return if it's only hit triggers
-				if (idx < 0)
-				{
-					comp->grounded = false;
-					return;
-				}
+		// triggers are filtered out by the physics query
+		m_physics->RayCastBatch(m_rays.data(), m_hits.data(), m_pool.Size());
 
-				const auto& ptB = result.m_rayToWorld;
-				const auto& ptA = result.m_hitPointWorld[idx];
-				const auto& normalOnB = result.m_hitNormalWorld[idx];
+		for (U32 i = 0; i < m_pool.Size(); i++)
+		{
+			LegCastComponent* comp = m_pool[i];
+			TransformComponent* transform = m_transformSystem->GetComponentByHandle(comp->hParentTransform);
+			VelocityComponent* velocity = m_velocitySystem->GetComponentByHandle(comp->hParentVelocity);
+			const RayHit& hit = m_hits[i];
 
+			if (hit.hit)
+			{
 				// reposition above ground
-				XMVECTOR normal = Physics::VecToDX(normalOnB);
-				XMVECTOR diff = Physics::VecToDX(ptA - ptB);
+				XMVECTOR diff = XMVectorSubtract(hit.point, m_rays[i].end);
 				transform->position += diff;
 
 				// cancel out gravity velocity
@@ -111,4 +94,6 @@ protected:
 	TransformSystem * m_transformSystem;
 	Physics* m_physics;
 	VelocitySystem* m_velocitySystem;
+	std::vector<Ray> m_rays;
+	std::vector<RayHit> m_hits;
 };
\ No newline at end of file
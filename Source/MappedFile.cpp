@@ -0,0 +1,203 @@
+#include "MappedFile.h"
+#include "WriteLog.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : m_file{ INVALID_HANDLE_VALUE }, m_mapping{ nullptr }
+{
+}
+
+
+bool MappedFile::Open(const char* path, bool optional)
+{
+	Close();
+
+	m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		DWORD error = GetLastError();
+		if (!optional || (error != ERROR_FILE_NOT_FOUND && error != ERROR_PATH_NOT_FOUND))
+		{
+			DEBUG_ERROR("Could not open file: %s", path);
+		}
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+	{
+		DEBUG_ERROR("Could not map empty file: %s", path);
+		Close();
+		return false;
+	}
+
+	m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_mapping == nullptr)
+	{
+		DEBUG_ERROR("Could not map file: %s", path);
+		Close();
+		return false;
+	}
+
+	m_data = static_cast<const U8*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (m_data == nullptr)
+	{
+		DEBUG_ERROR("Could not map file: %s", path);
+		Close();
+		return false;
+	}
+
+	m_size = (size_t)size.QuadPart;
+	return true;
+}
+
+
+void MappedFile::Close()
+{
+	if (m_data != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+		m_data = nullptr;
+	}
+
+	if (m_mapping != nullptr)
+	{
+		CloseHandle(m_mapping);
+		m_mapping = nullptr;
+	}
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+
+	m_size = 0;
+}
+
+
+U64 GetFileModifiedTime(const char* path)
+{
+	WIN32_FILE_ATTRIBUTE_DATA info;
+	if (!GetFileAttributesExA(path, GetFileExInfoStandard, &info))
+	{
+		return 0;
+	}
+
+	// file times count 100ns intervals from 1601
+	static const U64 EPOCH_OFFSET = 116444736000000000ull;
+	U64 time = ((U64)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+	return time > EPOCH_OFFSET ? (time - EPOCH_OFFSET) / 10000000 : 0;
+}
+
+#else
+
+MappedFile::MappedFile() : m_file{ -1 }
+{
+}
+
+
+bool MappedFile::Open(const char* path, bool optional)
+{
+	Close();
+
+	m_file = open(path, O_RDONLY);
+	if (m_file < 0)
+	{
+		if (!optional || errno != ENOENT)
+		{
+			DEBUG_ERROR("Could not open file: %s", path);
+		}
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(m_file, &info) != 0 || info.st_size == 0)
+	{
+		DEBUG_ERROR("Could not map empty file: %s", path);
+		Close();
+		return false;
+	}
+
+	void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+	if (data == MAP_FAILED)
+	{
+		DEBUG_ERROR("Could not map file: %s", path);
+		Close();
+		return false;
+	}
+
+	m_data = static_cast<const U8*>(data);
+	m_size = (size_t)info.st_size;
+	return true;
+}
+
+
+void MappedFile::Close()
+{
+	if (m_data != nullptr)
+	{
+		munmap(const_cast<U8*>(m_data), m_size);
+		m_data = nullptr;
+	}
+
+	if (m_file >= 0)
+	{
+		close(m_file);
+		m_file = -1;
+	}
+
+	m_size = 0;
+}
+
+
+U64 GetFileModifiedTime(const char* path)
+{
+	struct stat info;
+	return stat(path, &info) == 0 ? (U64)info.st_mtime : 0;
+}
+
+#endif
+
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+
+void MappedFile::Prefetch() const
+{
+	PrefetchMemory(m_data, m_size);
+}
+
+
+void PrefetchMemory(const void* data, size_t size)
+{
+	static const size_t PAGE_SIZE = 4096;
+
+	const U8* bytes = static_cast<const U8*>(data);
+	volatile U8 sink = 0;
+	for (size_t offset = 0; offset < size; offset += PAGE_SIZE)
+	{
+		sink ^= bytes[offset];
+	}
+
+	// the last page when the range doesn't start on a page boundary
+	if (size > 0)
+	{
+		sink ^= bytes[size - 1];
+	}
+	(void)sink;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Types.h"
+#include <stddef.h>
+
+// Read only view of a whole file mapped into memory, pages are read from disk the first time they are touched.
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// optional files that don't exist fail without logging an error
+	bool Open(const char* path, bool optional = false);
+	void Close();
+
+	// touches every page so later reads don't stall on disk, meant for loader threads
+	void Prefetch() const;
+
+	inline const U8* GetData() const
+	{
+		return m_data;
+	}
+
+	inline size_t GetSize() const
+	{
+		return m_size;
+	}
+
+private:
+#ifdef _WIN32
+	void* m_file;
+	void* m_mapping;
+#else
+	int m_file;
+#endif
+	const U8* m_data = nullptr;
+	size_t m_size = 0;
+};
+
+
+// touches every page of a range of mapped memory, for views into a mapping such as a package's files
+void PrefetchMemory(const void* data, size_t size);
+
+// last write time in seconds since the epoch, 0 if the file doesn't exist
+U64 GetFileModifiedTime(const char* path);
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "Material.h"
+#include "ResourceManager.h"
+#include "Assert.h"
 
 
 Material::~Material()
@@ -6,66 +8,43 @@ Material::~Material()
 }
 
 
-bool Material::Load(Graphics& graphics, const wchar_t* shaderFile, const VertexFormat& vbfmt)
+bool Material::Select(Graphics& graphics, ResourceManager& resources, bool quantizedVertices)
 {
-	ID3DBlob* vsBlob = nullptr;
-	ID3DBlob* psBlob = nullptr;
+	// the float layout would read quantized vertices as garbage
+	ASSERT_VERBOSE(!quantizedVertices || m_quantizedVs.IsValid(), "Quantized model drawn with a material that has no quantized vertex shader");
 
-	// Create vertex shader
-	vsBlob = graphics.CreateShaderFromFile(shaderFile, "vsmain", "vs_5_0");
-	if (!vsBlob)
+	VertexShader* vs = resources.GetResourceByHandle(quantizedVertices ? m_quantizedVs : m_vs);
+	PixelShader* ps = resources.GetResourceByHandle(m_ps);
+	if (vs == nullptr || ps == nullptr || vs->GetState() != RESOURCE_READY || ps->GetState() != RESOURCE_READY)
 	{
 		return false;
 	}
 
-	m_vs = graphics.CreateVertexShader(vsBlob);
-	if (!m_vs)
+	ID3D11ShaderResourceView* inputs[MaxInputs] = {};
+	for (unsigned int i = 0; i < m_numInputs; ++i)
 	{
-		return false;
-	}
-	
-	// Create pixel shader
-	psBlob = graphics.CreateShaderFromFile(shaderFile, "psmain", "ps_5_0");
-	if (!psBlob)
-	{
-		return false;
-	}
-
-	m_ps = graphics.CreatePixelShader(psBlob);
-	if (!m_ps)
-	{
-		return false;
-	}
-
-	// Create the input layout
-	m_layout = graphics.CreateInputLayout(vsBlob, vbfmt);
-	if (!m_layout)
-	{
-		return false;
+		Texture* texture = resources.GetResourceByHandle(m_textures[i]);
+		if (texture == nullptr || texture->GetState() != RESOURCE_READY)
+		{
+			return false;
+		}
+		inputs[i] = texture->GetResourceView();
 	}
 
-	// Release the blobs!
-	vsBlob->Release();
-	psBlob->Release();
-
-	return true;
-}
-
-
-void Material::Select(Graphics& graphics)
-{
 	graphics.SetPrimitiveTopology(m_topology);
-	graphics.SetInputLayout(m_layout);
-	graphics.SetVertexShader(m_vs);
-	graphics.SetPixelShader(m_ps);
+	graphics.SetInputLayout(vs->GetLayout());
+	graphics.SetVertexShader(vs->Get());
+	graphics.SetPixelShader(ps->Get());
 
 	ID3D11Buffer* buff = m_cbs[0]->GetCurrentBuffer();
 	graphics.SetVSConstantBuffers(0, 1, &buff);
 	graphics.SetPSConstantBuffers(0, 1, &buff);
-	graphics.SetVSShaderInputs(0, 1, m_inputs);
-	graphics.SetPSShaderInputs(0, 1, m_inputs);
+	graphics.SetVSShaderInputs(0, 1, inputs);
+	graphics.SetPSShaderInputs(0, 1, inputs);
 	graphics.SetVSSamplers(0, 1, m_samplers);
 	graphics.SetPSSamplers(0, 1, m_samplers);
+
+	return true;
 }
 
 
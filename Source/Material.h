@@ -6,24 +6,31 @@
 #include "PixelShader.h"
 #include "Texture.h"
 #include "Resource.h"
+#include "ResourceHandle.h"
 
+class ResourceManager;
+
+// shaders and textures are held by handle and resolved when the material is selected, so one that was evicted
+// or is still loading is never bound
 class Material : public Resource
 {
 public:
+	static const ResourceType TYPE = RESOURCE_MATERIAL;
 	static const unsigned int MaxInputs = 32;
 	static const unsigned int MaxConstantBuffers = 8;
 	static const unsigned int MaxSamplers = 8;
 
 	~Material();
 
-	bool Load(Graphics& graphics, const wchar_t* shaderFile, const VertexFormat& vbfmt);
-	void Select(Graphics& graphics);
+	// false with nothing bound if a shader or texture isn't ready, skip the draw then.
+	// quantizedVertices picks the vertex shader for a model cooked with quantized vertices, see Model::IsQuantized
+	bool Select(Graphics& graphics, ResourceManager& resources, bool quantizedVertices = false);
 	void SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology);
 
 	void ClearInputs() { m_numInputs = 0; }
-	void AddTexture(Texture& tex)
+	void AddTexture(Handle<Texture> texture)
 	{
-		m_inputs[m_numInputs++] = tex.GetResourceView();
+		m_textures[m_numInputs++] = texture;
 	}
 
 	void ClearSamplers() { m_numSamplers = 0; }
@@ -38,22 +45,24 @@ public:
 	}
 	void ClearConstantBuffer(unsigned int slot) { m_cbs[slot] = nullptr; }
 
-	void SetShaders(VertexShader* vs, PixelShader* ps)
+	// quantizedVs is the same vertex shader built for VertPosNormUVColorQuantized, without one the material
+	// can't draw quantized models
+	void SetShaders(Handle<VertexShader> vs, Handle<PixelShader> ps, Handle<VertexShader> quantizedVs = Handle<VertexShader>())
 	{
-		m_vs = vs->Get();
-		m_ps = ps->Get();
-		m_layout = vs->GetLayout();
+		m_vs = vs;
+		m_ps = ps;
+		m_quantizedVs = quantizedVs;
 	}
 
 
 private:
-	ID3D11VertexShader * m_vs = nullptr;
-	ID3D11PixelShader* m_ps = nullptr;
-	ID3D11InputLayout* m_layout = nullptr;
+	Handle<VertexShader> m_vs;
+	Handle<VertexShader> m_quantizedVs;
+	Handle<PixelShader> m_ps;
 	D3D11_PRIMITIVE_TOPOLOGY m_topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
 	const Buffer* m_cbs[MaxConstantBuffers] = {};
-	ID3D11ShaderResourceView* m_inputs[MaxInputs] = {};
+	Handle<Texture> m_textures[MaxInputs];
 	ID3D11SamplerState* m_samplers[MaxSamplers] = {};
 	unsigned int m_numInputs = 0;
 	unsigned int m_numSamplers = 0;
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "Types.h"
+#include <stddef.h>
+#include <string>
+
+// Cooked mesh file written by the asset cooker from an OBJ source and mapped straight into memory at load time.
+// Layout: MeshFileHeader, then the vertex array and the index array, each starting on a 16 byte boundary.
+// Everything is little endian and laid out exactly like the vertex buffer, so no conversion happens on load.
+// Quantized meshes store positions relative to the header bounds, which the vertex shader uses to decode them.
+// Reduced levels of detail live in an optional .lod sidecar beside the mesh, as index ranges into its vertices.
+
+
+static const U32 MESH_FILE_MAGIC = 0x4853454d;	// "MESH"
+static const U32 MESH_FILE_VERSION = 1;
+static const U32 MESH_FILE_ALIGNMENT = 16;
+
+static const U32 LOD_FILE_MAGIC = 0x53444f4c;	// "LODS"
+static const U32 LOD_FILE_VERSION = 1;
+static const U32 MAX_MESH_LODS = 8;
+
+
+enum MeshVertexFormat
+{
+	MESH_VERTEX_POS_NORM_UV_COLOR,	// VertPosNormUVColor
+	MESH_VERTEX_QUANTIZED,			// VertPosNormUVColorQuantized
+	NUM_MESH_VERTEX_FORMATS
+};
+
+
+// same layout as VertPosNormUVColor, which tools can't include without d3d
+struct MeshVertex
+{
+	float x, y, z;
+	float nx, ny, nz;
+	float u, v;
+	U32 color;
+};
+
+
+// same layout as VertPosNormUVColorQuantized
+struct MeshVertexQuantized
+{
+	U16 x, y, z, w;			// unorm across the bounds, w is always 1
+	I16 nx, ny;				// snorm octahedral normal
+	U16 u, v;				// half floats
+	U32 color;
+};
+
+
+inline U32 GetMeshVertexStride(U32 vertexFormat)
+{
+	switch (vertexFormat)
+	{
+	case MESH_VERTEX_POS_NORM_UV_COLOR: return sizeof(MeshVertex);
+	case MESH_VERTEX_QUANTIZED: return sizeof(MeshVertexQuantized);
+	default: return 0;
+	}
+}
+
+
+struct MeshFileHeader
+{
+	U32 magic;
+	U32 version;
+	U32 vertexFormat;
+	U32 vertexStride;
+	U32 numVertices;
+	U32 numIndices;			// 32 bit triangle list indices
+	U64 vertexOffset;		// from the start of the file
+	U64 indexOffset;
+	float boundsMin[3];
+	float boundsMax[3];
+};
+
+
+inline U64 AlignMeshOffset(U64 offset)
+{
+	return (offset + MESH_FILE_ALIGNMENT - 1) & ~(U64)(MESH_FILE_ALIGNMENT - 1);
+}
+
+
+// checks a mapped file before its arrays are used, returns the header or null if the file is damaged or out of date
+inline const MeshFileHeader* ValidateMeshFile(const void* data, size_t size)
+{
+	if (size < sizeof(MeshFileHeader))
+	{
+		return nullptr;
+	}
+
+	const MeshFileHeader* header = static_cast<const MeshFileHeader*>(data);
+	if (header->magic != MESH_FILE_MAGIC || header->version != MESH_FILE_VERSION ||
+		header->vertexStride == 0 || header->vertexStride != GetMeshVertexStride(header->vertexFormat))
+	{
+		return nullptr;
+	}
+
+	// the ranges are checked by what is left after each offset, an end offset could wrap
+	if (header->vertexOffset % MESH_FILE_ALIGNMENT != 0 || header->indexOffset % MESH_FILE_ALIGNMENT != 0 ||
+		header->vertexOffset < sizeof(MeshFileHeader) || header->vertexOffset > header->indexOffset ||
+		(header->indexOffset - header->vertexOffset) / header->vertexStride < header->numVertices ||
+		header->indexOffset > size || (size - header->indexOffset) / sizeof(U32) < header->numIndices ||
+		header->numIndices == 0 || header->numIndices % 3 != 0)
+	{
+		return nullptr;
+	}
+
+	return header;
+}
+
+
+inline const void* GetMeshVertices(const MeshFileHeader* header)
+{
+	return reinterpret_cast<const U8*>(header) + header->vertexOffset;
+}
+
+
+inline const U32* GetMeshIndices(const MeshFileHeader* header)
+{
+	return reinterpret_cast<const U32*>(reinterpret_cast<const U8*>(header) + header->indexOffset);
+}
+
+
+// maps unorm quantized positions back into the mesh's space: pos = q * scale + offset
+inline void GetMeshDequantization(const MeshFileHeader* header, float scale[3], float offset[3])
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		scale[i] = header->boundsMax[i] - header->boundsMin[i];
+		offset[i] = header->boundsMin[i];
+	}
+}
+
+
+// one reduced level, a range of the sidecar's index array
+struct MeshLodLevel
+{
+	U32 firstIndex;
+	U32 numIndices;
+	float error;			// RMS distance from the full mesh's surface, in mesh units
+	U32 reserved;
+};
+
+
+// levels run from the least reduced to the most, errors never fall along the chain
+struct LodFileHeader
+{
+	U32 magic;
+	U32 version;
+	U32 numVertices;		// of the mesh the levels index into
+	U32 numLevels;
+	U32 numIndices;
+	U32 reserved;
+	U64 indexOffset;
+	MeshLodLevel levels[MAX_MESH_LODS];
+};
+
+
+// "Assets/monkey.mesh" -> "Assets/monkey.lod"
+inline std::string GetLodFilePath(const std::string& meshPath)
+{
+	size_t dot = meshPath.find_last_of('.');
+	size_t slash = meshPath.find_last_of("/\\");
+	bool hasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+	return (hasExtension ? meshPath.substr(0, dot) : meshPath) + ".lod";
+}
+
+
+// checks a mapped sidecar against the mesh it belongs to, returns the header or null
+inline const LodFileHeader* ValidateLodFile(const void* data, size_t size, const MeshFileHeader* mesh)
+{
+	if (size < sizeof(LodFileHeader))
+	{
+		return nullptr;
+	}
+
+	const LodFileHeader* header = static_cast<const LodFileHeader*>(data);
+	if (header->magic != LOD_FILE_MAGIC || header->version != LOD_FILE_VERSION ||
+		header->numVertices != mesh->numVertices || header->numLevels > MAX_MESH_LODS)
+	{
+		return nullptr;
+	}
+
+	if (header->indexOffset % MESH_FILE_ALIGNMENT != 0 || header->indexOffset < sizeof(LodFileHeader) ||
+		header->indexOffset > size || (size - header->indexOffset) / sizeof(U32) < header->numIndices ||
+		header->numIndices % 3 != 0)
+	{
+		return nullptr;
+	}
+
+	for (U32 i = 0; i < header->numLevels; ++i)
+	{
+		const MeshLodLevel& level = header->levels[i];
+		if ((U64)level.firstIndex + level.numIndices > header->numIndices || level.numIndices == 0 || level.numIndices % 3 != 0)
+		{
+			return nullptr;
+		}
+	}
+
+	return header;
+}
+
+
+inline const U32* GetLodIndices(const LodFileHeader* header)
+{
+	return reinterpret_cast<const U32*>(reinterpret_cast<const U8*>(header) + header->indexOffset);
+}
\ No newline at end of file
@@ -3,19 +3,21 @@
 #include "ComponentSystem.h"
 #include "Model.h"
 #include "Material.h"
+#include "ResourceHandle.h"
 
+// resolved through the resource manager when drawn, a mesh whose model or material is gone is skipped
 struct MeshComponent
 {
 	U64 transform;
-	Model* model = nullptr;
-	Material* material = nullptr;
+	Handle<Model> model;
+	Handle<Material> material;
 };
 
 
 class MeshSystem : public ComponentSystem<MeshComponent>
 {
 public:
-	U64 CreateComponent(Entity e, U64 hTransform, Model* model, Material* material)
+	U64 CreateComponent(Entity e, U64 hTransform, Handle<Model> model, Handle<Material> material)
 	{
 		U64 handle = Parent::CreateComponent(e);
 		MeshComponent* comp = GetComponentByHandle(handle);
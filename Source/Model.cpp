@@ -1,7 +1,12 @@
 #include "Model.h"
+#include "MeshFile.h"
 #include "Assert.h"
 
 
+static_assert(sizeof(MeshVertex) == sizeof(VertPosNormUVColor), "cooked mesh vertices must match VertPosNormUVColor");
+static_assert(sizeof(MeshVertexQuantized) == sizeof(VertPosNormUVColorQuantized), "quantized cooked mesh vertices must match VertPosNormUVColorQuantized");
+
+
 Model::~Model()
 {
 
@@ -10,18 +15,51 @@ Model::~Model()
 
 bool Model::LoadFromOBJ(Graphics& graphics, const char* filename)
 {
-	ASSERT(!initialized);
-	initialized = true;
+	vector<VertPosNormUVColor> vertData;
+	vector<unsigned int> objIndices;
+
+	if (!ReadOBJ(filename, vertData, objIndices))
+	{
+		return false;
+	}
+
+	return Create(graphics, vertData, objIndices);
+}
 
+
+static void ConvertOBJVertices(const vector<OBJLoader::Vertex>& objVerts, vector<VertPosNormUVColor>& vertData);
+
+
+bool Model::ReadOBJ(const char* filename, vector<VertPosNormUVColor>& vertData, vector<unsigned int>& objIndices)
+{
 	vector<OBJLoader::Vertex> objVerts;
-	vector<unsigned int> objIndices;
 
 	if (!OBJLoader::LoadFromFile(filename, objVerts, objIndices))
 	{
 		return false;
 	}
 
-	vector<VertPosNormUVColor> vertData;
+	ConvertOBJVertices(objVerts, vertData);
+	return true;
+}
+
+
+bool Model::ReadOBJ(const void* data, size_t size, vector<VertPosNormUVColor>& vertData, vector<unsigned int>& objIndices)
+{
+	vector<OBJLoader::Vertex> objVerts;
+
+	if (!OBJLoader::LoadFromMemory(static_cast<const char*>(data), size, objVerts, objIndices))
+	{
+		return false;
+	}
+
+	ConvertOBJVertices(objVerts, vertData);
+	return true;
+}
+
+
+static void ConvertOBJVertices(const vector<OBJLoader::Vertex>& objVerts, vector<VertPosNormUVColor>& vertData)
+{
 	vertData.resize(objVerts.size());
 	for (size_t i = 0; i < objVerts.size(); ++i)
 	{
@@ -38,32 +76,131 @@ bool Model::LoadFromOBJ(Graphics& graphics, const char* filename)
 			objVerts[i].Color[2],
 			objVerts[i].Color[3]);
 	}
+}
+
+
+bool Model::Create(Graphics& graphics, const vector<VertPosNormUVColor>& vertData, const vector<unsigned int>& objIndices)
+{
+	return Create(graphics, vertData.data(), (unsigned int)vertData.size(), objIndices.data(), (unsigned int)objIndices.size());
+}
+
+
+bool Model::Create(Graphics& graphics, const VertPosNormUVColor* vertData, unsigned int numVertices, const unsigned int* indices, unsigned int numIndices)
+{
+	return Create(graphics, VertPosNormUVColor::GetVertexFormat(), vertData, numVertices, indices, numIndices);
+}
+
+
+bool Model::Create(Graphics& graphics, const MeshFileHeader* header)
+{
+	if (header->vertexFormat != MESH_VERTEX_QUANTIZED)
+	{
+		return Create(graphics, static_cast<const VertPosNormUVColor*>(GetMeshVertices(header)), header->numVertices,
+			GetMeshIndices(header), header->numIndices);
+	}
+
+	DequantizeConstants consts = {};
+	GetMeshDequantization(header, consts.positionScale, consts.positionOffset);
+	if (!m_dequantizeConstants.CreateConstantBuffer(graphics, sizeof(consts), false, &consts))
+	{
+		return false;
+	}
+
+	m_quantized = true;
+	return Create(graphics, VertPosNormUVColorQuantized::GetVertexFormat(), GetMeshVertices(header), header->numVertices,
+		GetMeshIndices(header), header->numIndices);
+}
+
+
+bool Model::Create(Graphics& graphics, const VertexFormat& format, const void* vertData, unsigned int numVertices, const unsigned int* indices, unsigned int numIndices)
+{
+	ASSERT(!initialized);
+	initialized = true;
 
 	// init vert buffer
-	if (!m_vb.StartUp(graphics, VertPosNormUVColor::GetVertexFormat(), vertData.size(), false, false, &vertData[0]))
+	if (!m_vb.StartUp(graphics, format, numVertices, false, false, vertData))
 	{
 		return false;
 	}
 
 	// init index buffer
-	m_numIndices = objIndices.size();
-	if (!m_ib.StartUp(graphics, m_numIndices, false, false, &objIndices[0]))
+	if (!m_ib.StartUp(graphics, numIndices, false, false, indices))
 	{
 		return false;
 	}
 
+	AddMemorySize((size_t)numVertices * format.Stride + (size_t)numIndices * sizeof(unsigned int));
+	m_lods.assign(1, { 0, numIndices, 0.0f });
 	return true;
 }
 
 
-void Model::Select(Graphics& graphics)
+bool Model::CreateLods(Graphics& graphics, const LodFileHeader* header)
+{
+	ASSERT(initialized && m_lods.size() == 1);
+	if (header->numLevels == 0)
+	{
+		return true;
+	}
+
+	if (!m_lodIb.StartUp(graphics, header->numIndices, false, false, GetLodIndices(header)))
+	{
+		return false;
+	}
+
+	AddMemorySize((size_t)header->numIndices * sizeof(unsigned int));
+
+	for (U32 i = 0; i < header->numLevels; ++i)
+	{
+		const MeshLodLevel& level = header->levels[i];
+		m_lods.push_back({ level.firstIndex, level.numIndices, level.error });
+	}
+
+	return true;
+}
+
+
+unsigned int Model::SelectLod(const XMMATRIX& world, FXMVECTOR cameraPos, float pixelsPerUnit, float maxPixelError) const
+{
+	float scale = XMVectorGetX(XMVectorMax(XMVector3Length(world.r[0]), XMVectorMax(XMVector3Length(world.r[1]), XMVector3Length(world.r[2]))));
+	float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(world.r[3], cameraPos)));
+
+	// an error of e model units at distance d covers e * scale * pixelsPerUnit / d pixels
+	float maxError = maxPixelError * distance / (scale * pixelsPerUnit);
+	for (unsigned int lod = (unsigned int)m_lods.size() - 1; lod > 0; --lod)
+	{
+		if (m_lods[lod].error <= maxError)
+		{
+			return lod;
+		}
+	}
+
+	return 0;
+}
+
+
+void Model::Select(Graphics& graphics, unsigned int lod)
 {
 	m_vb.Select(graphics);
-	m_ib.Select(graphics);
+	if (lod == 0)
+	{
+		m_ib.Select(graphics);
+	}
+	else
+	{
+		m_lodIb.Select(graphics);
+	}
+
+	if (m_quantized)
+	{
+		ID3D11Buffer* buffer = m_dequantizeConstants.GetCurrentBuffer();
+		graphics.SetVSConstantBuffers(1, 1, &buffer);
+	}
 }
 
 
-void Model::Draw(Graphics& graphics)
+void Model::Draw(Graphics& graphics, unsigned int lod)
 {
-	graphics.DrawIndexed(m_numIndices);
+	const ModelLod& level = m_lods[lod];
+	graphics.DrawIndexed(level.numIndices, level.firstIndex);
 }
\ No newline at end of file
@@ -3,26 +3,77 @@
 #include "Graphics.h"
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
+#include "Buffer.h"
 #include "VertexFormat.h"
 #include "OBJLoader.h"
 #include "Resource.h"
+#include <DirectXMath.h>
 #include <vector>
 
 using namespace std;
+using namespace DirectX;
+
+struct MeshFileHeader;
+struct LodFileHeader;
+
+
+// one level of detail, a range of the model's indices. level 0 is the full mesh with no error
+struct ModelLod
+{
+	unsigned int firstIndex;
+	unsigned int numIndices;
+	float error;			// distance from the full mesh's surface in model units
+};
 
 
 class Model : public Resource
 {
 public:
+	static const ResourceType TYPE = RESOURCE_MODEL;
+
 	~Model();
 
 	bool LoadFromOBJ(Graphics& graphics, const char* filename);
-	void Select(Graphics& graphics);
-	void Draw(Graphics& graphics);
+
+	// parsing doesn't touch the device so it may run on a loader thread, Create makes the buffers from its output
+	static bool ReadOBJ(const char* filename, vector<VertPosNormUVColor>& vertices, vector<unsigned int>& indices);
+	static bool ReadOBJ(const void* data, size_t size, vector<VertPosNormUVColor>& vertices, vector<unsigned int>& indices);
+	bool Create(Graphics& graphics, const vector<VertPosNormUVColor>& vertices, const vector<unsigned int>& indices);
+	bool Create(Graphics& graphics, const VertPosNormUVColor* vertices, unsigned int numVertices, const unsigned int* indices, unsigned int numIndices);
+
+	// a validated cooked mesh in any of its vertex formats, quantized ones also get their dequantization constants
+	bool Create(Graphics& graphics, const MeshFileHeader* header);
+
+	// reduced levels from the cooked mesh's .lod sidecar, they index the vertex buffer made by Create
+	bool CreateLods(Graphics& graphics, const LodFileHeader* header);
+
+	bool IsQuantized() const { return m_quantized; }
+
+	unsigned int GetNumLods() const { return (unsigned int)m_lods.size(); }
+	const ModelLod& GetLod(unsigned int lod) const { return m_lods[lod]; }
+
+	// coarsest level whose error covers no more than maxPixelError pixels on screen. pixelsPerUnit is the screen
+	// height over 2 tan(fovY / 2), distance is measured to the model's origin and errors grow with its largest scale
+	unsigned int SelectLod(const XMMATRIX& world, FXMVECTOR cameraPos, float pixelsPerUnit, float maxPixelError = 1.0f) const;
+
+	void Select(Graphics& graphics, unsigned int lod = 0);
+	void Draw(Graphics& graphics, unsigned int lod = 0);
 
 private:
+	bool Create(Graphics& graphics, const VertexFormat& format, const void* vertices, unsigned int numVertices, const unsigned int* indices, unsigned int numIndices);
+
+	// bound to vertex shader slot 1 while a quantized model is selected
+	struct DequantizeConstants
+	{
+		float positionScale[4];
+		float positionOffset[4];
+	};
+
 	VertexBuffer m_vb;
 	IndexBuffer m_ib;
-	unsigned int m_numIndices = 0;
+	IndexBuffer m_lodIb;
+	Buffer m_dequantizeConstants;
+	vector<ModelLod> m_lods;
+	bool m_quantized = false;
 	bool initialized = false;
 };
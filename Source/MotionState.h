@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Types.h"
+#include "btBulletDynamicsCommon.h"
+
+
+// Receives the transform of a body each step bullet moves it, only active dynamic bodies are reported
+class MotionStateListener
+{
+public:
+	virtual void OnBodyMoved(U64 handle, const btTransform& transform) = 0;
+};
+
+
+// Motion state for every engine body, pushes simulated transforms to a listener instead of being polled
+ATTRIBUTE_ALIGNED16(class) MotionState : public btMotionState
+{
+public:
+	BT_DECLARE_ALIGNED_ALLOCATOR();
+
+	MotionState(const btTransform& transform) : m_transform{ transform } {}
+
+	// handle is passed back to the listener to find the object the body drives
+	inline void SetListener(MotionStateListener* listener, U64 handle)
+	{
+		m_listener = listener;
+		m_handle = handle;
+	}
+
+	void getWorldTransform(btTransform& transform) const override
+	{
+		transform = m_transform;
+	}
+
+	void setWorldTransform(const btTransform& transform) override
+	{
+		m_transform = transform;
+
+		if (m_listener)
+		{
+			m_listener->OnBodyMoved(m_handle, transform);
+		}
+	}
+
+private:
+	btTransform m_transform;
+	MotionStateListener* m_listener = nullptr;
+	U64 m_handle = 0;
+};
\ No newline at end of file
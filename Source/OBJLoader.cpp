@@ -3,18 +3,23 @@
 #include <tiny_obj_loader.h>
 
 #include "OBJLoader.h"
+#include <istream>
 #include <unordered_map>
 
 using namespace tinyobj;
 using namespace std;
 
-namespace std {
+// beside index_t so std::equal_to finds it by argument lookup on every compiler
+namespace tinyobj {
 	bool operator==(const index_t& a, const index_t& b)
 	{
 		return a.vertex_index == b.vertex_index &&
 			a.normal_index == b.normal_index &&
 			a.texcoord_index == b.texcoord_index;
 	}
+}
+
+namespace std {
 	template<> struct hash<index_t>
 	{
 		size_t operator() (const index_t& idx) const
@@ -28,6 +33,21 @@ namespace std {
 }
 
 
+// read only stream over memory for tinyobj, nothing is copied
+struct MemoryStreamBuffer : public streambuf
+{
+	MemoryStreamBuffer(const char* data, size_t size)
+	{
+		char* begin = const_cast<char*>(data);
+		setg(begin, begin, begin + size);
+	}
+};
+
+
+static bool ConvertOBJ(const attrib_t& attrib, const vector<shape_t>& shapes, std::vector<OBJLoader::Vertex>& vertices,
+	std::vector<unsigned int>& indices);
+
+
 bool OBJLoader::LoadFromFile(const char* filename, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
 {
 	attrib_t attrib;
@@ -39,12 +59,41 @@ bool OBJLoader::LoadFromFile(const char* filename, std::vector<Vertex>& vertices
 	if (!err.empty())
 	{
 		// `err` may contain warning message. May want to output it here
-		DEBUG_ERROR(err.c_str());
+		DEBUG_ERROR("%s", err.c_str());
 	}
 
 	if (!ret)
 		return false;
 
+	return ConvertOBJ(attrib, shapes, vertices, indices);
+}
+
+
+bool OBJLoader::LoadFromMemory(const char* data, size_t size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	attrib_t attrib;
+	vector<shape_t> shapes;
+	vector<material_t> materials;
+	string err;
+
+	MemoryStreamBuffer buffer(data, size);
+	istream stream(&buffer);
+	bool ret = LoadObj(&attrib, &shapes, &materials, NULL, &err, &stream);
+	if (!err.empty())
+	{
+		DEBUG_ERROR("%s", err.c_str());
+	}
+
+	if (!ret)
+		return false;
+
+	return ConvertOBJ(attrib, shapes, vertices, indices);
+}
+
+
+static bool ConvertOBJ(const attrib_t& attrib, const vector<shape_t>& shapes, std::vector<OBJLoader::Vertex>& vertices,
+	std::vector<unsigned int>& indices)
+{
 	unordered_map<index_t, unsigned int> idxmap;
 
 	// Loop over shapes
@@ -71,7 +120,7 @@ bool OBJLoader::LoadFromFile(const char* filename, std::vector<Vertex>& vertices
 	// Iterate the unordered_map to fill the vertex data
 	for (const pair<index_t, unsigned int>& entry : idxmap)
 	{
-		Vertex& vert = vertices[entry.second];
+		OBJLoader::Vertex& vert = vertices[entry.second];
 		vert.Position[0] = attrib.vertices[3 * entry.first.vertex_index + 0];
 		vert.Position[1] = attrib.vertices[3 * entry.first.vertex_index + 1];
 		vert.Position[2] = attrib.vertices[3 * entry.first.vertex_index + 2];
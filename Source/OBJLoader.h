@@ -17,4 +17,8 @@ public:
 
 	static bool LoadFromFile(const char* filename, std::vector<Vertex>& vertices,
 		std::vector<unsigned int>& indices);
+
+	// an OBJ already in memory such as a packaged file, materials aren't loaded either way
+	static bool LoadFromMemory(const char* data, size_t size, std::vector<Vertex>& vertices,
+		std::vector<unsigned int>& indices);
 };
\ No newline at end of file
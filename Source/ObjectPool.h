@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Allocator.h"
+#include "Assert.h"
+#include <new>
+#include <utility>
+
+
+// Fixed block of slots for one type, freed slots are reused through an intrusive free list.
+// Once the block is full further objects fall back to the heap so callers never need to check.
+template <class T>
+class ObjectPool
+{
+public:
+	~ObjectPool()
+	{
+		ShutDown();
+	}
+
+
+	inline bool StartUp(U32 capacity, MemoryCategory category)
+	{
+		m_capacity = capacity;
+		m_slots = static_cast<Slot*>(AllocateMemory(sizeof(Slot) * capacity, alignof(Slot), category));
+		if (!m_slots)
+		{
+			return false;
+		}
+
+		// thread every slot onto the free list
+		m_freeList = nullptr;
+		for (U32 i = capacity; i > 0; --i)
+		{
+			m_slots[i - 1].next = m_freeList;
+			m_freeList = &m_slots[i - 1];
+		}
+
+		return true;
+	}
+
+
+	// every pooled object must be destroyed first
+	inline void ShutDown()
+	{
+		ASSERT(m_numActive == 0);
+
+		FreeMemory(m_slots);
+		m_slots = nullptr;
+		m_freeList = nullptr;
+		m_capacity = 0;
+	}
+
+
+	template <class... Args>
+	inline T* Create(Args&&... args)
+	{
+		if (!m_freeList)
+		{
+			return new T(std::forward<Args>(args)...);
+		}
+
+		Slot* slot = m_freeList;
+		m_freeList = slot->next;
+		m_numActive++;
+
+		return new (slot->storage) T(std::forward<Args>(args)...);
+	}
+
+
+	inline void Destroy(T* object)
+	{
+		if (!Owns(object))
+		{
+			delete object;
+			return;
+		}
+
+		object->~T();
+
+		Slot* slot = reinterpret_cast<Slot*>(object);
+		slot->next = m_freeList;
+		m_freeList = slot;
+		m_numActive--;
+	}
+
+
+	inline bool Owns(const T* object) const
+	{
+		const Slot* slot = reinterpret_cast<const Slot*>(object);
+		return slot >= m_slots && slot < m_slots + m_capacity;
+	}
+
+
+	inline U32 NumActive() const
+	{
+		return m_numActive;
+	}
+
+private:
+	union Slot
+	{
+		Slot* next;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	Slot* m_slots = nullptr;
+	Slot* m_freeList = nullptr;
+	U32 m_capacity = 0;
+	U32 m_numActive = 0;
+};
\ No newline at end of file
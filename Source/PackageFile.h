@@ -0,0 +1,116 @@
+#pragma once
+
+#include "StringId.h"
+#include <stddef.h>
+
+// Package file written by the asset cooker's pack command, many asset files behind one mapping.
+// Layout: PackageFileHeader, the entries sorted by key, the name table, then every file's bytes starting on a
+// page boundary, so the header and table of contents come in with the first read and file data keeps any alignment
+// its own format relies on.
+
+
+static const U32 PACKAGE_FILE_MAGIC = 0x4b434150;	// "PACK"
+static const U32 PACKAGE_FILE_VERSION = 2;
+static const U32 PACKAGE_FILE_ALIGNMENT = 4096;
+
+
+struct PackageEntry
+{
+	StringId key;			// StringHash of the path the engine loads it by, e.g. "Assets/cube.mesh"
+	U32 nameOffset;			// of the path into the name table, for tools and error messages
+	U64 offset;				// from the start of the file
+	U64 size;
+	U64 modifiedTime;		// of the file that was packed, seconds since the epoch
+};
+
+
+struct PackageFileHeader
+{
+	U32 magic;
+	U32 version;
+	U32 numEntries;
+	U32 namesSize;
+	U64 entriesOffset;
+	U64 namesOffset;		// null terminated paths
+};
+
+
+inline U64 AlignPackageOffset(U64 offset)
+{
+	return (offset + PACKAGE_FILE_ALIGNMENT - 1) & ~(U64)(PACKAGE_FILE_ALIGNMENT - 1);
+}
+
+
+inline const PackageEntry* GetPackageEntries(const PackageFileHeader* header)
+{
+	return reinterpret_cast<const PackageEntry*>(reinterpret_cast<const U8*>(header) + header->entriesOffset);
+}
+
+
+inline const char* GetPackageEntryName(const PackageFileHeader* header, const PackageEntry& entry)
+{
+	return reinterpret_cast<const char*>(header) + header->namesOffset + entry.nameOffset;
+}
+
+
+// checks a mapped file before its entries are used, returns the header or null if the file is damaged or out of date.
+// keys must be strictly increasing so a lookup can binary search and a path collision fails at pack time
+inline const PackageFileHeader* ValidatePackageFile(const void* data, size_t size)
+{
+	if (size < sizeof(PackageFileHeader))
+	{
+		return nullptr;
+	}
+
+	const PackageFileHeader* header = static_cast<const PackageFileHeader*>(data);
+	if (header->magic != PACKAGE_FILE_MAGIC || header->version != PACKAGE_FILE_VERSION ||
+		header->entriesOffset % sizeof(U64) != 0 || header->entriesOffset > size ||
+		(size - header->entriesOffset) / sizeof(PackageEntry) < header->numEntries ||
+		header->namesOffset > size || size - header->namesOffset < header->namesSize)
+	{
+		return nullptr;
+	}
+
+	const char* names = reinterpret_cast<const char*>(header) + header->namesOffset;
+	if (header->namesSize > 0 && names[header->namesSize - 1] != '\0')
+	{
+		return nullptr;
+	}
+
+	const PackageEntry* entries = GetPackageEntries(header);
+	for (U32 i = 0; i < header->numEntries; ++i)
+	{
+		const PackageEntry& entry = entries[i];
+		if ((i > 0 && entry.key <= entries[i - 1].key) || entry.nameOffset >= header->namesSize ||
+			entry.offset % PACKAGE_FILE_ALIGNMENT != 0 || entry.offset > size || size - entry.offset < entry.size)
+		{
+			return nullptr;
+		}
+	}
+
+	return header;
+}
+
+
+// binary search of the sorted entries, null if the package doesn't hold the key
+inline const PackageEntry* FindPackageEntry(const PackageFileHeader* header, StringId key)
+{
+	const PackageEntry* entries = GetPackageEntries(header);
+	U32 first = 0;
+	U32 count = header->numEntries;
+	while (count > 0)
+	{
+		U32 half = count / 2;
+		if (entries[first + half].key < key)
+		{
+			first += half + 1;
+			count -= half + 1;
+		}
+		else
+		{
+			count = half;
+		}
+	}
+
+	return first < header->numEntries && entries[first].key == key ? &entries[first] : nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "PackageReader.h"
+#include "WriteLog.h"
+
+
+bool PackageReader::Open(const char* path, bool optional)
+{
+	Close();
+
+	if (!m_file.Open(path, optional))
+	{
+		return false;
+	}
+
+	m_header = ValidatePackageFile(m_file.GetData(), m_file.GetSize());
+	if (m_header == nullptr)
+	{
+		DEBUG_ERROR("Invalid package file: %s", path);
+		m_file.Close();
+		return false;
+	}
+
+#ifdef _DEBUG
+	U32 numStale = 0;
+	m_stale.assign(m_header->numEntries, false);
+	for (U32 i = 0; i < m_header->numEntries; ++i)
+	{
+		const PackageEntry& entry = GetEntry(i);
+		m_stale[i] = GetFileModifiedTime(GetName(entry)) > entry.modifiedTime;
+		numStale += m_stale[i] ? 1 : 0;
+	}
+
+	if (numStale > 0)
+	{
+		DEBUG_PRINT("%u files in %s are older than their loose files, loading those instead", numStale, path);
+	}
+#endif
+
+	return true;
+}
+
+
+void PackageReader::Close()
+{
+	m_header = nullptr;
+	m_file.Close();
+#ifdef _DEBUG
+	m_stale.clear();
+#endif
+}
+
+
+const U8* PackageReader::Find(StringId key, size_t& size) const
+{
+	const PackageEntry* entry = m_header != nullptr ? FindPackageEntry(m_header, key) : nullptr;
+#ifdef _DEBUG
+	if (entry != nullptr && m_stale[entry - GetPackageEntries(m_header)])
+	{
+		entry = nullptr;
+	}
+#endif
+
+	if (entry == nullptr)
+	{
+		size = 0;
+		return nullptr;
+	}
+
+	size = (size_t)entry->size;
+	return m_file.GetData() + entry->offset;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "PackageFile.h"
+#include "MappedFile.h"
+#include <vector>
+
+// A mounted package, the whole file is mapped once and every lookup hands back a view straight into the mapping.
+// Lookups only read, so loader threads may share one reader once it is open.
+class PackageReader
+{
+public:
+	// optional packages that don't exist fail without logging an error. debug builds also check every entry against
+	// the loose file at its path here, once, and leave out the ones the loose file was written after
+	bool Open(const char* path, bool optional = false);
+	void Close();
+
+	inline bool IsOpen() const
+	{
+		return m_header != nullptr;
+	}
+
+	// the file's bytes or null if the package doesn't hold it, valid until the package is closed.
+	// lookups never touch the file system
+	const U8* Find(StringId key, size_t& size) const;
+
+	// by the path the file was packed under, e.g. "Assets/cube.mesh"
+	inline const U8* Find(const char* path, size_t& size) const
+	{
+		return Find(StringHash(path), size);
+	}
+
+	inline U32 GetNumEntries() const
+	{
+		return m_header != nullptr ? m_header->numEntries : 0;
+	}
+
+	inline const PackageEntry& GetEntry(U32 index) const
+	{
+		return GetPackageEntries(m_header)[index];
+	}
+
+	inline const char* GetName(const PackageEntry& entry) const
+	{
+		return GetPackageEntryName(m_header, entry);
+	}
+
+private:
+	MappedFile m_file;
+	const PackageFileHeader* m_header = nullptr;
+
+#ifdef _DEBUG
+	// per entry, set when the loose file was written after it was packed so edits load without repacking
+	std::vector<bool> m_stale;
+#endif
+};
\ No newline at end of file
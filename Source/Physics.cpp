@@ -1,6 +1,158 @@
 #include "Physics.h"
 #include "Assert.h"
-#include "EngineEvents.h"
+#include "PhysicsQueries.h"
+#include <algorithm>
+
+// rays per task when a batch is split between threads
+static const U32 RAY_BATCH_GRAIN_SIZE = 64;
+
+// overlaps and sweeps per task, each one costs several narrowphase tests
+static const U32 SHAPE_QUERY_GRAIN_SIZE = 16;
+
+// characters per task, each one runs up to a few dozen sweeps
+static const U32 CHARACTER_GRAIN_SIZE = 4;
+
+
+// splits a batch between the physics threads when there's a scheduler and enough work to share
+static void RunQueryBatch(bool threaded, U32 count, U32 grainSize, const btIParallelForBody& body)
+{
+	if (threaded && count >= grainSize * 2)
+	{
+		btParallelFor(0, count, grainSize, body);
+	}
+	else
+	{
+		body.forLoop(0, count);
+	}
+}
+
+
+// casts a range of rays from a batch, each ray writes only its own hit
+struct RayCastBody : public btIParallelForBody
+{
+	RayCastBody(const btCollisionWorld* world, const Ray* rays, RayHit* hits, int layerMask, bool includeTriggers)
+		: m_world{ world }, m_rays{ rays }, m_hits{ hits }, m_layerMask{ layerMask }, m_includeTriggers{ includeTriggers } {}
+
+	void forLoop(int begin, int end) const override
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			btVector3 start = Physics::VecFromDX(m_rays[i].start);
+			btVector3 stop = Physics::VecFromDX(m_rays[i].end);
+
+			ClosestRayFilterCallback callback(start, stop, m_layerMask, m_includeTriggers);
+			m_world->rayTest(start, stop, callback);
+
+			RayHit& hit = m_hits[i];
+			hit.hit = callback.hasHit();
+			if (hit.hit)
+			{
+				const btCollisionObject* obj = ResolveBakedBody(callback.m_collisionObject, callback.m_childIndex);
+				hit.body = RigidBody(const_cast<btCollisionObject*>(obj));
+				hit.point = Physics::VecToDX(callback.m_hitPointWorld);
+				hit.normal = Physics::VecToDX(callback.m_hitNormalWorld);
+				hit.fraction = callback.m_closestHitFraction;
+			}
+			else
+			{
+				hit.fraction = 1.f;
+			}
+		}
+	}
+
+	const btCollisionWorld* m_world;
+	const Ray* m_rays;
+	RayHit* m_hits;
+	int m_layerMask;
+	bool m_includeTriggers;
+};
+
+
+static U32 RunOverlap(btCollisionWorld* world, const SphereOverlap& query, Entity* entities, U32 maxEntities, int layerMask, bool includeTriggers)
+{
+	btSphereShape shape(query.radius);
+	btTransform transform(btQuaternion::getIdentity(), Physics::VecFromDX(query.center));
+	return QueryOverlap(world, &shape, transform, entities, maxEntities, layerMask, includeTriggers);
+}
+
+
+static U32 RunOverlap(btCollisionWorld* world, const BoxOverlap& query, Entity* entities, U32 maxEntities, int layerMask, bool includeTriggers)
+{
+	btBoxShape shape(Physics::VecFromDX(query.halfExtents));
+	btTransform transform(Physics::QuatFromDX(query.rotation), Physics::VecFromDX(query.center));
+	return QueryOverlap(world, &shape, transform, entities, maxEntities, layerMask, includeTriggers);
+}
+
+
+// runs a range of overlap queries from a batch, each query writes only its own slice of the results
+template<class Query>
+struct OverlapBody : public btIParallelForBody
+{
+	OverlapBody(btCollisionWorld* world, const Query* queries, Entity* entities, U32 maxEntitiesPerQuery, U32* numEntities, int layerMask, bool includeTriggers)
+		: m_world{ world }, m_queries{ queries }, m_entities{ entities }, m_maxEntitiesPerQuery{ maxEntitiesPerQuery },
+		  m_numEntities{ numEntities }, m_layerMask{ layerMask }, m_includeTriggers{ includeTriggers } {}
+
+	void forLoop(int begin, int end) const override
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			m_numEntities[i] = RunOverlap(m_world, m_queries[i], m_entities + (size_t)i * m_maxEntitiesPerQuery,
+										  m_maxEntitiesPerQuery, m_layerMask, m_includeTriggers);
+		}
+	}
+
+	btCollisionWorld* m_world;
+	const Query* m_queries;
+	Entity* m_entities;
+	U32 m_maxEntitiesPerQuery;
+	U32* m_numEntities;
+	int m_layerMask;
+	bool m_includeTriggers;
+};
+
+
+// sweeps a range of shapes from a batch, each sweep writes only its own hit
+struct SweepBody : public btIParallelForBody
+{
+	SweepBody(const btCollisionWorld* world, const ShapeSweep* sweeps, RayHit* hits, int layerMask, bool includeTriggers, const btCollisionObject* ignore)
+		: m_world{ world }, m_sweeps{ sweeps }, m_hits{ hits }, m_layerMask{ layerMask }, m_includeTriggers{ includeTriggers }, m_ignore{ ignore } {}
+
+	void forLoop(int begin, int end) const override
+	{
+		for (int i = begin; i < end; ++i)
+		{
+			const ShapeSweep& sweep = m_sweeps[i];
+			btQuaternion rotation = Physics::QuatFromDX(sweep.rotation);
+			btTransform start(rotation, Physics::VecFromDX(sweep.start));
+			btTransform stop(rotation, Physics::VecFromDX(sweep.end));
+
+			ClosestSweepFilterCallback callback(start.getOrigin(), stop.getOrigin(), m_layerMask, m_includeTriggers, m_ignore);
+			m_world->convexSweepTest(static_cast<const btConvexShape*>(sweep.shape.m_collider), start, stop, callback);
+
+			RayHit& hit = m_hits[i];
+			hit.hit = callback.hasHit();
+			if (hit.hit)
+			{
+				const btCollisionObject* obj = ResolveBakedBody(callback.m_hitCollisionObject, callback.m_childIndex);
+				hit.body = RigidBody(const_cast<btCollisionObject*>(obj));
+				hit.point = Physics::VecToDX(callback.m_hitPointWorld);
+				hit.normal = Physics::VecToDX(callback.m_hitNormalWorld);
+				hit.fraction = callback.m_closestHitFraction;
+			}
+			else
+			{
+				hit.fraction = 1.f;
+			}
+		}
+	}
+
+	const btCollisionWorld* m_world;
+	const ShapeSweep* m_sweeps;
+	RayHit* m_hits;
+	int m_layerMask;
+	bool m_includeTriggers;
+	const btCollisionObject* m_ignore;
+};
 
 Physics::~Physics()
 {
@@ -8,29 +160,91 @@ Physics::~Physics()
 }
 
 
-bool Physics::StartUp(EventBus* eventBus)
+bool Physics::StartUp(EventBus* eventBus, const PhysicsConfig& config)
 {
 	m_eventBus = eventBus;
 
+	// must happen before bullet allocates anything so every block is freed by the allocator that made it
+	InstallPhysicsAllocator();
+	m_bodyPool.StartUp(config.maxPooledBodies, MEMORY_PHYSICS);
+	m_motionStatePool.StartUp(config.maxPooledBodies, MEMORY_PHYSICS);
+
+	// bullet only builds its thread pool when compiled with BT_THREADSAFE
+	if (config.multithreaded)
+	{
+		m_taskScheduler = btCreateDefaultTaskScheduler();
+		if (m_taskScheduler)
+		{
+			if (config.numThreads > 0)
+			{
+				m_taskScheduler->setNumThreads(config.numThreads);
+			}
+
+			btSetTaskScheduler(m_taskScheduler);
+			DEBUG_PRINT("Physics running on %d threads", m_taskScheduler->getNumThreads());
+		}
+		else
+		{
+			DEBUG_ERROR("Physics task scheduler unavailable, falling back to a single thread");
+		}
+	}
+
 	// collision configuration contains default setup for memory, collision setup. Advanced users can create their own configuration.
 	m_collisionConfiguration = new btDefaultCollisionConfiguration();
 
-	// use the default collision dispatcher. For parallel processing you can use a diffent dispatcher
-	m_dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
-
 	// btDbvtBroadphase is a good general purpose broadphase.
 	m_overlappingPairCache = new btDbvtBroadphase();
 
-	// the default constraint solver. For parallel processing you can use a different solver
-	m_solver = new btSequentialImpulseConstraintSolver;
+	if (m_taskScheduler)
+	{
+		// narrowphase is split across the threads, islands are solved by a pool with one solver per thread
+		m_dispatcher = new btCollisionDispatcherMt(m_collisionConfiguration);
+		btConstraintSolverPoolMt* solverPool = new btConstraintSolverPoolMt(m_taskScheduler->getNumThreads());
+		m_solver = solverPool;
+		m_dynamicsWorld = new btDiscreteDynamicsWorldMt(m_dispatcher, m_overlappingPairCache, solverPool, nullptr, m_collisionConfiguration);
+	}
+	else
+	{
+		// use the default collision dispatcher
+		m_dispatcher = new btCollisionDispatcher(m_collisionConfiguration);
+
+		// the default constraint solver
+		m_solver = new btSequentialImpulseConstraintSolver;
 
-	m_dynamicsWorld = new btDiscreteDynamicsWorld(m_dispatcher, m_overlappingPairCache, m_solver, m_collisionConfiguration);
+		m_dynamicsWorld = new btDiscreteDynamicsWorld(m_dispatcher, m_overlappingPairCache, m_solver, m_collisionConfiguration);
+	}
+
+	// keeps trigger pairs out of narrowphase
+	m_dispatcher->setNearCallback(TriggerNearCallback);
+
+	// bullet's own profile zones feed the step stats
+	InstallStepProfiler();
 
 	// default gravity value
 	SetGravity(10);
 
+	// default layer matrix, triggers only need to see characters and static or kinematic geometry never meet
+	for (U32 i = 0; i < NUM_COLLISION_LAYERS; ++i)
+	{
+		m_layerMasks[i] = 0;
+	}
+	SetLayerCollision(LAYER_STATIC, LAYER_DYNAMIC, true);
+	SetLayerCollision(LAYER_STATIC, LAYER_CHARACTER, true);
+	SetLayerCollision(LAYER_STATIC, LAYER_PROJECTILE, true);
+	SetLayerCollision(LAYER_KINEMATIC, LAYER_DYNAMIC, true);
+	SetLayerCollision(LAYER_KINEMATIC, LAYER_CHARACTER, true);
+	SetLayerCollision(LAYER_KINEMATIC, LAYER_PROJECTILE, true);
+	SetLayerCollision(LAYER_DYNAMIC, LAYER_DYNAMIC, true);
+	SetLayerCollision(LAYER_DYNAMIC, LAYER_CHARACTER, true);
+	SetLayerCollision(LAYER_DYNAMIC, LAYER_PROJECTILE, true);
+	SetLayerCollision(LAYER_CHARACTER, LAYER_CHARACTER, true);
+	SetLayerCollision(LAYER_CHARACTER, LAYER_PROJECTILE, true);
+	SetLayerCollision(LAYER_CHARACTER, LAYER_TRIGGER, true);
+	SetLayerCollision(LAYER_PROJECTILE, LAYER_PROJECTILE, true);
+
 	// allows ghost objects to be used
-	m_dynamicsWorld->getPairCache()->setInternalGhostPairCallback(new btGhostPairCallback());
+	m_ghostPairCallback = new btGhostPairCallback();
+	m_dynamicsWorld->getPairCache()->setInternalGhostPairCallback(m_ghostPairCallback);
 
 	return true;
 }
@@ -46,27 +260,53 @@ void Physics::ShutDown()
 		{
 			btCollisionObject* obj = m_dynamicsWorld->getCollisionObjectArray()[i];
 
-			// delete motion state
+			// remove object
+			m_dynamicsWorld->removeCollisionObject(obj);
+
+			// return bodies and their motion states to the pools
 			btRigidBody* body = btRigidBody::upcast(obj);
-			if (body && body->getMotionState())
+			if (body)
 			{
-				delete body->getMotionState();
-			}
+				if (body->getMotionState())
+				{
+					m_motionStatePool.Destroy(static_cast<MotionState*>(body->getMotionState()));
+				}
 
-			// delete collision shape
-			if (obj->getCollisionShape())
+				m_bodyPool.Destroy(body);
+			}
+			else
 			{
-				delete obj->getCollisionShape();
+				delete obj;
 			}
-
-			// remove and delete object
-			m_dynamicsWorld->removeCollisionObject(obj);
-			delete obj;
 		}
 
 		delete m_dynamicsWorld;
 		m_dynamicsWorld = nullptr;
 	}
+
+	m_contactPairs.clear();
+	m_triggers.clear();
+
+	// baked bodies live outside the world, they're freed with the compounds that replaced them
+	for (BakedGeometry* baked : m_bakedGeometry)
+	{
+		for (btRigidBody* body : baked->children)
+		{
+			m_motionStatePool.Destroy(static_cast<MotionState*>(body->getMotionState()));
+			m_bodyPool.Destroy(body);
+		}
+
+		delete baked->shape;
+		delete baked;
+	}
+	m_bakedGeometry.clear();
+
+	// delete collision shapes, they are shared so they're freed once here rather than per body
+	for (auto& cached : m_shapeCache)
+	{
+		delete cached.second.shape;
+	}
+	m_shapeCache.clear();
 	
 	// delete solver
 	if (m_solver)
@@ -82,6 +322,13 @@ void Physics::ShutDown()
 		m_overlappingPairCache = nullptr;
 	}
 
+	// the pair cache that called it is gone with the broadphase
+	if (m_ghostPairCallback)
+	{
+		delete m_ghostPairCallback;
+		m_ghostPairCallback = nullptr;
+	}
+
 	// delete dispatcher
 	if (m_dispatcher)
 	{
@@ -94,14 +341,31 @@ void Physics::ShutDown()
 	{
 		delete m_collisionConfiguration;
 		m_collisionConfiguration = nullptr;
-	}	
+	}
+
+	// stop the worker threads after everything that could use them is gone
+	if (m_taskScheduler)
+	{
+		btSetTaskScheduler(btGetSequentialTaskScheduler());
+		delete m_taskScheduler;
+		m_taskScheduler = nullptr;
+	}
+
+	m_bodyPool.ShutDown();
+	m_motionStatePool.ShutDown();	
 }
 
 
 void Physics::RunSimulation(float deltaTime)
 {
+	BeginStepProfile();
 	m_dynamicsWorld->stepSimulation(deltaTime);
-	SimulationCallback(m_dynamicsWorld, deltaTime);
+	{
+		BT_PROFILE(PHYSICS_CALLBACKS_ZONE);
+		SimulationCallback(m_dynamicsWorld, deltaTime);
+	}
+	EndStepProfile(m_stepStats);
+	CountStepStats(m_dynamicsWorld, m_stepStats);
 }
 
 
@@ -112,46 +376,72 @@ void Physics::SetGravity(float gravity)
 }
 
 
-ColliderPtr Physics::CreateCollisionBox(float x, float y, float z)
+ColliderPtr Physics::CreateCollisionBox(float x, float y, float z, XMVECTOR scale)
 {
-	btCollisionShape* shape = new btBoxShape(btVector3(btScalar(x), btScalar(y), btScalar(z)));
+	ShapeKey key(BOX_SHAPE_PROXYTYPE, x, y, z, scale);
+	btCollisionShape* shape = FindShape(key);
+	if (!shape)
+	{
+		shape = CacheShape(key, new btBoxShape(btVector3(btScalar(x), btScalar(y), btScalar(z))));
+	}
 
 	return ColliderPtr(shape);
 }
 
-ColliderPtr Physics::CreateCollisionSphere(float radius)
+
+ColliderPtr Physics::CreateCollisionSphere(float radius, XMVECTOR scale)
 {
-	btCollisionShape* shape = new btSphereShape(radius);
+	ShapeKey key(SPHERE_SHAPE_PROXYTYPE, radius, 0.f, 0.f, scale);
+	btCollisionShape* shape = FindShape(key);
+	if (!shape)
+	{
+		shape = CacheShape(key, new btSphereShape(radius));
+	}
 
 	return ColliderPtr(shape);
 }
 
 
-ColliderPtr Physics::CreateCollisionCylinder(float x, float y, float z)
+ColliderPtr Physics::CreateCollisionCylinder(float x, float y, float z, XMVECTOR scale)
 {
-	btCollisionShape* shape = new btCylinderShape(btVector3(x, y, z));
+	ShapeKey key(CYLINDER_SHAPE_PROXYTYPE, x, y, z, scale);
+	btCollisionShape* shape = FindShape(key);
+	if (!shape)
+	{
+		shape = CacheShape(key, new btCylinderShape(btVector3(x, y, z)));
+	}
 
 	return ColliderPtr(shape);
 }
 
 
-ColliderPtr Physics::CreateCollisionCone(float radius, float height)
+ColliderPtr Physics::CreateCollisionCone(float radius, float height, XMVECTOR scale)
 {
-	btCollisionShape* shape = new btConeShape(radius, height);
+	ShapeKey key(CONE_SHAPE_PROXYTYPE, radius, height, 0.f, scale);
+	btCollisionShape* shape = FindShape(key);
+	if (!shape)
+	{
+		shape = CacheShape(key, new btConeShape(radius, height));
+	}
 
 	return ColliderPtr(shape);
 }
 
 
-ColliderPtr Physics::CreateCollisionCapsule(float radius, float height)
+ColliderPtr Physics::CreateCollisionCapsule(float radius, float height, XMVECTOR scale)
 {
-	btCollisionShape* shape = new btCapsuleShape(radius, height);
+	ShapeKey key(CAPSULE_SHAPE_PROXYTYPE, radius, height, 0.f, scale);
+	btCollisionShape* shape = FindShape(key);
+	if (!shape)
+	{
+		shape = CacheShape(key, new btCapsuleShape(radius, height));
+	}
 
 	return ColliderPtr(shape);
 }
 
 
-RigidBody Physics::CreateDynamicRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, float mass)
+RigidBody Physics::CreateDynamicRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, float mass, CollisionLayer layer)
 {
 	ASSERT_VERBOSE(mass > 0.f, "Dynamic rigid bodies must have a mass greater than 0");
 	if (mass < 0.f)
@@ -167,11 +457,11 @@ RigidBody Physics::CreateDynamicRigidBody(Entity e, ColliderPtr shape, XMVECTOR
 	btVector3 localInertia(0, 0, 0);
 	shape.m_collider->calculateLocalInertia(mass, localInertia);
 
-	btDefaultMotionState* motionState = new btDefaultMotionState(transform);
+	MotionState* motionState = m_motionStatePool.Create(transform);
 	btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState, shape.m_collider, localInertia);
-	btRigidBody* body = new btRigidBody(rbInfo);
+	btRigidBody* body = m_bodyPool.Create(rbInfo);
 	
-	m_dynamicsWorld->addRigidBody(body);
+	AddToWorld(body, layer);
 
 	RigidBody rb(body);
 	rb.SetEntity(e);
@@ -179,7 +469,7 @@ RigidBody Physics::CreateDynamicRigidBody(Entity e, ColliderPtr shape, XMVECTOR
 }
 
 
-RigidBody Physics::CreateStaticRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, bool isTrigger)
+RigidBody Physics::CreateStaticRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, bool isTrigger, CollisionLayer layer)
 {
 	btTransform transform;
 	transform.setIdentity();
@@ -187,16 +477,16 @@ RigidBody Physics::CreateStaticRigidBody(Entity e, ColliderPtr shape, XMVECTOR p
 	transform.setOrigin(VecFromDX(position));
 	btVector3 localInertia(0, 0, 0);
 
-	btDefaultMotionState* motionState = new btDefaultMotionState(transform);
+	MotionState* motionState = m_motionStatePool.Create(transform);
 	btRigidBody::btRigidBodyConstructionInfo rbInfo(0, motionState, shape.m_collider, localInertia);
-	btRigidBody* body = new btRigidBody(rbInfo);
+	btRigidBody* body = m_bodyPool.Create(rbInfo);
 
 	if (isTrigger)
 	{
 		body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_NO_CONTACT_RESPONSE);
 	}
 
-	m_dynamicsWorld->addRigidBody(body);
+	AddToWorld(body, layer);
 
 	RigidBody rb(body);
 	rb.SetEntity(e);
@@ -204,7 +494,7 @@ RigidBody Physics::CreateStaticRigidBody(Entity e, ColliderPtr shape, XMVECTOR p
 }
 
 
-RigidBody Physics::CreateKinematicRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, bool isTrigger)
+RigidBody Physics::CreateKinematicRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, bool isTrigger, CollisionLayer layer)
 {
 	btTransform transform;
 	transform.setIdentity();
@@ -212,9 +502,9 @@ RigidBody Physics::CreateKinematicRigidBody(Entity e, ColliderPtr shape, XMVECTO
 	transform.setOrigin(VecFromDX(position));
 	btVector3 localInertia(0, 0, 0);
 
-	btDefaultMotionState* motionState = new btDefaultMotionState(transform);
+	MotionState* motionState = m_motionStatePool.Create(transform);
 	btRigidBody::btRigidBodyConstructionInfo rbInfo(0, motionState, shape.m_collider, localInertia);
-	btRigidBody* body = new btRigidBody(rbInfo);
+	btRigidBody* body = m_bodyPool.Create(rbInfo);
 
 	// kinematic flags
 	body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
@@ -225,7 +515,7 @@ RigidBody Physics::CreateKinematicRigidBody(Entity e, ColliderPtr shape, XMVECTO
 		body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_NO_CONTACT_RESPONSE);
 	}
 
-	m_dynamicsWorld->addRigidBody(body);
+	AddToWorld(body, layer);
 
 	RigidBody rb(body);
 	rb.SetEntity(e);
@@ -233,7 +523,7 @@ RigidBody Physics::CreateKinematicRigidBody(Entity e, ColliderPtr shape, XMVECTO
 }
 
 
-RigidBody Physics::CreateCharacterBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation)
+RigidBody Physics::CreateCharacterBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, CollisionLayer layer)
 {
 	btTransform transform;
 	transform.setIdentity();
@@ -241,15 +531,15 @@ RigidBody Physics::CreateCharacterBody(Entity e, ColliderPtr shape, XMVECTOR pos
 	transform.setOrigin(VecFromDX(position));
 	btVector3 localInertia(0, 0, 0);
 
-	btDefaultMotionState* motionState = new btDefaultMotionState(transform);
+	MotionState* motionState = m_motionStatePool.Create(transform);
 	btRigidBody::btRigidBodyConstructionInfo rbInfo(0, motionState, shape.m_collider, localInertia);
-	btRigidBody* body = new btRigidBody(rbInfo);
+	btRigidBody* body = m_bodyPool.Create(rbInfo);
 
 	// kinematic flags
 	body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
 	body->setActivationState(DISABLE_DEACTIVATION);
 
-	m_dynamicsWorld->addRigidBody(body, btBroadphaseProxy::DefaultFilter, btBroadphaseProxy::AllFilter);
+	AddToWorld(body, layer);
 
 	RigidBody rb(body);
 	rb.SetEntity(e);
@@ -257,57 +547,330 @@ RigidBody Physics::CreateCharacterBody(Entity e, ColliderPtr shape, XMVECTOR pos
 }
 
 
+RigidBody Physics::CreateTrigger(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, CollisionLayer layer)
+{
+	btTransform transform;
+	transform.setIdentity();
+	transform.setRotation(QuatFromDX(rotation));
+	transform.setOrigin(VecFromDX(position));
+
+	btPairCachingGhostObject* ghost = new btPairCachingGhostObject();
+	ghost->setCollisionShape(shape.m_collider);
+	ghost->setWorldTransform(transform);
+
+	// static so it's never treated as dynamic, no contact response so it reads as a trigger everywhere else
+	ghost->setCollisionFlags(ghost->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_NO_CONTACT_RESPONSE);
+
+	AddToWorld(ghost, layer);
+	m_triggers.push_back(ghost);
+
+	RigidBody rb(ghost);
+	rb.SetEntity(e);
+	return rb;
+}
+
+
 void Physics::DestroyRigidBody(RigidBody body)
 {
-	btRigidBody* rb = body.m_body;
-	
+	btCollisionObject* obj = body.m_body;
+
+	// forget the body's contact pairs without reporting them, its entity is being destroyed
+	for (auto itr = m_contactPairs.begin(); itr != m_contactPairs.end();)
+	{
+		if (itr->first.bodyA == obj || itr->first.bodyB == obj)
+		{
+			itr = m_contactPairs.erase(itr);
+		}
+		else
+		{
+			++itr;
+		}
+	}
+
+	// and the separated pairs still waiting to be reported
+	for (ContactPairKey& pair : m_endedPairs)
+	{
+		if (pair.bodyA == obj || pair.bodyB == obj)
+		{
+			pair.bodyA = nullptr;
+			pair.bodyB = nullptr;
+		}
+	}
+
+	btRigidBody* rb = btRigidBody::upcast(obj);
+	if (!rb)
+	{
+		btPairCachingGhostObject* ghost = static_cast<btPairCachingGhostObject*>(obj);
+		m_triggers.erase(std::find(m_triggers.begin(), m_triggers.end(), ghost));
+		m_dynamicsWorld->removeCollisionObject(ghost);
+		ReleaseShape(ghost->getCollisionShape());
+		delete ghost;
+		return;
+	}
+
 	if (rb->getMotionState())
 	{
-		delete rb->getMotionState();
+		m_motionStatePool.Destroy(static_cast<MotionState*>(rb->getMotionState()));
+	}
+
+	if (!UnbakeBody(rb))
+	{
+		m_dynamicsWorld->removeRigidBody(rb);
 	}
 
 	if (rb->getCollisionShape())
 	{
-		delete rb->getCollisionShape();
+		ReleaseShape(rb->getCollisionShape());
+	}
+
+	m_bodyPool.Destroy(rb);
+}
+
+
+U32 Physics::BakeStaticGeometry()
+{
+	// only plain static geometry is merged, moving bodies and triggers keep their own broadphase proxies
+	std::vector<btRigidBody*> bodies;
+	btCollisionObjectArray& objects = m_dynamicsWorld->getCollisionObjectArray();
+	for (int i = 0; i < objects.size(); ++i)
+	{
+		btRigidBody* body = btRigidBody::upcast(objects[i]);
+		if (body && body->isStaticObject() && !body->isKinematicObject() && !body->getUserPointer() &&
+			!(body->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE) &&
+			body->getBroadphaseHandle()->m_collisionFilterGroup == LayerMask(LAYER_STATIC))
+		{
+			bodies.push_back(body);
+		}
+	}
+
+	if (bodies.size() < 2)
+	{
+		return 0;
+	}
+
+#ifdef _DEBUG
+	int numProxies = m_dynamicsWorld->getNumCollisionObjects();
+#endif
+
+	// the compound sits at the origin so each child keeps its body's world transform
+	BakedGeometry* baked = new BakedGeometry;
+	baked->shape = new btCompoundShape(true, (int)bodies.size());
+	for (btRigidBody* body : bodies)
+	{
+		baked->shape->addChildShape(body->getWorldTransform(), body->getCollisionShape());
+		baked->children.push_back(body);
+
+		// the body stays alive outside the world so its entity and transform can still be read
+		m_dynamicsWorld->removeRigidBody(body);
+	}
+
+	btTransform transform;
+	transform.setIdentity();
+	MotionState* motionState = m_motionStatePool.Create(transform);
+	btRigidBody::btRigidBodyConstructionInfo rbInfo(0, motionState, baked->shape, btVector3(0, 0, 0));
+	baked->body = m_bodyPool.Create(rbInfo);
+	baked->body->setUserPointer(baked);
+
+	// added directly since the compound isn't a cached shape
+	m_dynamicsWorld->addRigidBody(baked->body, LayerMask(LAYER_STATIC), m_layerMasks[LAYER_STATIC]);
+	m_bakedGeometry.push_back(baked);
+
+	DEBUG_PRINT("Baked %u static bodies, collision objects %d -> %d", (U32)bodies.size(), numProxies, m_dynamicsWorld->getNumCollisionObjects());
+
+	return (U32)bodies.size();
+}
+
+
+void Physics::SetLayerCollision(CollisionLayer a, CollisionLayer b, bool collide)
+{
+	if (collide)
+	{
+		m_layerMasks[a] |= LayerMask(b);
+		m_layerMasks[b] |= LayerMask(a);
+	}
+	else
+	{
+		m_layerMasks[a] &= ~LayerMask(b);
+		m_layerMasks[b] &= ~LayerMask(a);
+	}
+}
+
+
+bool Physics::GetLayerCollision(CollisionLayer a, CollisionLayer b) const
+{
+	return (m_layerMasks[a] & LayerMask(b)) != 0;
+}
+
+
+int Physics::GetCollisionMask(CollisionLayer layer) const
+{
+	return m_layerMasks[layer];
+}
+
+
+btDiscreteDynamicsWorld* Physics::GetDynamicsWorld() const
+{
+	return m_dynamicsWorld;
+}
+
+
+bool Physics::IsMultithreaded() const
+{
+	return m_taskScheduler != nullptr;
+}
+
+
+U32 Physics::GetNumOverlappingPairs() const
+{
+	return m_dynamicsWorld->getBroadphase()->getOverlappingPairCache()->getNumOverlappingPairs();
+}
+
+
+U32 Physics::GetNumContactManifolds() const
+{
+	return m_dynamicsWorld->getDispatcher()->getNumManifolds();
+}
+
+
+const PhysicsStepStats& Physics::GetStepStats() const
+{
+	return m_stepStats;
+}
+
+
+void Physics::AddCollisionListener(Entity e, CollisionListener* listener, bool receiveStay)
+{
+	m_collisionListeners[e.id].push_back({ listener, receiveStay });
+}
+
+
+void Physics::RemoveCollisionListener(Entity e, CollisionListener* listener)
+{
+	auto itr = m_collisionListeners.find(e.id);
+	if (itr == m_collisionListeners.end())
+	{
+		return;
+	}
+
+	ListenerList& listeners = itr->second;
+	listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+		[listener](const CollisionRoute& route) { return route.listener == listener; }), listeners.end());
+
+	// drop empty entries so uninterested bodies stay a single failed lookup
+	if (listeners.empty())
+	{
+		m_collisionListeners.erase(itr);
 	}
+}
 
-	m_dynamicsWorld->removeRigidBody(rb);
-	delete rb;
+
+bool Physics::RayCast(const Ray& ray, RayHit& hit, int layerMask, bool includeTriggers)
+{
+	RayCastBatch(&ray, &hit, 1, layerMask, includeTriggers);
+	return hit.hit;
 }
 
 
-// Copies RayCallback which is inefficient. TODO (ideal): RayCast(const &start, const &end, &result)
-btCollisionWorld::ClosestRayResultCallback Physics::RayCast(XMVECTOR startPos, XMVECTOR endPos)
+void Physics::RayCastBatch(const Ray* rays, RayHit* hits, U32 count, int layerMask, bool includeTriggers)
 {
-	btVector3 start = VecFromDX(startPos);
-	btVector3 end = VecFromDX(endPos);
+	// ray tests only read the world, so with a task scheduler the batch can be split between threads
+	RayCastBody body(m_dynamicsWorld, rays, hits, layerMask, includeTriggers);
+	RunQueryBatch(m_taskScheduler != nullptr, count, RAY_BATCH_GRAIN_SIZE, body);
+}
 
-	btCollisionWorld::ClosestRayResultCallback RayCallback(start, end);
-	m_dynamicsWorld->rayTest(start, end, RayCallback);
 
-	return RayCallback;
+U32 Physics::OverlapSphere(XMVECTOR center, float radius, Entity* entities, U32 maxEntities, int layerMask, bool includeTriggers)
+{
+	SphereOverlap query = { center, radius };
+	return RunOverlap(m_dynamicsWorld, query, entities, maxEntities, layerMask, includeTriggers);
 }
 
 
-btCollisionWorld::AllHitsRayResultCallback Physics::RayCastAll(XMVECTOR startPos, XMVECTOR endPos)
+U32 Physics::OverlapBox(XMVECTOR center, XMVECTOR halfExtents, XMVECTOR rotation, Entity* entities, U32 maxEntities, int layerMask, bool includeTriggers)
 {
-	btVector3 start = VecFromDX(startPos);
-	btVector3 end = VecFromDX(endPos);
+	BoxOverlap query = { center, halfExtents, rotation };
+	return RunOverlap(m_dynamicsWorld, query, entities, maxEntities, layerMask, includeTriggers);
+}
 
-	btCollisionWorld::AllHitsRayResultCallback RayCallback(start, end);
-	m_dynamicsWorld->rayTest(start, end, RayCallback);
 
-	return RayCallback;
+void Physics::OverlapSphereBatch(const SphereOverlap* queries, U32 count, Entity* entities, U32 maxEntitiesPerQuery, U32* numEntities, int layerMask, bool includeTriggers)
+{
+	OverlapBody<SphereOverlap> body(m_dynamicsWorld, queries, entities, maxEntitiesPerQuery, numEntities, layerMask, includeTriggers);
+	RunQueryBatch(m_taskScheduler != nullptr, count, SHAPE_QUERY_GRAIN_SIZE, body);
+}
+
+
+void Physics::OverlapBoxBatch(const BoxOverlap* queries, U32 count, Entity* entities, U32 maxEntitiesPerQuery, U32* numEntities, int layerMask, bool includeTriggers)
+{
+	OverlapBody<BoxOverlap> body(m_dynamicsWorld, queries, entities, maxEntitiesPerQuery, numEntities, layerMask, includeTriggers);
+	RunQueryBatch(m_taskScheduler != nullptr, count, SHAPE_QUERY_GRAIN_SIZE, body);
+}
+
+
+bool Physics::SweepConvex(const ShapeSweep& sweep, RayHit& hit, int layerMask, bool includeTriggers, const RigidBody* ignore)
+{
+	SweepConvexBatch(&sweep, &hit, 1, layerMask, includeTriggers, ignore);
+	return hit.hit;
+}
+
+
+void Physics::SweepConvexBatch(const ShapeSweep* sweeps, RayHit* hits, U32 count, int layerMask, bool includeTriggers, const RigidBody* ignore)
+{
+	for (U32 i = 0; i < count; ++i)
+	{
+		ASSERT_VERBOSE(sweeps[i].shape.m_collider->isConvex(), "Only convex shapes can be swept");
+	}
+
+	SweepBody body(m_dynamicsWorld, sweeps, hits, layerMask, includeTriggers, ignore ? ignore->m_body : nullptr);
+	RunQueryBatch(m_taskScheduler != nullptr, count, SHAPE_QUERY_GRAIN_SIZE, body);
+}
+
+
+void Physics::MoveCharacters(CharacterMove* moves, U32 count, int layerMask)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	m_characterMotions.resize(count);
+	for (U32 i = 0; i < count; ++i)
+	{
+		const btCollisionObject* body = moves[i].body.m_body;
+		ASSERT_VERBOSE(body->getCollisionShape()->isConvex(), "Characters need a convex shape to sweep");
+
+		CharacterMotion& motion = m_characterMotions[i];
+		motion.shape = static_cast<const btConvexShape*>(body->getCollisionShape());
+		motion.body = body;
+		motion.position = VecFromDX(moves[i].position);
+		motion.displacement = VecFromDX(moves[i].displacement);
+		motion.stepHeight = moves[i].stepHeight;
+		motion.maxSlopeCos = cosf(moves[i].maxSlopeAngle);
+		motion.grounded = moves[i].grounded;
+	}
+
+	m_characterSettings.layerMask = layerMask;
+	CharacterMotionBody body(m_dynamicsWorld, &m_characterMotions[0], m_characterSettings);
+	RunQueryBatch(m_taskScheduler != nullptr, count, CHARACTER_GRAIN_SIZE, body);
+
+	for (U32 i = 0; i < count; ++i)
+	{
+		const CharacterMotion& motion = m_characterMotions[i];
+		moves[i].position = VecToDX(motion.position);
+		moves[i].groundNormal = VecToDX(motion.groundNormal);
+		moves[i].grounded = motion.grounded;
+		moves[i].hitCeiling = motion.hitCeiling;
+	}
 }
 
 
 btQuaternion Physics::QuatFromDX(XMVECTOR quat)
 {
 	btQuaternion val;
-	val.setX(quat.m128_f32[0]);
-	val.setY(quat.m128_f32[1]);
-	val.setZ(quat.m128_f32[2]);
-	val.setW(quat.m128_f32[3]);
+	val.setX(XMVectorGetX(quat));
+	val.setY(XMVectorGetY(quat));
+	val.setZ(XMVectorGetZ(quat));
+	val.setW(XMVectorGetW(quat));
 
 	return val;
 }
@@ -323,10 +886,10 @@ XMVECTOR Physics::QuatToDX(btQuaternion quat)
 btVector3 Physics::VecFromDX(XMVECTOR vec)
 {
 	btVector3 val;
-	val.setX(vec.m128_f32[0]);
-	val.setY(vec.m128_f32[1]);
-	val.setZ(vec.m128_f32[2]);
-	val.setW(vec.m128_f32[3]);
+	val.setX(XMVectorGetX(vec));
+	val.setY(XMVectorGetY(vec));
+	val.setZ(XMVectorGetZ(vec));
+	val.setW(XMVectorGetW(vec));
 	return val;
 }
 
@@ -358,31 +921,300 @@ XMMATRIX Physics::MatToDX(btTransform mat)
 
 void Physics::SimulationCallback(btDynamicsWorld* world, btScalar timeStep)
 {
+	if (m_collisionListeners.empty() && m_contactPairs.empty())
+	{
+		return;
+	}
+
+	m_contactFrame++;
+
 	int numManifolds = world->getDispatcher()->getNumManifolds();
 	for (int i = 0; i < numManifolds; i++)
 	{
 		btPersistentManifold* contactManifold = world->getDispatcher()->getManifoldByIndexInternal(i);
 
-		// Get first rigid body
-		const btCollisionObject* obA = contactManifold->getBody0();
-		const btRigidBody* crbA = static_cast<const btRigidBody*>(obA);
-		btRigidBody* rbA = const_cast<btRigidBody*>(crbA);
-		RigidBody rigidBodyA = RigidBody(rbA);
+		// manifolds without points only have overlapping bounding boxes
+		int numContacts = contactManifold->getNumContacts();
+		if (numContacts == 0)
+		{
+			continue;
+		}
 
-		// Get second rigid body
+		const btCollisionObject* obA = contactManifold->getBody0();
 		const btCollisionObject* obB = contactManifold->getBody1();
-		const btRigidBody* crbB = static_cast<const btRigidBody*>(obB);
-		btRigidBody* rbB = const_cast<btRigidBody*>(crbB);
-		RigidBody rigidBodyB = RigidBody(rbB);
 
-		int numContacts = contactManifold->getNumContacts();
-		std::vector<btManifoldPoint> points;
-		for (int j = 0; j < numContacts; j++)
+		if (!obA->getUserPointer() && !obB->getUserPointer())
+		{
+			// the manifold stores its points contiguously, so listeners read them in place
+			ReportContact(obA, obB, numContacts, &contactManifold->getContactPoint(0));
+			continue;
+		}
+
+		// baked geometry shares one manifold between its children, so the points are grouped per child
+		// and copied, each group is reported against the body the child was baked from
+		btManifoldPoint points[MANIFOLD_CACHE_SIZE];
+		bool reported[MANIFOLD_CACHE_SIZE] = {};
+		for (int first = 0; first < numContacts; ++first)
+		{
+			if (reported[first])
+			{
+				continue;
+			}
+
+			const btManifoldPoint& firstPoint = contactManifold->getContactPoint(first);
+			U32 numPoints = 0;
+			for (int j = first; j < numContacts; ++j)
+			{
+				const btManifoldPoint& point = contactManifold->getContactPoint(j);
+				if (point.m_index0 == firstPoint.m_index0 && point.m_index1 == firstPoint.m_index1)
+				{
+					points[numPoints++] = point;
+					reported[j] = true;
+				}
+			}
+
+			ReportContact(ResolveBakedBody(obA, firstPoint.m_index0), ResolveBakedBody(obB, firstPoint.m_index1), numPoints, points);
+		}
+	}
+
+	UpdateTriggers();
+
+	// pairs that were not refreshed this frame have separated. they are collected first since a listener can
+	// destroy a body, which erases that body's pairs from the cache
+	m_endedPairs.clear();
+	for (auto itr = m_contactPairs.begin(); itr != m_contactPairs.end();)
+	{
+		if (itr->second == m_contactFrame)
+		{
+			++itr;
+			continue;
+		}
+
+		m_endedPairs.push_back(itr->first);
+		itr = m_contactPairs.erase(itr);
+	}
+
+	for (size_t i = 0; i < m_endedPairs.size(); ++i)
+	{
+		// cleared by DestroyRigidBody if a listener destroyed one of the bodies
+		if (!m_endedPairs[i].bodyA)
+		{
+			continue;
+		}
+
+		RigidBody rigidBodyA = RigidBody(const_cast<btCollisionObject*>(m_endedPairs[i].bodyA));
+		RigidBody rigidBodyB = RigidBody(const_cast<btCollisionObject*>(m_endedPairs[i].bodyB));
+
+		ListenerList* listeners = FindCollisionListeners(rigidBodyA.GetEntity());
+		if (listeners)
+		{
+			CollisionInfo info(rigidBodyA, rigidBodyB, -1, CONTACT_END, 0, nullptr);
+			DispatchCollision(*listeners, &info);
+		}
+
+		if (!m_endedPairs[i].bodyB)
+		{
+			continue;
+		}
+
+		listeners = FindCollisionListeners(rigidBodyB.GetEntity());
+		if (listeners)
+		{
+			CollisionInfo info(rigidBodyB, rigidBodyA, 1, CONTACT_END, 0, nullptr);
+			DispatchCollision(*listeners, &info);
+		}
+	}
+	m_endedPairs.clear();
+}
+
+
+void Physics::UpdateTriggers()
+{
+	for (btPairCachingGhostObject* ghost : m_triggers)
+	{
+		// the ghost's pair cache mirrors the broadphase pairs it's part of, already filtered by layer
+		btBroadphasePairArray& pairs = ghost->getOverlappingPairCache()->getOverlappingPairArray();
+		for (int i = 0; i < pairs.size(); ++i)
+		{
+			const btCollisionObject* obj0 = static_cast<const btCollisionObject*>(pairs[i].m_pProxy0->m_clientObject);
+			const btCollisionObject* obj1 = static_cast<const btCollisionObject*>(pairs[i].m_pProxy1->m_clientObject);
+			const btCollisionObject* other = obj0 == ghost ? obj1 : obj0;
+
+			// overlapping bounds are refined so rotated volumes and spheres aren't triggered early
+			if (ObjectsOverlap(ghost, other))
+			{
+				ReportContact(ghost, other, 0, nullptr);
+			}
+		}
+	}
+}
+
+
+void Physics::ReportContact(const btCollisionObject* obA, const btCollisionObject* obB, U32 numPoints, const btManifoldPoint* points)
+{
+	// Get first rigid body
+	RigidBody rigidBodyA = RigidBody(const_cast<btCollisionObject*>(obA));
+
+	// Get second rigid body
+	RigidBody rigidBodyB = RigidBody(const_cast<btCollisionObject*>(obB));
+
+	// skip contacts that no listener is interested in
+	ListenerList* listenersA = FindCollisionListeners(rigidBodyA.GetEntity());
+	ListenerList* listenersB = FindCollisionListeners(rigidBodyB.GetEntity());
+	if (!listenersA && !listenersB)
+	{
+		return;
+	}
+
+	// pairs already in the cache, from a previous frame or another manifold this frame, are staying in contact
+	ContactType type = CONTACT_STAY;
+	auto pair = m_contactPairs.find(ContactPairKey(obA, obB));
+	if (pair == m_contactPairs.end())
+	{
+		m_contactPairs.emplace(ContactPairKey(obA, obB), m_contactFrame);
+		type = CONTACT_BEGIN;
+	}
+	else
+	{
+		pair->second = m_contactFrame;
+	}
+
+	if (listenersA)
+	{
+		CollisionInfo info(rigidBodyA, rigidBodyB, -1, type, numPoints, points);
+		DispatchCollision(*listenersA, &info);
+	}
+
+	if (listenersB)
+	{
+		CollisionInfo info(rigidBodyB, rigidBodyA, 1, type, numPoints, points);
+		DispatchCollision(*listenersB, &info);
+	}
+}
+
+
+void Physics::AddToWorld(btCollisionObject* obj, CollisionLayer layer)
+{
+	// the broadphase only creates pairs whose groups pass both masks
+	btRigidBody* body = btRigidBody::upcast(obj);
+	if (body)
+	{
+		m_dynamicsWorld->addRigidBody(body, LayerMask(layer), m_layerMasks[layer]);
+	}
+	else
+	{
+		m_dynamicsWorld->addCollisionObject(obj, LayerMask(layer), m_layerMasks[layer]);
+	}
+
+	// the body keeps its shape alive until it's destroyed
+	ASSERT_VERBOSE(IsCachedShape(obj->getCollisionShape()), "Body made with a ColliderPtr whose shape was freed with its last body");
+	ShapeCache::value_type* cached = static_cast<ShapeCache::value_type*>(obj->getCollisionShape()->getUserPointer());
+	cached->second.numBodies++;
+}
+
+
+bool Physics::UnbakeBody(btRigidBody* body)
+{
+	for (BakedGeometry* baked : m_bakedGeometry)
+	{
+		for (size_t i = 0; i < baked->children.size(); ++i)
+		{
+			if (baked->children[i] != body)
+			{
+				continue;
+			}
+
+			// the compound moves its last child into the hole, mirror that so indices keep matching
+			baked->shape->removeChildShapeByIndex((int)i);
+			baked->children[i] = baked->children.back();
+			baked->children.pop_back();
+			m_dynamicsWorld->updateSingleAabb(baked->body);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+btCollisionShape* Physics::FindShape(const ShapeKey& key)
+{
+	auto itr = m_shapeCache.find(key);
+	if (itr == m_shapeCache.end())
+	{
+		return nullptr;
+	}
+
+	return itr->second.shape;
+}
+
+
+btCollisionShape* Physics::CacheShape(const ShapeKey& key, btCollisionShape* shape)
+{
+	shape->setLocalScaling(btVector3(key.scale[0], key.scale[1], key.scale[2]));
+
+	// map nodes don't move, so the shape can point at its entry for refcounting
+	auto result = m_shapeCache.emplace(key, CachedShape{ shape, 0 });
+	shape->setUserPointer(&*result.first);
+
+	return shape;
+}
+
+
+void Physics::ReleaseShape(btCollisionShape* shape)
+{
+	ShapeCache::value_type* cached = static_cast<ShapeCache::value_type*>(shape->getUserPointer());
+	ASSERT(cached->second.numBodies > 0);
+
+	// free the shape with its last body
+	if (--cached->second.numBodies == 0)
+	{
+		ShapeKey key = cached->first;
+		delete shape;
+		m_shapeCache.erase(key);
+	}
+}
+
+
+// linear, only used by asserts
+bool Physics::IsCachedShape(const btCollisionShape* shape) const
+{
+	for (const auto& cached : m_shapeCache)
+	{
+		if (cached.second.shape == shape)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+Physics::ListenerList* Physics::FindCollisionListeners(Entity e)
+{
+	auto itr = m_collisionListeners.find(e.id);
+	if (itr == m_collisionListeners.end())
+	{
+		return nullptr;
+	}
+
+	return &itr->second;
+}
+
+
+void Physics::DispatchCollision(ListenerList& listeners, CollisionInfo* info)
+{
+	// listeners are only removed when components are destroyed at the end of the frame,
+	// but new ones may be added during the callback so the list is walked by index
+	for (size_t i = 0; i < listeners.size(); ++i)
+	{
+		if (info->type == CONTACT_STAY && !listeners[i].receiveStay)
 		{
-			btManifoldPoint& pt = contactManifold->getContactPoint(j);
-			points.push_back(pt);
+			continue;
 		}
 
-		m_eventBus->Publish(&CollisionEvent(rigidBodyA, rigidBodyB, numContacts, points));
+		listeners[i].listener->OnCollision(info);
 	}
 }
\ No newline at end of file
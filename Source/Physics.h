@@ -3,38 +3,165 @@
 #include "btBulletDynamicsCommon.h"
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 #include <BulletDynamics/Character/btKinematicCharacterController.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <LinearMath/btThreads.h>
 #include "WriteLog.h"
 #include "Entity.h"
 #include "RigidBody.h"
 #include "EventBus.h"
 #include "ColliderPtr.h"
+#include "CollisionListener.h"
+#include "CollisionLayer.h"
+#include "ObjectPool.h"
+#include "MotionState.h"
+#include "CharacterMotion.h"
+#include "PhysicsProfiler.h"
 #include <DirectXMath.h>
+#include <unordered_map>
+#include <vector>
 using namespace DirectX;
 
+struct PhysicsConfig
+{
+	// runs narrowphase, island solving and integration on bullet's task scheduler
+	bool multithreaded = false;
+
+	// worker threads including the main thread, 0 uses every hardware thread
+	U32 numThreads = 0;
+
+	// rigid bodies and motion states kept in fixed pools, extra bodies go to the heap
+	U32 maxPooledBodies = 1024;
+};
+
+struct Ray
+{
+	XMVECTOR start;
+	XMVECTOR end;
+};
+
+// closest hit of a ray or a shape sweep
+struct RayHit
+{
+	RigidBody body;
+	XMVECTOR point;
+	XMVECTOR normal;
+	float fraction;
+	bool hit;
+};
+
+struct SphereOverlap
+{
+	XMVECTOR center;
+	float radius;
+};
+
+struct BoxOverlap
+{
+	XMVECTOR center;
+	XMVECTOR halfExtents;
+	XMVECTOR rotation;
+};
+
+// convex shape moved from start to end without turning
+struct ShapeSweep
+{
+	ColliderPtr shape;
+	XMVECTOR rotation;
+	XMVECTOR start;
+	XMVECTOR end;
+};
+
+// one character's move for Physics::MoveCharacters, the body's own convex shape is swept through the world
+struct CharacterMove
+{
+	RigidBody body;
+	XMVECTOR position;		// in: current position, out: where the character ended up
+	XMVECTOR displacement;	// requested move for this frame
+	XMVECTOR groundNormal;	// out: normal of the ground stood on
+	float stepHeight;		// tallest ledge walked up without jumping
+	float maxSlopeAngle;	// in radians, steeper surfaces are treated as walls
+	bool grounded;			// in: grounded last frame, out: standing on walkable ground
+	bool hitCeiling;		// out: an upward move was blocked
+};
+
 class Physics
 {
 public:
 	~Physics();
-	bool StartUp(EventBus* eventBus);
+	bool StartUp(EventBus* eventBus, const PhysicsConfig& config = PhysicsConfig());
 	void ShutDown();
 	void RunSimulation(float deltaTime);
 	void SetGravity(float gravity);
 
-	ColliderPtr CreateCollisionBox(float x, float y, float z);
-	ColliderPtr CreateCollisionSphere(float radius);
-	ColliderPtr CreateCollisionCylinder(float x, float y, float z);
-	ColliderPtr CreateCollisionCone(float radius, float height);
-	ColliderPtr CreateCollisionCapsule(float radius, float height);
+	// shapes are cached by type, dimensions and scale, bodies of the same size share one shape.
+	// only bodies hold a shape, a ColliderPtr doesn't: a shape no body was made with stays cached until ShutDown,
+	// and a ColliderPtr must not be used to make a body after the last body of its shape is destroyed
+	ColliderPtr CreateCollisionBox(float x, float y, float z, XMVECTOR scale = XMVectorSet(1.f, 1.f, 1.f, 0.f));
+	ColliderPtr CreateCollisionSphere(float radius, XMVECTOR scale = XMVectorSet(1.f, 1.f, 1.f, 0.f));
+	ColliderPtr CreateCollisionCylinder(float x, float y, float z, XMVECTOR scale = XMVectorSet(1.f, 1.f, 1.f, 0.f));
+	ColliderPtr CreateCollisionCone(float radius, float height, XMVECTOR scale = XMVectorSet(1.f, 1.f, 1.f, 0.f));
+	ColliderPtr CreateCollisionCapsule(float radius, float height, XMVECTOR scale = XMVectorSet(1.f, 1.f, 1.f, 0.f));
+
+	RigidBody CreateDynamicRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, float mass = 1.f, CollisionLayer layer = LAYER_DYNAMIC);
+	RigidBody CreateStaticRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, bool isTrigger = false, CollisionLayer layer = LAYER_STATIC);
+	RigidBody CreateKinematicRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, bool isTrigger = false, CollisionLayer layer = LAYER_KINEMATIC);
+	RigidBody CreateCharacterBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, CollisionLayer layer = LAYER_CHARACTER);
 
-	RigidBody CreateDynamicRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, float mass = 1.f);
-	RigidBody CreateStaticRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, bool isTrigger = false);
-	RigidBody CreateKinematicRigidBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, bool isTrigger = false);
-	RigidBody CreateCharacterBody(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation);
+	// ghost volume that never creates contact manifolds, bodies entering and leaving it are reported
+	// to collision listeners as contact begin and end without contact points, it may be moved like a kinematic body
+	RigidBody CreateTrigger(Entity e, ColliderPtr shape, XMVECTOR position, XMVECTOR rotation, CollisionLayer layer = LAYER_TRIGGER);
 
 	void DestroyRigidBody(RigidBody body);
 
-	btCollisionWorld::ClosestRayResultCallback RayCast(XMVECTOR start, XMVECTOR end);
-	btCollisionWorld::AllHitsRayResultCallback RayCastAll(XMVECTOR startPos, XMVECTOR endPos);
+	// merges every static non-trigger body on the static layer into one compound body to cut broadphase proxies,
+	// collisions and ray hits on the compound still report the original bodies, returns the number merged
+	U32 BakeStaticGeometry();
+
+	// layer pairs are symmetric, bodies already in the world keep the filter they were added with
+	void SetLayerCollision(CollisionLayer a, CollisionLayer b, bool collide);
+	bool GetLayerCollision(CollisionLayer a, CollisionLayer b) const;
+
+	// layers the layer collides with, the filter mask for bodies added to the world directly
+	int GetCollisionMask(CollisionLayer layer) const;
+
+	// bullet's world, for tools that build bodies themselves like the physics benchmark
+	btDiscreteDynamicsWorld* GetDynamicsWorld() const;
+	bool IsMultithreaded() const;
+
+	U32 GetNumOverlappingPairs() const;
+	U32 GetNumContactManifolds() const;
+
+	// phase timings and counts from the last RunSimulation, zeroed until the first step
+	const PhysicsStepStats& GetStepStats() const;
+
+	// collisions involving the entity are delivered to the listener, contact stay only if requested
+	void AddCollisionListener(Entity e, CollisionListener* listener, bool receiveStay = false);
+	void RemoveCollisionListener(Entity e, CollisionListener* listener);
+
+	bool RayCast(const Ray& ray, RayHit& hit, int layerMask = ALL_LAYERS, bool includeTriggers = false);
+
+	// closest hit of every ray is written to the caller's hits array, large batches are split across the physics threads
+	void RayCastBatch(const Ray* rays, RayHit* hits, U32 count, int layerMask = ALL_LAYERS, bool includeTriggers = false);
+
+	// entities whose shapes overlap the volume are written to the caller's array, returns how many were found up to maxEntities,
+	// bodies baked into static geometry are reported as themselves
+	U32 OverlapSphere(XMVECTOR center, float radius, Entity* entities, U32 maxEntities, int layerMask = ALL_LAYERS, bool includeTriggers = false);
+	U32 OverlapBox(XMVECTOR center, XMVECTOR halfExtents, XMVECTOR rotation, Entity* entities, U32 maxEntities, int layerMask = ALL_LAYERS, bool includeTriggers = false);
+
+	// query i writes up to maxEntitiesPerQuery entities starting at entities[i * maxEntitiesPerQuery] and its count to numEntities[i]
+	void OverlapSphereBatch(const SphereOverlap* queries, U32 count, Entity* entities, U32 maxEntitiesPerQuery, U32* numEntities,
+							int layerMask = ALL_LAYERS, bool includeTriggers = false);
+	void OverlapBoxBatch(const BoxOverlap* queries, U32 count, Entity* entities, U32 maxEntitiesPerQuery, U32* numEntities,
+						 int layerMask = ALL_LAYERS, bool includeTriggers = false);
+
+	// first hit of a convex shape moved along the sweep, the ignored body is skipped so a body can sweep its own shape
+	bool SweepConvex(const ShapeSweep& sweep, RayHit& hit, int layerMask = ALL_LAYERS, bool includeTriggers = false, const RigidBody* ignore = nullptr);
+	void SweepConvexBatch(const ShapeSweep* sweeps, RayHit* hits, U32 count, int layerMask = ALL_LAYERS, bool includeTriggers = false, const RigidBody* ignore = nullptr);
+
+	// moves characters with convex sweeps, each one steps up ledges, slides along walls and snaps down onto walkable
+	// ground in a bounded number of sweeps, characters are independent so large batches are split across the physics threads
+	void MoveCharacters(CharacterMove* moves, U32 count, int layerMask = ALL_LAYERS);
 
 	static btQuaternion QuatFromDX(XMVECTOR quat);
 	static XMVECTOR QuatToDX(btQuaternion quat);
@@ -44,14 +171,138 @@ public:
 	static XMMATRIX MatToDX(btTransform mat);
 
 private:
+	struct CollisionRoute
+	{
+		CollisionListener* listener;
+		bool receiveStay;
+	};
+
+	typedef std::vector<CollisionRoute> ListenerList;
+
+	// body pair ordered by address so both manifold orders map to the same entry
+	struct ContactPairKey
+	{
+		const btCollisionObject* bodyA;
+		const btCollisionObject* bodyB;
+
+		ContactPairKey(const btCollisionObject* a, const btCollisionObject* b) : bodyA{ a < b ? a : b }, bodyB{ a < b ? b : a } {}
+
+		bool operator==(const ContactPairKey& other) const
+		{
+			return bodyA == other.bodyA && bodyB == other.bodyB;
+		}
+	};
+
+	struct ContactPairKeyHash
+	{
+		size_t operator()(const ContactPairKey& key) const
+		{
+			size_t hash = std::hash<const void*>()(key.bodyA);
+			return hash ^ (std::hash<const void*>()(key.bodyB) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+		}
+	};
+
+	struct ShapeKey
+	{
+		int type;
+		float dims[3];
+		float scale[3];
+
+		ShapeKey(int shapeType, float x, float y, float z, XMVECTOR localScale) : type{ shapeType }, dims{ PositiveZero(x), PositiveZero(y), PositiveZero(z) }
+		{
+			btVector3 s = VecFromDX(localScale);
+			scale[0] = PositiveZero(s.getX());
+			scale[1] = PositiveZero(s.getY());
+			scale[2] = PositiveZero(s.getZ());
+		}
+
+		// -0 compares equal to 0 but has other bytes, the hash reads bytes so keys only hold the positive one
+		static float PositiveZero(float value)
+		{
+			return value == 0.f ? 0.f : value;
+		}
+
+		bool operator==(const ShapeKey& other) const
+		{
+			return type == other.type &&
+				dims[0] == other.dims[0] && dims[1] == other.dims[1] && dims[2] == other.dims[2] &&
+				scale[0] == other.scale[0] && scale[1] == other.scale[1] && scale[2] == other.scale[2];
+		}
+	};
+
+	struct ShapeKeyHash
+	{
+		size_t operator()(const ShapeKey& key) const
+		{
+			// fnv-1a over the key's fields
+			const U8* bytes = reinterpret_cast<const U8*>(&key);
+			size_t hash = 2166136261u;
+			for (size_t i = 0; i < sizeof(ShapeKey); ++i)
+			{
+				hash = (hash ^ bytes[i]) * 16777619u;
+			}
+			return hash;
+		}
+	};
+
+	struct CachedShape
+	{
+		btCollisionShape* shape;
+		U32 numBodies;
+	};
+
+	typedef std::unordered_map<ShapeKey, CachedShape, ShapeKeyHash> ShapeCache;
+
+	btCollisionShape* FindShape(const ShapeKey& key);
+	btCollisionShape* CacheShape(const ShapeKey& key, btCollisionShape* shape);
+	void ReleaseShape(btCollisionShape* shape);
+	bool IsCachedShape(const btCollisionShape* shape) const;
+
 	void SimulationCallback(btDynamicsWorld* world, btScalar timeStep);
+	void UpdateTriggers();
+	void ReportContact(const btCollisionObject* obA, const btCollisionObject* obB, U32 numPoints, const btManifoldPoint* points);
+	bool UnbakeBody(btRigidBody* body);
+	void AddToWorld(btCollisionObject* obj, CollisionLayer layer);
+	ListenerList* FindCollisionListeners(Entity e);
+	void DispatchCollision(ListenerList& listeners, CollisionInfo* info);
 
 private:
 	btDefaultCollisionConfiguration* m_collisionConfiguration;
 	btCollisionDispatcher* m_dispatcher;
 	btBroadphaseInterface* m_overlappingPairCache;
-	btSequentialImpulseConstraintSolver* m_solver;
+	btConstraintSolver* m_solver;
 	btDiscreteDynamicsWorld* m_dynamicsWorld;
+	btITaskScheduler* m_taskScheduler = nullptr;
+
+	std::vector<BakedGeometry*> m_bakedGeometry;
+
+	// trigger volumes, their overlaps are read straight from the broadphase each step
+	std::vector<btPairCachingGhostObject*> m_triggers;
+	btGhostPairCallback* m_ghostPairCallback = nullptr;
+
+	ObjectPool<btRigidBody> m_bodyPool;
+	ObjectPool<MotionState> m_motionStatePool;
+
+	// reused by MoveCharacters, bullet's array keeps the vectors aligned
+	btAlignedObjectArray<CharacterMotion> m_characterMotions;
+	CharacterMotionSettings m_characterSettings;
+
+	// shapes in use, each one points back to its cache entry through its user pointer
+	ShapeCache m_shapeCache;
+
+	PhysicsStepStats m_stepStats;
+
+	// per layer, the mask of layers it collides with
+	int m_layerMasks[NUM_COLLISION_LAYERS];
 	float m_gravity;
 	EventBus* m_eventBus;
+
+	// routing table from entity id to the listeners that own a component on it
+	std::unordered_map<U64, ListenerList> m_collisionListeners;
+
+	// touching body pairs and the frame they were last seen in contact
+	std::unordered_map<ContactPairKey, U32, ContactPairKeyHash> m_contactPairs;
+	// pairs that separated this frame, reported once the scan of m_contactPairs is done
+	std::vector<ContactPairKey> m_endedPairs;
+	U32 m_contactFrame = 0;
 };
\ No newline at end of file
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "btBulletDynamicsCommon.h"
+#include <LinearMath/btQuickprof.h>
+#include "Types.h"
+#include <chrono>
+#include <string.h>
+
+// Times the phases of a physics step from the profile zones bullet already opens, BT_PROFILE calls the
+// zone functions even without BT_ENABLE_PROFILE so no bullet rebuild is needed.
+// Kept free of engine types like PhysicsQueries.h so the benchmark reports the same numbers as Physics.
+
+
+enum PhysicsPhase
+{
+	PHYSICS_PHASE_BROADPHASE,		// aabb updates and pair finding
+	PHYSICS_PHASE_NARROWPHASE,		// contact generation, including predictive contacts
+	PHYSICS_PHASE_SOLVER,			// island building and constraint solving
+	PHYSICS_PHASE_INTEGRATION,		// velocity prediction, integration and sleeping
+	PHYSICS_PHASE_CALLBACKS,		// contact reports and trigger updates after the step
+	PHYSICS_PHASE_OTHER,			// the rest of the step, motion states and actions
+	NUM_PHYSICS_PHASES
+};
+
+
+// zone opened around the engine's own work after the step so it lands in PHYSICS_PHASE_CALLBACKS
+#define PHYSICS_CALLBACKS_ZONE "physicsCallbacks"
+
+
+struct PhysicsStepStats
+{
+	float totalMs = 0;
+	float phaseMs[NUM_PHYSICS_PHASES] = {};
+	U32 numSubsteps = 0;
+	U32 numActiveBodies = 0;		// awake bodies that aren't static
+	U32 numOverlappingPairs = 0;
+	U32 numManifolds = 0;			// manifolds with at least one contact
+	U32 numContacts = 0;
+	U32 numIslands = 0;				// built in the last substep, sleeping ones included
+};
+
+
+inline const char* PhysicsPhaseName(PhysicsPhase phase)
+{
+	static const char* names[NUM_PHYSICS_PHASES] = { "broadphase", "narrowphase", "solver", "integration", "callbacks", "other" };
+	return names[phase];
+}
+
+
+// bullet zones that start a phase, zones nested inside one are part of it
+inline int PhysicsPhaseFromZone(const char* name)
+{
+	static const struct { const char* zone; PhysicsPhase phase; } zones[] =
+	{
+		{ "updateAabbs", PHYSICS_PHASE_BROADPHASE },
+		{ "calculateOverlappingPairs", PHYSICS_PHASE_BROADPHASE },
+		{ "dispatchAllCollisionPairs", PHYSICS_PHASE_NARROWPHASE },
+		{ "createPredictiveContacts", PHYSICS_PHASE_NARROWPHASE },
+		{ "calculateSimulationIslands", PHYSICS_PHASE_SOLVER },
+		{ "solveConstraints", PHYSICS_PHASE_SOLVER },
+		{ "predictUnconstraintMotion", PHYSICS_PHASE_INTEGRATION },
+		{ "integrateTransforms", PHYSICS_PHASE_INTEGRATION },
+		{ "updateActivationState", PHYSICS_PHASE_INTEGRATION },
+		{ PHYSICS_CALLBACKS_ZONE, PHYSICS_PHASE_CALLBACKS },
+	};
+
+	for (const auto& entry : zones)
+	{
+		if (strcmp(name, entry.zone) == 0)
+		{
+			return entry.phase;
+		}
+	}
+	return -1;
+}
+
+
+// zones are only recorded on the thread running the step, queries and worker threads pass straight through
+struct StepProfile
+{
+	typedef std::chrono::steady_clock Clock;
+
+	bool recording = false;
+	int depth = 0;
+	int phaseDepth = 0;				// depth of the open phase zone, 0 when none is open
+	int phase = 0;
+	Clock::time_point phaseStart;
+	Clock::time_point stepStart;
+	double phaseMs[NUM_PHYSICS_PHASES] = {};
+	U32 numSubsteps = 0;
+
+	static StepProfile& Get()
+	{
+		static thread_local StepProfile profile;
+		return profile;
+	}
+
+	static void EnterZone(const char* name)
+	{
+		StepProfile& profile = Get();
+		if (!profile.recording)
+		{
+			return;
+		}
+
+		profile.depth++;
+		if (profile.phaseDepth == 0)
+		{
+			int phase = PhysicsPhaseFromZone(name);
+			if (phase >= 0)
+			{
+				profile.phase = phase;
+				profile.phaseDepth = profile.depth;
+				profile.phaseStart = Clock::now();
+			}
+			else if (strcmp(name, "internalSingleStepSimulation") == 0)
+			{
+				profile.numSubsteps++;
+			}
+		}
+	}
+
+	static void LeaveZone()
+	{
+		StepProfile& profile = Get();
+		if (!profile.recording)
+		{
+			return;
+		}
+
+		if (profile.phaseDepth == profile.depth)
+		{
+			profile.phaseMs[profile.phase] += std::chrono::duration<double, std::milli>(Clock::now() - profile.phaseStart).count();
+			profile.phaseDepth = 0;
+		}
+		profile.depth--;
+	}
+};
+
+
+// points bullet's profile zones at the step profile, done once before stepping
+inline void InstallStepProfiler()
+{
+	btSetCustomEnterProfileZoneFunc(StepProfile::EnterZone);
+	btSetCustomLeaveProfileZoneFunc(StepProfile::LeaveZone);
+}
+
+
+inline void BeginStepProfile()
+{
+	StepProfile& profile = StepProfile::Get();
+	profile = StepProfile();
+	profile.recording = true;
+	profile.stepStart = StepProfile::Clock::now();
+}
+
+
+// stops recording and fills in the timings, time outside the known zones goes to PHYSICS_PHASE_OTHER
+inline void EndStepProfile(PhysicsStepStats& stats)
+{
+	StepProfile& profile = StepProfile::Get();
+	profile.recording = false;
+
+	stats.totalMs = (float)std::chrono::duration<double, std::milli>(StepProfile::Clock::now() - profile.stepStart).count();
+	stats.numSubsteps = profile.numSubsteps;
+
+	float phasesMs = 0;
+	for (int i = 0; i < PHYSICS_PHASE_OTHER; ++i)
+	{
+		stats.phaseMs[i] = (float)profile.phaseMs[i];
+		phasesMs += stats.phaseMs[i];
+	}
+	stats.phaseMs[PHYSICS_PHASE_OTHER] = btMax(stats.totalMs - phasesMs, 0.f);
+}
+
+
+// counts what the last step worked on, reading the world after the step has finished
+inline void CountStepStats(btDiscreteDynamicsWorld* world, PhysicsStepStats& stats)
+{
+	stats.numActiveBodies = 0;
+	const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+	for (int i = 0; i < objects.size(); ++i)
+	{
+		if (!objects[i]->isStaticObject() && objects[i]->isActive())
+		{
+			stats.numActiveBodies++;
+		}
+	}
+
+	stats.numOverlappingPairs = world->getBroadphase()->getOverlappingPairCache()->getNumOverlappingPairs();
+
+	stats.numManifolds = 0;
+	stats.numContacts = 0;
+	btDispatcher* dispatcher = world->getDispatcher();
+	for (int i = 0; i < dispatcher->getNumManifolds(); ++i)
+	{
+		int numContacts = dispatcher->getManifoldByIndexInternal(i)->getNumContacts();
+		stats.numManifolds += numContacts > 0 ? 1 : 0;
+		stats.numContacts += numContacts;
+	}
+
+	// the union find is left sorted by island after the islands are built
+	stats.numIslands = 0;
+	btUnionFind& unionFind = world->getSimulationIslandManager()->getUnionFind();
+	for (int i = 0; i < unionFind.getNumElements(); ++i)
+	{
+		if (i == 0 || unionFind.getElement(i).m_id != unionFind.getElement(i - 1).m_id)
+		{
+			stats.numIslands++;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "btBulletDynamicsCommon.h"
+#include <BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btPointCollector.h>
+#include "Types.h"
+#include "Entity.h"
+#include "CollisionLayer.h"
+#include <vector>
+
+// Bullet side of the physics queries, kept free of engine math types so tools can run the same code as Physics.
+// Nothing here writes to the world, so queries may run on several threads at once.
+
+
+// static bodies merged into one compound, the compound body points here through its user pointer
+struct BakedGeometry
+{
+	btRigidBody* body;
+	btCompoundShape* shape;
+	std::vector<btRigidBody*> children;	// same order as the compound's child shapes
+};
+
+
+// maps a compound child back to the body it was baked from, other objects are returned as they are
+inline const btCollisionObject* ResolveBakedBody(const btCollisionObject* obj, int childIndex)
+{
+	const BakedGeometry* baked = static_cast<const BakedGeometry*>(obj->getUserPointer());
+	if (baked && childIndex >= 0 && childIndex < (int)baked->children.size())
+	{
+		return baked->children[childIndex];
+	}
+
+	return obj;
+}
+
+
+inline Entity EntityFromObject(const btCollisionObject* obj)
+{
+	Entity e;
+	e.id = (U64)obj->getUserIndex2() << 32 | (U32)obj->getUserIndex();
+	return e;
+}
+
+
+inline bool IsTriggerObject(const btCollisionObject* obj)
+{
+	return (obj->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE) != 0;
+}
+
+
+// pairs with a trigger ghost are skipped before an algorithm or manifold is made for them,
+// the ghost reads its overlaps from the broadphase instead
+inline void TriggerNearCallback(btBroadphasePair& pair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo)
+{
+	const btCollisionObject* obj0 = static_cast<const btCollisionObject*>(pair.m_pProxy0->m_clientObject);
+	const btCollisionObject* obj1 = static_cast<const btCollisionObject*>(pair.m_pProxy1->m_clientObject);
+	if (obj0->getInternalType() == btCollisionObject::CO_GHOST_OBJECT || obj1->getInternalType() == btCollisionObject::CO_GHOST_OBJECT)
+	{
+		return;
+	}
+
+	btCollisionDispatcher::defaultNearCallback(pair, dispatcher, dispatchInfo);
+}
+
+
+// one off gjk query without a persistent manifold, touching counts as overlapping
+inline bool ConvexShapesOverlap(const btConvexShape* a, const btTransform& transformA, const btConvexShape* b, const btTransform& transformB)
+{
+	btVoronoiSimplexSolver simplexSolver;
+	btGjkEpaPenetrationDepthSolver penetrationSolver;
+	btGjkPairDetector detector(a, b, &simplexSolver, &penetrationSolver);
+
+	btGjkPairDetector::ClosestPointInput input;
+	input.m_transformA = transformA;
+	input.m_transformB = transformB;
+
+	btPointCollector result;
+	detector.getClosestPoints(input, result, nullptr);
+
+	return result.m_hasResult && result.m_distance <= btScalar(0);
+}
+
+
+// exact test for two objects whose bounding boxes overlap, shapes that aren't convex are taken at their bounds
+inline bool ObjectsOverlap(const btCollisionObject* a, const btCollisionObject* b)
+{
+	const btCollisionShape* shapeA = a->getCollisionShape();
+	const btCollisionShape* shapeB = b->getCollisionShape();
+	if (!shapeA->isConvex() || !shapeB->isConvex())
+	{
+		return true;
+	}
+
+	return ConvexShapesOverlap(static_cast<const btConvexShape*>(shapeA), a->getWorldTransform(),
+							   static_cast<const btConvexShape*>(shapeB), b->getWorldTransform());
+}
+
+
+// collects the entities overlapping a convex query shape, candidates come from the broadphase and are
+// confirmed with gjk, children of baked compounds are tested one by one and report the body they came from
+struct OverlapCollector : public btBroadphaseAabbCallback
+{
+	OverlapCollector(const btConvexShape* shape, const btTransform& transform, Entity* entities, U32 maxEntities, int layerMask, bool includeTriggers)
+		: m_shape{ shape }, m_transform{ transform }, m_entities{ entities }, m_maxEntities{ maxEntities },
+		  m_layerMask{ layerMask }, m_includeTriggers{ includeTriggers } {}
+
+	bool process(const btBroadphaseProxy* proxy) override
+	{
+		const btCollisionObject* obj = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+		if (m_numEntities == m_maxEntities || !(proxy->m_collisionFilterGroup & m_layerMask) ||
+			(!m_includeTriggers && IsTriggerObject(obj)))
+		{
+			return false;
+		}
+
+		const btCollisionShape* shape = obj->getCollisionShape();
+		if (shape->isCompound())
+		{
+			const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+			for (int i = 0; i < compound->getNumChildShapes() && m_numEntities < m_maxEntities; ++i)
+			{
+				const btCollisionShape* child = compound->getChildShape(i);
+				btTransform childTransform = obj->getWorldTransform() * compound->getChildTransform(i);
+				if (!child->isConvex() || ConvexShapesOverlap(m_shape, m_transform, static_cast<const btConvexShape*>(child), childTransform))
+				{
+					m_entities[m_numEntities++] = EntityFromObject(ResolveBakedBody(obj, i));
+				}
+			}
+		}
+		else if (!shape->isConvex() || ConvexShapesOverlap(m_shape, m_transform, static_cast<const btConvexShape*>(shape), obj->getWorldTransform()))
+		{
+			m_entities[m_numEntities++] = EntityFromObject(obj);
+		}
+
+		return true;
+	}
+
+	const btConvexShape* m_shape;
+	btTransform m_transform;
+	Entity* m_entities;
+	U32 m_maxEntities;
+	U32 m_numEntities = 0;
+	int m_layerMask;
+	bool m_includeTriggers;
+};
+
+
+// runs an overlap query against the world's broadphase and returns how many entities were written
+inline U32 QueryOverlap(btCollisionWorld* world, const btConvexShape* shape, const btTransform& transform,
+						Entity* entities, U32 maxEntities, int layerMask, bool includeTriggers)
+{
+	btVector3 aabbMin, aabbMax;
+	shape->getAabb(transform, aabbMin, aabbMax);
+
+	OverlapCollector collector(shape, transform, entities, maxEntities, layerMask, includeTriggers);
+	world->getBroadphase()->aabbTest(aabbMin, aabbMax, collector);
+
+	return collector.m_numEntities;
+}
+
+
+// closest ray hit that can also skip triggers, which collision filter groups alone can't express
+struct ClosestRayFilterCallback : public btCollisionWorld::ClosestRayResultCallback
+{
+	ClosestRayFilterCallback(const btVector3& start, const btVector3& end, int layerMask, bool includeTriggers)
+		: ClosestRayResultCallback(start, end), m_includeTriggers{ includeTriggers }
+	{
+		// the query belongs to every layer so only the mask decides what it hits
+		m_collisionFilterGroup = ALL_LAYERS;
+		m_collisionFilterMask = layerMask;
+	}
+
+	bool needsCollision(btBroadphaseProxy* proxy) const override
+	{
+		const btCollisionObject* obj = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+		if (!m_includeTriggers && IsTriggerObject(obj))
+		{
+			return false;
+		}
+
+		return ClosestRayResultCallback::needsCollision(proxy);
+	}
+
+	btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override
+	{
+		// compounds report which child was hit through the triangle index
+		m_childIndex = rayResult.m_localShapeInfo ? rayResult.m_localShapeInfo->m_triangleIndex : -1;
+		return ClosestRayResultCallback::addSingleResult(rayResult, normalInWorldSpace);
+	}
+
+	bool m_includeTriggers;
+	int m_childIndex = -1;
+};
+
+
+// closest hit of a swept convex shape, filtered like rays and able to ignore the body doing the sweep
+struct ClosestSweepFilterCallback : public btCollisionWorld::ClosestConvexResultCallback
+{
+	ClosestSweepFilterCallback(const btVector3& start, const btVector3& end, int layerMask, bool includeTriggers, const btCollisionObject* ignore)
+		: ClosestConvexResultCallback(start, end), m_includeTriggers{ includeTriggers }, m_ignore{ ignore }
+	{
+		m_collisionFilterGroup = ALL_LAYERS;
+		m_collisionFilterMask = layerMask;
+	}
+
+	bool needsCollision(btBroadphaseProxy* proxy) const override
+	{
+		const btCollisionObject* obj = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+		if (obj == m_ignore || (!m_includeTriggers && IsTriggerObject(obj)))
+		{
+			return false;
+		}
+
+		return ClosestConvexResultCallback::needsCollision(proxy);
+	}
+
+	btScalar addSingleResult(btCollisionWorld::LocalConvexResult& convexResult, bool normalInWorldSpace) override
+	{
+		m_childIndex = convexResult.m_localShapeInfo ? convexResult.m_localShapeInfo->m_triangleIndex : -1;
+		return ClosestConvexResultCallback::addSingleResult(convexResult, normalInWorldSpace);
+	}
+
+	bool m_includeTriggers;
+	const btCollisionObject* m_ignore;
+	int m_childIndex = -1;
+};
\ No newline at end of file
@@ -6,12 +6,14 @@
 class PixelShader : public Resource
 {
 public:
+	static const ResourceType TYPE = RESOURCE_PIXEL_SHADER;
+
 	~PixelShader()
 	{
 		ShutDown();
 	}
 
-	virtual void ShutDown() override
+	void ShutDown()
 	{
 		if (m_shader != nullptr)
 		{
@@ -24,19 +26,39 @@ public:
 	{
 		ID3DBlob* blob = nullptr;
 
-		blob = graphics.CreateShaderFromFile(fileName, "psmain", "ps_5_0");
+		blob = Compile(graphics, fileName);
 		if (!blob)
 		{
 			return false;
 		}
 
+		bool created = Create(graphics, blob);
+		blob->Release();
+
+		return created;
+	}
+
+	// compiling doesn't touch the device so it may run on a loader thread
+	static ID3DBlob* Compile(Graphics& graphics, const wchar_t* fileName)
+	{
+		return graphics.CreateShaderFromFile(fileName, "psmain", "ps_5_0");
+	}
+
+	static ID3DBlob* Compile(Graphics& graphics, const void* source, size_t size, const char* name, ID3DInclude* include)
+	{
+		return graphics.CreateShaderFromMemory(source, size, name, "psmain", "ps_5_0", include);
+	}
+
+	// the caller keeps ownership of the blob
+	bool Create(Graphics& graphics, ID3DBlob* blob)
+	{
 		m_shader = graphics.CreatePixelShader(blob);
 		if (!m_shader)
 		{
 			return false;
 		}
 
-		blob->Release();
+		AddMemorySize(blob->GetBufferSize());
 
 		return true;
 	}
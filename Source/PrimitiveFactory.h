@@ -20,7 +20,8 @@ enum PrimitiveShapes
 	PRIM_CUBE,
 	PRIM_SPHERE,
 	PRIM_CYLINDER,
-	PRIM_CONE
+	PRIM_CONE,
+	NUM_PRIMITIVE_SHAPES
 };
 
 class PrimitiveFactory
@@ -38,12 +39,18 @@ public:
 		m_yDespawnSystem = yd;
 		m_kinematicRigidBodySystem = krs;
 
+		// the names are resolved once, spawning only goes through the handles
+		m_models[PRIM_CUBE] = rm->FindResourceByStringId<Model>("Assets/cube.mesh"_sid);
+		m_models[PRIM_SPHERE] = rm->FindResourceByStringId<Model>("Assets/sphere.mesh"_sid);
+		m_models[PRIM_CYLINDER] = rm->FindResourceByStringId<Model>("Assets/cylinder.mesh"_sid);
+		m_models[PRIM_CONE] = rm->FindResourceByStringId<Model>("Assets/cone.mesh"_sid);
 
 		return true;
 	}
 
-	Entity CreatePrimitive(PrimitiveShapes shape, float mass, Material* mat, XMVECTOR pos, XMVECTOR rot = Vector3(0),
-		                   XMVECTOR scale = Vector3(1), XMVECTOR vel = Vector3(0), bool isKinematic = false)
+	Entity CreatePrimitive(PrimitiveShapes shape, float mass, Handle<Material> mat, XMVECTOR pos, XMVECTOR rot = Vector3(0),
+		                   XMVECTOR scale = Vector3(1), XMVECTOR vel = Vector3(0), bool isKinematic = false,
+		                   CollisionLayer dynamicLayer = LAYER_DYNAMIC)
 	{
 		Entity e;
 		U64 transformHandle;
@@ -51,25 +58,20 @@ public:
 		ColliderPtr collider;
 		U64 rbHandle;
 		RigidBody rb;
-		Model* model;
 
 		switch (shape)
 		{
 		case PRIM_CUBE:
-			model = static_cast<Model*>(m_resourceManager->FindResourceByStringId("Assets/cube.obj"_sid));
-			collider = m_physics->CreateCollisionBox(1, 1, 1);
+			collider = m_physics->CreateCollisionBox(1, 1, 1, scale);
 			break;
 		case PRIM_SPHERE:
-			model = static_cast<Model*>(m_resourceManager->FindResourceByStringId("Assets/sphere.obj"_sid));
-			collider = m_physics->CreateCollisionSphere(1);
+			collider = m_physics->CreateCollisionSphere(1, scale);
 			break;
 		case PRIM_CYLINDER:
-			model = static_cast<Model*>(m_resourceManager->FindResourceByStringId("Assets/cylinder.obj"_sid));
-			collider = m_physics->CreateCollisionCylinder(1, 1, 1);
+			collider = m_physics->CreateCollisionCylinder(1, 1, 1, scale);
 			break;
 		case PRIM_CONE:
-			model = static_cast<Model*>(m_resourceManager->FindResourceByStringId("Assets/cone.obj"_sid));
-			collider = m_physics->CreateCollisionCone(1, 2);
+			collider = m_physics->CreateCollisionCone(1, 2, scale);
 			break;
 		default:
 			break;
@@ -86,14 +88,11 @@ public:
 		// y despawn
 		m_yDespawnSystem->GetComponentByHandle(m_yDespawnSystem->CreateComponent(e, transformHandle, -50));
 		
-		// create collider
-		collider.SetScale(transform->scale);
-
 		// create rigid body
 		
 		if (mass > 0)
 		{
-			rb = m_physics->CreateDynamicRigidBody(e, collider, pos, rot);
+			rb = m_physics->CreateDynamicRigidBody(e, collider, pos, rot, 1.f, dynamicLayer);
 			rb.SetLinearVelocity(vel);
 			rbHandle = m_rigidBodySystem->CreateComponent(e, rb);
 			m_dynamicRigidBodySystem->CreateComponent(e, transformHandle, rbHandle);
@@ -112,7 +111,7 @@ public:
 		}
 		
 		// create mesh
-		m_meshSystem->GetComponentByHandle(m_meshSystem->CreateComponent(e, transformHandle, model, mat));
+		m_meshSystem->GetComponentByHandle(m_meshSystem->CreateComponent(e, transformHandle, m_models[shape], mat));
 
 		return e;
 	}
@@ -127,5 +126,6 @@ private:
 	RigidBodySystem* m_rigidBodySystem;
 	YDespawnSystem* m_yDespawnSystem;
 	KinematicRigidBodySystem* m_kinematicRigidBodySystem;
+	Handle<Model> m_models[NUM_PRIMITIVE_SHAPES];
 
 };
\ No newline at end of file
@@ -13,11 +13,11 @@ struct RBBulletComponent
 class RBBulletSystem : public ComponentSystem<RBBulletComponent>
 {
 public:
-	bool StartUp(U32 numComponents, EntityManager& em, EventBus& bus)
+	bool StartUp(U32 numComponents, EntityManager& em, Physics& physics)
 	{
 		Parent::StartUp(numComponents, em);
 
-		SubscribeToCollisionEvents(bus);
+		SubscribeToCollisionEvents(physics);
 
 		return true;
 	}
@@ -9,7 +9,7 @@
 struct RBGunComponent
 {
 	U64 transform = 0;
-	Material* material;
+	Handle<Material> material;
 	float cooldown = 0.33;
 };
 
@@ -31,7 +31,7 @@ public:
 		return true;
 	}
 
-	U64 CreateComponent(Entity e, U64 hTransform, Material* material, float cooldown)
+	U64 CreateComponent(Entity e, U64 hTransform, Handle<Material> material, float cooldown)
 	{
 		U64 handle = Parent::CreateComponent(e);
 		RBGunComponent* comp = GetComponentByHandle(handle);
@@ -78,7 +78,7 @@ public:
 
 			XMVECTOR velocity = forward * force;
 
-			Entity e = m_factory->CreatePrimitive(PRIM_SPHERE, 1, comp->material, position, Vector3(0), Vector3(1), velocity);
+			Entity e = m_factory->CreatePrimitive(PRIM_SPHERE, 1, comp->material, position, Vector3(0), Vector3(1), velocity, false, LAYER_PROJECTILE);
 
 			m_bulletSystem->CreateComponent(e);
 		}
@@ -1,15 +1,60 @@
 #pragma once
 
+#include <stddef.h>
+
+enum ResourceState
+{
+	RESOURCE_READY,
+	RESOURCE_LOADING,	// handed out by an async load that hasn't finished, device objects aren't created yet
+	RESOURCE_FAILED,
+	RESOURCE_UNLOADED	// the handle no longer resolves, its resource was evicted or destroyed
+};
+
+// every type has its own pool, memory budget and handles
+enum ResourceType
+{
+	RESOURCE_TEXTURE,
+	RESOURCE_MODEL,
+	RESOURCE_VERTEX_SHADER,
+	RESOURCE_PIXEL_SHADER,
+	RESOURCE_MATERIAL,
+	NUM_RESOURCE_TYPES
+};
+
+inline const char* ResourceTypeName(ResourceType type)
+{
+	static const char* names[NUM_RESOURCE_TYPES] = { "textures", "models", "vertex shaders", "pixel shaders", "materials" };
+	return names[type];
+}
+
+// state shared by every resource type, resources are stored by value in their type's pool so nothing here is virtual.
+// each type names itself with a static TYPE
 class Resource
 {
 public:
-	virtual bool StartUp()
+	inline ResourceState GetState() const
 	{
-		return true;
+		return m_state;
 	}
 
-	virtual void ShutDown()
+	inline void SetState(ResourceState state)
 	{
+		m_state = state;
+	}
+
+	// bytes of device memory the resource holds, what its type's budget is charged
+	inline size_t GetMemorySize() const
+	{
+		return m_memorySize;
+	}
 
+protected:
+	inline void AddMemorySize(size_t size)
+	{
+		m_memorySize += size;
 	}
+
+private:
+	ResourceState m_state = RESOURCE_READY;
+	size_t m_memorySize = 0;
 };
\ No newline at end of file
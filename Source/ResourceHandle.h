@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Types.h"
+
+// raw handle layout, slot index in the low bits then the slot's generation, the resource type sits in the top byte
+// so handles of different types never share a value
+static const U32 RESOURCE_HANDLE_INDEX_BITS = 32;
+static const U32 RESOURCE_HANDLE_GENERATION_BITS = 24;
+static const U32 RESOURCE_HANDLE_TYPE_SHIFT = RESOURCE_HANDLE_INDEX_BITS + RESOURCE_HANDLE_GENERATION_BITS;
+static const U32 RESOURCE_HANDLE_GENERATION_MASK = (1 << RESOURCE_HANDLE_GENERATION_BITS) - 1;
+static const U64 INVALID_RESOURCE_HANDLE = ~(U64)0;
+
+
+// a resource of type T in its type's pool, goes stale once the resource is evicted or destroyed.
+// default constructed handles are invalid, stale and invalid ones both resolve to null
+template <class T>
+class Handle
+{
+public:
+	Handle() : m_value(INVALID_RESOURCE_HANDLE) {}
+	explicit Handle(U64 value) : m_value(value) {}
+
+	inline U64 GetValue() const
+	{
+		return m_value;
+	}
+
+	inline bool IsValid() const
+	{
+		return m_value != INVALID_RESOURCE_HANDLE;
+	}
+
+	inline U32 GetIndex() const
+	{
+		return (U32)m_value;
+	}
+
+	inline U32 GetGeneration() const
+	{
+		return (U32)(m_value >> RESOURCE_HANDLE_INDEX_BITS) & RESOURCE_HANDLE_GENERATION_MASK;
+	}
+
+	inline U32 GetType() const
+	{
+		return (U32)(m_value >> RESOURCE_HANDLE_TYPE_SHIFT);
+	}
+
+	inline bool operator==(const Handle& other) const
+	{
+		return m_value == other.m_value;
+	}
+
+	inline bool operator!=(const Handle& other) const
+	{
+		return m_value != other.m_value;
+	}
+
+private:
+	U64 m_value;
+};
\ No newline at end of file
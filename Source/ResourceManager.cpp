@@ -5,6 +5,367 @@
 #include "PixelShader.h"
 #include "Model.h"
 #include "Material.h"
+#include "MeshFile.h"
+#include "TextureFile.h"
+#include "MappedFile.h"
+#include "PackageReader.h"
+#include "WriteLog.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <stdio.h>
+#include <string>
+
+
+// one async load, Read runs on a loader thread and may only touch files and memory,
+// Create runs on the device thread and makes the resource's device objects
+struct ResourceManager::LoadJob
+{
+	virtual ~LoadJob() {}
+	virtual bool Read(Graphics& graphics) = 0;
+	virtual bool Create(Graphics& graphics) = 0;
+
+	std::string path;
+	const PackageReader* package = nullptr;
+	U64 handle = 0;
+	Resource* resource = nullptr;
+	void (*finish)(ResourceManager& manager, U64 handle, bool loaded) = nullptr;	// charges a loaded resource to its pool, destroys a failed one
+	bool read = false;
+	std::vector<U32> groups;
+	std::vector<ResourceLoadCallback> callbacks;
+};
+
+
+// a file from the mounted package when it holds the path, otherwise mapped from disk, null if neither works
+static const U8* OpenFile(const PackageReader& package, const std::string& path, MappedFile& file, size_t& size, bool optional = false)
+{
+	const U8* data = package.Find(path.c_str(), size);
+	if (data == nullptr && file.Open(path.c_str(), optional))
+	{
+		data = file.GetData();
+		size = file.GetSize();
+	}
+	return data;
+}
+
+
+// resolves a packaged shader's #includes in the package, next to the shader itself, or from the loose file when
+// debug builds find it was edited since. nested includes resolve from the same directory, which is all the shaders use
+class PackageShaderInclude : public ID3DInclude
+{
+public:
+	PackageShaderInclude(const PackageReader& package, const std::string& path) : m_package(package)
+	{
+		size_t slash = path.find_last_of('/');
+		m_directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+	}
+
+	HRESULT __stdcall Open(D3D_INCLUDE_TYPE type, LPCSTR fileName, LPCVOID parentData, LPCVOID* data, UINT* bytes) override
+	{
+		std::string path = m_directory + fileName;
+		size_t size = 0;
+		const U8* source = m_package.Find(path.c_str(), size);
+		if (source == nullptr)
+		{
+			// mapped until the include handler goes, after the compile
+			m_files.emplace_back();
+			if (!m_files.back().Open(path.c_str()))
+			{
+				return E_FAIL;
+			}
+
+			source = m_files.back().GetData();
+			size = m_files.back().GetSize();
+		}
+
+		*data = source;
+		*bytes = (UINT)size;
+		return S_OK;
+	}
+
+	HRESULT __stdcall Close(LPCVOID data) override
+	{
+		return S_OK;
+	}
+
+private:
+	const PackageReader& m_package;
+	std::string m_directory;
+	std::deque<MappedFile> m_files;
+};
+
+
+struct TextureLoadJob : public ResourceManager::LoadJob
+{
+	DirectX::ScratchImage image;
+
+	bool Read(Graphics& graphics) override
+	{
+		size_t size = 0;
+		const U8* data = package->Find(path.c_str(), size);
+		if (data != nullptr)
+		{
+			return graphics.LoadImageFromTGAMemory(data, size, image);
+		}
+
+		return graphics.LoadImageFromTGAFile(StringToWideString(path.c_str()).c_str(), image);
+	}
+
+	bool Create(Graphics& graphics) override
+	{
+		return static_cast<Texture*>(resource)->Create(graphics, image);
+	}
+};
+
+
+// loose files are read whole with one call, packaged ones are used where they are mapped
+struct TextureFileLoadJob : public ResourceManager::LoadJob
+{
+	std::vector<U8> data;
+	const TextureFileHeader* header = nullptr;
+
+	bool Read(Graphics& graphics) override
+	{
+		size_t size = 0;
+		const U8* packaged = package->Find(path.c_str(), size);
+		if (packaged == nullptr)
+		{
+			header = ReadTextureFile(path.c_str(), data);
+			return header != nullptr;
+		}
+
+		header = ValidateTextureFile(packaged, size);
+		if (header == nullptr)
+		{
+			DEBUG_ERROR("Invalid texture file: %s", path.c_str());
+			return false;
+		}
+
+		PrefetchMemory(packaged, size);
+		return true;
+	}
+
+	bool Create(Graphics& graphics) override
+	{
+		return static_cast<Texture*>(resource)->Create(graphics, header);
+	}
+};
+
+
+struct VertexShaderLoadJob : public ResourceManager::LoadJob
+{
+	VertexFormat format;
+	ID3DBlob* blob = nullptr;
+
+	~VertexShaderLoadJob()
+	{
+		if (blob != nullptr)
+		{
+			blob->Release();
+		}
+	}
+
+	bool Read(Graphics& graphics) override
+	{
+		size_t size = 0;
+		const U8* source = package->Find(path.c_str(), size);
+		if (source != nullptr)
+		{
+			PackageShaderInclude include(*package, path);
+			blob = VertexShader::Compile(graphics, source, size, path.c_str(), &include);
+		}
+		else
+		{
+			blob = VertexShader::Compile(graphics, StringToWideString(path.c_str()).c_str());
+		}
+
+		return blob != nullptr;
+	}
+
+	bool Create(Graphics& graphics) override
+	{
+		return static_cast<VertexShader*>(resource)->Create(graphics, blob, format);
+	}
+};
+
+
+struct PixelShaderLoadJob : public ResourceManager::LoadJob
+{
+	ID3DBlob* blob = nullptr;
+
+	~PixelShaderLoadJob()
+	{
+		if (blob != nullptr)
+		{
+			blob->Release();
+		}
+	}
+
+	bool Read(Graphics& graphics) override
+	{
+		size_t size = 0;
+		const U8* source = package->Find(path.c_str(), size);
+		if (source != nullptr)
+		{
+			PackageShaderInclude include(*package, path);
+			blob = PixelShader::Compile(graphics, source, size, path.c_str(), &include);
+		}
+		else
+		{
+			blob = PixelShader::Compile(graphics, StringToWideString(path.c_str()).c_str());
+		}
+
+		return blob != nullptr;
+	}
+
+	bool Create(Graphics& graphics) override
+	{
+		return static_cast<PixelShader*>(resource)->Create(graphics, blob);
+	}
+};
+
+
+struct ModelLoadJob : public ResourceManager::LoadJob
+{
+	vector<VertPosNormUVColor> vertices;
+	vector<unsigned int> indices;
+
+	bool Read(Graphics& graphics) override
+	{
+		size_t size = 0;
+		const U8* data = package->Find(path.c_str(), size);
+		if (data != nullptr)
+		{
+			return Model::ReadOBJ(data, size, vertices, indices);
+		}
+
+		return Model::ReadOBJ(path.c_str(), vertices, indices);
+	}
+
+	bool Create(Graphics& graphics) override
+	{
+		return static_cast<Model*>(resource)->Create(graphics, vertices, indices);
+	}
+};
+
+
+// cooked meshes are only mapped and checked off the device thread, the buffers are filled straight from the mapping
+// or the package. the .lod sidecar comes along when there is one
+struct MeshLoadJob : public ResourceManager::LoadJob
+{
+	MappedFile file;
+	MappedFile lodFile;
+	const MeshFileHeader* header = nullptr;
+	const LodFileHeader* lodHeader = nullptr;
+
+	bool Read(Graphics& graphics) override
+	{
+		size_t size = 0;
+		const U8* data = OpenFile(*package, path, file, size);
+		if (data == nullptr)
+		{
+			return false;
+		}
+
+		header = ValidateMeshFile(data, size);
+		if (header == nullptr)
+		{
+			DEBUG_ERROR("Invalid mesh file: %s", path.c_str());
+			return false;
+		}
+
+		// fault the pages in here rather than during buffer creation on the device thread
+		PrefetchMemory(data, size);
+
+		std::string lodPath = GetLodFilePath(path);
+		const U8* lodData = OpenFile(*package, lodPath, lodFile, size, true);
+		if (lodData != nullptr)
+		{
+			lodHeader = ValidateLodFile(lodData, size, header);
+			if (lodHeader == nullptr)
+			{
+				DEBUG_WARN("Ignoring invalid LOD file: %s", lodPath.c_str());
+			}
+			else
+			{
+				PrefetchMemory(lodData, size);
+			}
+		}
+
+		return true;
+	}
+
+	bool Create(Graphics& graphics) override
+	{
+		Model* model = static_cast<Model*>(resource);
+		return model->Create(graphics, header) && (lodHeader == nullptr || model->CreateLods(graphics, lodHeader));
+	}
+};
+
+
+static bool HasExtension(const char* path, const char* ext)
+{
+	size_t length = strlen(path);
+	size_t extLength = strlen(ext);
+	return length >= extLength && strcmp(path + length - extLength, ext) == 0;
+}
+
+
+static bool IsMeshFile(const char* path)
+{
+	return HasExtension(path, ".mesh");
+}
+
+
+static bool IsTextureFile(const char* path)
+{
+	return HasExtension(path, ".tex");
+}
+
+
+static ResourceManager::LoadJob* MakeTextureJob(const char* path)
+{
+	ResourceManager::LoadJob* job = IsTextureFile(path) ? static_cast<ResourceManager::LoadJob*>(new TextureFileLoadJob) : new TextureLoadJob;
+	job->path = path;
+	return job;
+}
+
+
+static ResourceManager::LoadJob* MakeVertexShaderJob(const char* path, const VertexFormat& format)
+{
+	VertexShaderLoadJob* job = new VertexShaderLoadJob;
+	job->path = path;
+	job->format = format;
+	return job;
+}
+
+
+static ResourceManager::LoadJob* MakePixelShaderJob(const char* path)
+{
+	PixelShaderLoadJob* job = new PixelShaderLoadJob;
+	job->path = path;
+	return job;
+}
+
+
+static ResourceManager::LoadJob* MakeModelJob(const char* path)
+{
+	ResourceManager::LoadJob* job = IsMeshFile(path) ? static_cast<ResourceManager::LoadJob*>(new MeshLoadJob) : new ModelLoadJob;
+	job->path = path;
+	return job;
+}
+
+
+template <class F>
+void ResourceManager::ForEachPool(F f)
+{
+	f(GetPool<Texture>());
+	f(GetPool<Model>());
+	f(GetPool<VertexShader>());
+	f(GetPool<PixelShader>());
+	f(GetPool<Material>());
+}
+
 
 ResourceManager::ResourceManager()
 {
@@ -13,77 +374,343 @@ ResourceManager::ResourceManager()
 
 ResourceManager::~ResourceManager()
 {
+	ShutDown();
 }
 
 
-bool ResourceManager::StartUp(Graphics& graphics)
+bool ResourceManager::StartUp(Graphics& graphics, U32 numLoaderThreads, U32 poolSize)
 {
 	m_graphics = &graphics;
-	m_pool.StartUp(20);
-	return true;
+	ForEachPool([poolSize](auto& pool) { pool.StartUp(poolSize); });
+	m_loggedTime = std::chrono::steady_clock::now();
+	return m_loaderThreads.StartUp(numLoaderThreads);
 }
 
 
-bool ResourceManager::LoadTexture(const char* path, U64& handle, const StringId key)
+void ResourceManager::ShutDown()
 {
-	Texture* tex = new Texture;
-	if (!tex->Load(*m_graphics, StringToWideString(path).c_str()))
+	// unfinished loads are dropped, their resources are destroyed with the rest
+	m_loaderThreads.ShutDown();
+
+	for (auto& pending : m_pendingLoads)
 	{
-		return false;
+		pending.second->resource->SetState(RESOURCE_FAILED);
+		delete pending.second;
 	}
 
-	handle = m_pool.Insert(key, tex);
+	m_pendingLoads.clear();
+	m_groups.clear();
+	m_readLoads.clear();
+	m_finishingLoads.clear();
 
-	return true;
+	ForEachPool([](auto& pool) { pool.ShutDown(); });
+	m_package.Close();
+}
+
+
+bool ResourceManager::MountPackage(const char* path)
+{
+	ASSERT_VERBOSE(m_pendingLoads.empty(), "Package mounted while loads were in flight");
+	return m_package.Open(path, true);
+}
+
+
+bool ResourceManager::LoadTexture(const char* path, Handle<Texture>& handle, const StringId key)
+{
+	return RunLoad(key, MakeTextureJob(path), handle);
+}
+
+
+bool ResourceManager::LoadVertexShader(const char* path, Handle<VertexShader>& handle, const VertexFormat& format, const StringId key)
+{
+	return RunLoad(key, MakeVertexShaderJob(path, format), handle);
+}
+
+
+bool ResourceManager::LoadPixelShader(const char* path, Handle<PixelShader>& handle, const StringId key)
+{
+	return RunLoad(key, MakePixelShaderJob(path), handle);
+}
+
+
+bool ResourceManager::LoadModel(const char* path, Handle<Model>& handle, const StringId key)
+{
+	return RunLoad(key, MakeModelJob(path), handle);
 }
 
 
-bool ResourceManager::LoadVertexShader(const char* path, U64& handle, const VertexFormat& format, const StringId key)
+Handle<Texture> ResourceManager::LoadTextureAsync(const char* path, const StringId key, U32 group, ResourceLoadCallback callback)
 {
-	VertexShader* vs = new VertexShader;
-	if (!vs->Load(*m_graphics, StringToWideString(path).c_str(), format))
+	return QueueLoad<Texture>(key, MakeTextureJob(path), group, callback);
+}
+
+
+Handle<VertexShader> ResourceManager::LoadVertexShaderAsync(const char* path, const VertexFormat& format, const StringId key, U32 group, ResourceLoadCallback callback)
+{
+	return QueueLoad<VertexShader>(key, MakeVertexShaderJob(path, format), group, callback);
+}
+
+
+Handle<PixelShader> ResourceManager::LoadPixelShaderAsync(const char* path, const StringId key, U32 group, ResourceLoadCallback callback)
+{
+	return QueueLoad<PixelShader>(key, MakePixelShaderJob(path), group, callback);
+}
+
+
+Handle<Model> ResourceManager::LoadModelAsync(const char* path, const StringId key, U32 group, ResourceLoadCallback callback)
+{
+	return QueueLoad<Model>(key, MakeModelJob(path), group, callback);
+}
+
+
+void ResourceManager::Update()
+{
+	std::vector<LoadJob*> readLoads;
 	{
-		return false;
+		std::lock_guard<std::mutex> lock(m_readMutex);
+		readLoads.swap(m_readLoads);
+	}
+
+	// a callback that waits on a load comes back in here, it finishes the rest of this batch before its own
+	m_finishingLoads.insert(m_finishingLoads.end(), readLoads.begin(), readLoads.end());
+	while (!m_finishingLoads.empty())
+	{
+		LoadJob* job = m_finishingLoads.front();
+		m_finishingLoads.pop_front();
+		FinishLoad(job);
 	}
+}
 
-	handle = m_pool.Insert(key, vs);
 
-	return true;
+void ResourceManager::FinishReadLoads()
+{
+	if (m_finishingLoads.empty())
+	{
+		std::unique_lock<std::mutex> lock(m_readMutex);
+		m_readSignal.wait(lock, [this] { return !m_readLoads.empty(); });
+	}
+
+	Update();
+}
+
+
+bool ResourceManager::IsGroupLoaded(U32 group) const
+{
+	auto itr = m_groups.find(group);
+	return itr == m_groups.end() || itr->second.numPending == 0;
 }
 
 
-bool ResourceManager::LoadPixelShader(const char* path, U64& handle, const StringId key)
+bool ResourceManager::WaitForGroup(U32 group)
 {
-	PixelShader* ps = new PixelShader;
-	if (!ps->Load(*m_graphics, StringToWideString(path).c_str()))
+	while (!IsGroupLoaded(group))
 	{
-		return false;
+		FinishReadLoads();
 	}
 
-	handle = m_pool.Insert(key, ps);
+	auto itr = m_groups.find(group);
+	if (itr == m_groups.end())
+	{
+		return true;
+	}
 
-	return true;
+	bool loaded = itr->second.numFailed == 0;
+	m_groups.erase(itr);
+	return loaded;
 }
 
 
-bool ResourceManager::LoadModel(const char* path, U64& handle, const StringId key)
+template <class T>
+Handle<T> ResourceManager::QueueLoad(const StringId key, LoadJob* job, U32 group, ResourceLoadCallback& callback)
 {
-	Model* model = new Model;
-	if (!model->LoadFromOBJ(*m_graphics, path))
+	ResourcePool<T>& pool = GetPool<T>();
+	bool inserted = false;
+	Handle<T> handle = pool.Insert(key, inserted);
+	pool.AddRef(handle);
+	T* resource = pool.Get(handle);
+
+	if (!inserted)
 	{
-		return false;
+		delete job;
+
+		// join the load already running for the key, or report the finished one right away
+		auto itr = m_pendingLoads.find(handle.GetValue());
+		if (itr != m_pendingLoads.end())
+		{
+			LoadJob* pending = itr->second;
+			if (std::find(pending->groups.begin(), pending->groups.end(), group) == pending->groups.end())
+			{
+				pending->groups.push_back(group);
+				m_groups[group].numPending++;
+			}
+
+			if (callback)
+			{
+				pending->callbacks.push_back(callback);
+			}
+		}
+		else if (callback)
+		{
+			callback(handle.GetValue(), resource->GetState() == RESOURCE_READY);
+		}
+
+		return handle;
+	}
+
+	resource->SetState(RESOURCE_LOADING);
+	job->handle = handle.GetValue();
+	job->resource = resource;
+	job->finish = [](ResourceManager& manager, U64 handle, bool loaded)
+	{
+		if (loaded)
+		{
+			manager.GetPool<T>().Track(Handle<T>(handle));
+		}
+		else
+		{
+			manager.GetPool<T>().Destroy(Handle<T>(handle));
+		}
+	};
+	job->package = &m_package;
+	job->groups.push_back(group);
+	if (callback)
+	{
+		job->callbacks.push_back(callback);
+	}
+
+	m_pendingLoads.emplace(handle.GetValue(), job);
+	m_groups[group].numPending++;
+
+	m_loaderThreads.Submit([this, job]()
+	{
+		job->read = job->Read(*m_graphics);
+
+		{
+			std::lock_guard<std::mutex> lock(m_readMutex);
+			m_readLoads.push_back(job);
+		}
+		m_readSignal.notify_all();
+	});
+
+	return handle;
+}
+
+
+void ResourceManager::FinishLoad(LoadJob* job)
+{
+	bool loaded = job->read && job->Create(*m_graphics);
+	if (!loaded)
+	{
+		DEBUG_ERROR("Failed to load %s", job->path.c_str());
+	}
+
+	job->resource->SetState(loaded ? RESOURCE_READY : RESOURCE_FAILED);
+	m_pendingLoads.erase(job->handle);
+
+	for (U32 group : job->groups)
+	{
+		LoadGroup& loadGroup = m_groups[group];
+		loadGroup.numPending--;
+		loadGroup.numFailed += loaded ? 0 : 1;
+	}
+
+	// callbacks may start new loads and wait on them or on groups, the job is already out of the pending map
+	for (ResourceLoadCallback& callback : job->callbacks)
+	{
+		callback(job->handle, loaded);
 	}
 
-	handle = m_pool.Insert(key, model);
+	// charged to the budget only now, so callbacks see the resource even when nothing references it anymore.
+	// a failed one is destroyed like a failed sync load, its key is dropped so the next load tries again
+	job->finish(*this, job->handle, loaded);
+	delete job;
+}
+
+
+bool ResourceManager::CreateMaterial(Handle<Material>& handle, const StringId key)
+{
+	// an existing material is handed back as it is
+	bool inserted = false;
+	handle = GetPool<Material>().Insert(key, inserted);
+	GetPool<Material>().AddRef(handle);
 
 	return true;
 }
 
 
-bool ResourceManager::CreateMaterial(U64& handle, const StringId key)
+template <class T>
+bool ResourceManager::RunLoad(const StringId key, LoadJob* job, Handle<T>& handle)
 {
-	Material* mat = new Material;
-	handle = m_pool.Insert(key, mat);
+	ResourcePool<T>& pool = GetPool<T>();
+	bool inserted = false;
+	handle = pool.Insert(key, inserted);
+	pool.AddRef(handle);
+	T* resource = pool.Get(handle);
+
+	if (!inserted)
+	{
+		delete job;
 
+		// an async load of the key may still be running, finish it here like the sync load would have.
+		// a failed one was destroyed along with the reference just added
+		WaitForLoad(handle.GetValue());
+		return pool.Get(handle) != nullptr;
+	}
+
+	job->resource = resource;
+	job->package = &m_package;
+	bool loaded = job->Read(*m_graphics) && job->Create(*m_graphics);
+	delete job;
+
+	if (!loaded)
+	{
+		pool.Destroy(handle);
+		return false;
+	}
+
+	pool.Track(handle);
 	return true;
+}
+
+
+void ResourceManager::WaitForLoad(U64 handle)
+{
+	while (m_pendingLoads.find(handle) != m_pendingLoads.end())
+	{
+		FinishReadLoads();
+	}
+}
+
+
+void ResourceManager::LogStats()
+{
+	auto now = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(now - m_loggedTime).count();
+	double rate = seconds > 0 ? 1 / seconds : 0;
+
+	ForEachPool([this, rate](auto& pool)
+	{
+		ResourceType type = std::decay<decltype(pool)>::type::TYPE;
+		const ResourceStats& stats = pool.GetStats();
+		ResourceStats& logged = m_loggedStats[type];
+		if (stats.numLoads == 0)
+		{
+			return;
+		}
+
+		char budget[32] = "no budget";
+		if (stats.budget != NO_RESOURCE_BUDGET)
+		{
+			snprintf(budget, sizeof(budget), "%.2f MB budget", stats.budget / (1024.0 * 1024.0));
+		}
+
+		DEBUG_PRINT("%s: %.2f MB of %s, %u resident, %u unreferenced, %.2f loads/s, %.2f hits/s, %.2f evictions/s, %.2f reloads/s",
+			ResourceTypeName(type), stats.memorySize / (1024.0 * 1024.0), budget, stats.numResident, stats.numUnreferenced,
+			(stats.numLoads - logged.numLoads) * rate, (stats.numHits - logged.numHits) * rate,
+			(stats.numEvictions - logged.numEvictions) * rate, (stats.numReloads - logged.numReloads) * rate);
+
+		logged = stats;
+	});
+
+	m_loggedTime = now;
 }
\ No newline at end of file
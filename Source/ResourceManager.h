@@ -2,8 +2,30 @@
 
 #include "Graphics.h"
 #include "ResourcePool.h"
+#include "ResourceHandle.h"
+#include "PackageReader.h"
 #include "StringId.h"
 #include "Resource.h"
+#include "Texture.h"
+#include "VertexShader.h"
+#include "PixelShader.h"
+#include "Model.h"
+#include "Material.h"
+#include "ThreadPool.h"
+#include "Assert.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+
+// runs on the thread calling ResourceManager::Update once an async load is finished, loaded is false if it failed.
+// handle is the raw value of the load's typed handle, the callback may release or destroy it
+typedef std::function<void(U64 handle, bool loaded)> ResourceLoadCallback;
 
 
 class ResourceManager
@@ -11,36 +33,183 @@ class ResourceManager
 public:
 	ResourceManager();
 	~ResourceManager();
-	bool StartUp(Graphics& graphics);
 
-	bool LoadTexture(const char* path, U64& handle, const StringId key);
-	bool LoadVertexShader(const char* path, U64& handle, const VertexFormat& format, const StringId key);
-	bool LoadPixelShader(const char* path, U64& handle, const StringId key);
-	bool LoadModel(const char* path, U64& handle, const StringId key);
+	// 0 loader threads uses one less than the hardware threads, poolSize is only how many resources of each type
+	// to make room for up front
+	bool StartUp(Graphics& graphics, U32 numLoaderThreads = 0, U32 poolSize = 256);
+
+	// destroys every resource, referenced or not
+	void ShutDown();
+
+	// every load looks its path up in the package before going to disk, so mount before queueing any.
+	// a missing package isn't an error, everything then loads from loose files
+	bool MountPackage(const char* path);
+
+	// every load hands the caller a reference to the resource, a key that is already loaded adds one to it.
+	// keys only need to be unique within a type
+	bool LoadTexture(const char* path, Handle<Texture>& handle, const StringId key);
+	bool LoadVertexShader(const char* path, Handle<VertexShader>& handle, const VertexFormat& format, const StringId key);
+	bool LoadPixelShader(const char* path, Handle<PixelShader>& handle, const StringId key);
+	bool LoadModel(const char* path, Handle<Model>& handle, const StringId key);
+
+	// async loads hand back the handle straight away, the file is read and decoded on a loader thread and the
+	// device objects are made by Update, until then the resource is RESOURCE_LOADING and must not be used for drawing.
+	// a key that is already loaded or loading returns the existing handle and joins its load, with a reference either way.
+	// a failed load is destroyed once its callbacks ran, its handles go stale and the next load of the key tries again
+	Handle<Texture> LoadTextureAsync(const char* path, const StringId key, U32 group = 0, ResourceLoadCallback callback = nullptr);
+	Handle<VertexShader> LoadVertexShaderAsync(const char* path, const VertexFormat& format, const StringId key, U32 group = 0, ResourceLoadCallback callback = nullptr);
+	Handle<PixelShader> LoadPixelShaderAsync(const char* path, const StringId key, U32 group = 0, ResourceLoadCallback callback = nullptr);
+	Handle<Model> LoadModelAsync(const char* path, const StringId key, U32 group = 0, ResourceLoadCallback callback = nullptr);
+
+	// finishes async loads whose file work is done and runs their callbacks, call once a frame on the device thread.
+	// callbacks may call it too, directly or through a sync load or wait, the batch already taken is finished first
+	void Update();
 
-	// creates an uninitialized material
-	bool CreateMaterial(U64& handle, const StringId key);
+	// true once every load in the group is finished, loaded or failed
+	bool IsGroupLoaded(U32 group) const;
 
+	// barrier for a group, finishes loads on this thread until the whole group is done then forgets the group,
+	// returns false if any load in it failed
+	bool WaitForGroup(U32 group);
 
-	inline Resource* FindResourceByStringId(const StringId key)
+	// creates an uninitialized material, referenced like a load
+	bool CreateMaterial(Handle<Material>& handle, const StringId key);
+
+
+	// resolves a name once, keep the handle rather than looking the key up again. invalid if it isn't resident
+	template <class T>
+	inline Handle<T> FindResourceByStringId(const StringId key) const
 	{
-		return m_pool.Find(key);
+		return GetPool<T>().Find(key);
 	}
 
 
-	inline Resource* GetResourceByHandle(U64 handle)
+	// null once the resource was evicted or destroyed
+	template <class T>
+	inline T* GetResourceByHandle(Handle<T> handle)
 	{
-		return m_pool.Get(handle);
+		return GetPool<T>().Get(handle);
 	}
 
 
-	inline void DestroyResource(const StringId key)
+	// RESOURCE_UNLOADED for stale and invalid handles
+	template <class T>
+	inline ResourceState GetResourceState(Handle<T> handle)
 	{
-		m_pool.DestroyByStringId(key);
+		T* resource = GetPool<T>().Get(handle);
+		return resource != nullptr ? resource->GetState() : RESOURCE_UNLOADED;
 	}
 
 
+	template <class T>
+	inline void AddResourceRef(Handle<T> handle)
+	{
+		GetPool<T>().AddRef(handle);
+	}
+
+
+	// drops a reference from a load, the resource stays cached once unreferenced and is only evicted, least recently
+	// released first, when its type is over budget. loading the key again before then reuses it, after it is a reload.
+	// releasing a stale handle does nothing, failed async loads are destroyed while they are still referenced
+	template <class T>
+	inline void ReleaseResource(Handle<T> handle)
+	{
+		GetPool<T>().Release(handle);
+	}
+
+
+	// bytes of device memory a type's resources may hold before unreferenced ones are evicted, referenced resources
+	// are never evicted so they can still go over. NO_RESOURCE_BUDGET by default
+	template <class T>
+	inline void SetMemoryBudget(size_t bytes)
+	{
+		GetPool<T>().SetBudget(bytes);
+	}
+
+
+	template <class T>
+	inline const ResourceStats& GetStats() const
+	{
+		return GetPool<T>().GetStats();
+	}
+
+
+	// logs each type's memory against its budget, and the load, eviction and reload rates since the last call
+	void LogStats();
+
+
+	// a resource can't be destroyed while its load is in flight, its handles go stale even if they are referenced
+	template <class T>
+	inline void DestroyResource(Handle<T> handle)
+	{
+		T* resource = GetPool<T>().Get(handle);
+		ASSERT_VERBOSE(!resource || resource->GetState() != RESOURCE_LOADING, "Resource destroyed while it was loading");
+		GetPool<T>().Destroy(handle);
+	}
+
+
+	// an async load in flight, the job types live in ResourceManager.cpp
+	struct LoadJob;
+
+private:
+	struct LoadGroup
+	{
+		U32 numPending = 0;
+		U32 numFailed = 0;
+	};
+
+	template <class T>
+	inline ResourcePool<T>& GetPool()
+	{
+		return std::get<ResourcePool<T>>(m_pools);
+	}
+
+	template <class T>
+	inline const ResourcePool<T>& GetPool() const
+	{
+		return std::get<ResourcePool<T>>(m_pools);
+	}
+
+	// runs f on every type's pool
+	template <class F>
+	void ForEachPool(F f);
+
+	template <class T>
+	Handle<T> QueueLoad(const StringId key, LoadJob* job, U32 group, ResourceLoadCallback& callback);
+
+	// sync loads run the same jobs as async ones with both halves on this thread
+	template <class T>
+	bool RunLoad(const StringId key, LoadJob* job, Handle<T>& handle);
+
+	void FinishLoad(LoadJob* job);
+
+	// finishes loads on this thread until the one for the handle is done
+	void WaitForLoad(U64 handle);
+
+	// finishes the read loads, blocking until a loader thread hands one over if there are none
+	void FinishReadLoads();
+
 private:
 	Graphics* m_graphics;
-	ResourcePool m_pool;
+	PackageReader m_package;
+
+	std::tuple<ResourcePool<Texture>, ResourcePool<Model>, ResourcePool<VertexShader>, ResourcePool<PixelShader>, ResourcePool<Material>> m_pools;
+
+	ThreadPool m_loaderThreads;
+
+	// loads that haven't been finished by Update yet, by raw handle, only touched on the device thread
+	std::unordered_map<U64, LoadJob*> m_pendingLoads;
+	std::unordered_map<U32, LoadGroup> m_groups;
+
+	// loads whose file work is done, pushed by the loader threads
+	std::mutex m_readMutex;
+	std::condition_variable m_readSignal;
+	std::vector<LoadJob*> m_readLoads;
+
+	// read loads taken by Update and not finished yet, a callback waiting on a load finishes these first
+	std::deque<LoadJob*> m_finishingLoads;
+
+	// counters at the last LogStats
+	ResourceStats m_loggedStats[NUM_RESOURCE_TYPES];
+	std::chrono::steady_clock::time_point m_loggedTime;
 };
\ No newline at end of file
@@ -1,79 +1,343 @@
 #pragma once
 
+#include <deque>
+#include <new>
+#include <stdint.h>
 #include <unordered_map>
-#include "CompactPool.h"
+#include <unordered_set>
+#include "Assert.h"
 #include "StringId.h"
 #include "Types.h"
 #include "Resource.h"
+#include "ResourceHandle.h"
 
 
+static const size_t NO_RESOURCE_BUDGET = SIZE_MAX;
+
+
+// counters are totals since startup, rates come from sampling them twice
+struct ResourceStats
+{
+	U32 numResident = 0;			// in the pool, loading ones included
+	U32 numUnreferenced = 0;		// cached on the LRU list, the first to go when over budget
+	size_t memorySize = 0;			// of resident resources, referenced ones can push it over the budget
+	size_t budget = NO_RESOURCE_BUDGET;
+	U64 numLoads = 0;				// resources created, reloads included
+	U64 numHits = 0;				// loads served by a resident resource, cached ones included
+	U64 numEvictions = 0;
+	U64 numReloads = 0;				// loads of a key that was evicted before
+};
+
+
+// Resources of one type stored in place, with a reference count each. Unreferenced resources stay cached on an LRU
+// list and are only destroyed, least recently released first, when the type is over its memory budget.
+// Slots are only ever added at the back so resources never move, freed slots are reused with a new generation and
+// the handles to their old resource resolve to null. The key map is only for name lookups, handles index slots directly.
+template <class T>
 class ResourcePool
 {
 public:
+	static const ResourceType TYPE = T::TYPE;
 
-	inline bool StartUp(const U32 poolSize)
+	~ResourcePool()
 	{
-		if (m_pool.StartUp(poolSize))
+		ShutDown();
+	}
+
+
+	// poolSize is only how many keys to make room for up front, slots are added as needed
+	inline bool StartUp(U32 poolSize)
+	{
+		m_resourceMap.reserve(poolSize);
+		return true;
+	}
+
+
+	// destroys every resource, referenced or not
+	inline void ShutDown()
+	{
+		for (U32 i = 0; i < (U32)m_slots.size(); ++i)
 		{
-			return true;
+			if (m_slots[i].active)
+			{
+				Destroy(i);
+			}
 		}
+		m_evictedKeys.clear();
 	}
 
 
-	inline U64 Insert(const StringId key, Resource* resource)
+	// makes a default constructed resource for a new key, a key that is already in the pool returns its handle
+	inline Handle<T> Insert(const StringId key, bool& inserted)
 	{
 		auto itr = m_resourceMap.find(key);
-		if (itr == m_resourceMap.end())
+		if (itr != m_resourceMap.end())
 		{
-			U64 handle = m_pool.InsertObject(resource);
-			m_resourceMap.emplace(key, handle);
-			
-			return handle;
+			inserted = false;
+			m_stats.numHits++;
+			return MakeHandle(itr->second);
+		}
+
+		U32 index = m_freeList;
+		if (index != NO_SLOT)
+		{
+			m_freeList = m_slots[index].nextFree;
 		}
 		else
 		{
-			// resource already exists, return handle
-			return itr->second;
+			index = (U32)m_slots.size();
+			m_slots.emplace_back();
 		}
+
+		Slot& slot = m_slots[index];
+		new (slot.storage) T();
+		slot.key = key;
+		slot.refCount = 0;
+		slot.memorySize = 0;
+		slot.active = true;
+		slot.cached = false;
+		slot.lruPrev = NO_SLOT;
+		slot.lruNext = NO_SLOT;
+		m_resourceMap.emplace(key, index);
+
+		m_stats.numResident++;
+		m_stats.numLoads++;
+		if (m_evictedKeys.erase(key) != 0)
+		{
+			m_stats.numReloads++;
+		}
+
+		inserted = true;
+		return MakeHandle(index);
 	}
 
 
-	inline Resource* Find(const StringId key)
+	// invalid if the key isn't in the pool
+	inline Handle<T> Find(const StringId key) const
 	{
 		auto itr = m_resourceMap.find(key);
-		if (itr == m_resourceMap.end())
+		return itr != m_resourceMap.end() ? MakeHandle(itr->second) : Handle<T>();
+	}
+
+
+	inline T* Get(Handle<T> handle)
+	{
+		Slot* slot = GetSlot(handle);
+		return slot != nullptr ? slot->Object() : nullptr;
+	}
+
+
+	// a cached resource goes back into use
+	inline void AddRef(Handle<T> handle)
+	{
+		Slot* slot = GetSlot(handle);
+		ASSERT_VERBOSE(slot != nullptr, "Reference added to an evicted resource");
+
+		if (slot->refCount++ == 0 && slot->cached)
+		{
+			Uncache(handle.GetIndex());
+		}
+	}
+
+
+	// the last reference caches the resource, a loading one is cached once Track sees it finished.
+	// stale handles are ignored, a resource can be destroyed while it is still referenced
+	inline void Release(Handle<T> handle)
+	{
+		Slot* slot = GetSlot(handle);
+		if (slot == nullptr)
+		{
+			return;
+		}
+
+		ASSERT_VERBOSE(slot->refCount > 0, "Resource released more often than it was referenced");
+
+		if (--slot->refCount == 0 && slot->Object()->GetState() != RESOURCE_LOADING)
+		{
+			Cache(handle.GetIndex());
+			Trim();
+		}
+	}
+
+
+	// charges a resource that finished loading to the budget, evicting cached ones to make room. a stale handle is
+	// ignored, a load callback may have released the resource into eviction or destroyed it already
+	inline void Track(Handle<T> handle)
+	{
+		Slot* slot = GetSlot(handle);
+		if (slot == nullptr)
+		{
+			return;
+		}
+
+		size_t memorySize = slot->Object()->GetMemorySize();
+		m_stats.memorySize += memorySize - slot->memorySize;
+		slot->memorySize = memorySize;
+
+		if (slot->refCount == 0 && !slot->cached)
+		{
+			Cache(handle.GetIndex());
+		}
+		Trim();
+	}
+
+
+	inline void SetBudget(size_t budget)
+	{
+		m_stats.budget = budget;
+		Trim();
+	}
+
+
+	inline const ResourceStats& GetStats() const
+	{
+		return m_stats;
+	}
+
+
+	inline void Destroy(Handle<T> handle)
+	{
+		if (GetSlot(handle) != nullptr)
+		{
+			Destroy(handle.GetIndex());
+		}
+	}
+
+private:
+	static const U32 NO_SLOT = ~0u;
+
+	struct Slot
+	{
+		alignas(T) unsigned char storage[sizeof(T)];
+		StringId key = 0;
+		U32 generation = 0;
+		U32 refCount = 0;
+		U32 nextFree = NO_SLOT;
+		size_t memorySize = 0;				// what the budget was charged
+		bool active = false;
+		bool cached = false;
+		U32 lruPrev = NO_SLOT;				// neighbours on the LRU list while cached
+		U32 lruNext = NO_SLOT;
+
+		inline T* Object()
+		{
+			return reinterpret_cast<T*>(storage);
+		}
+	};
+
+
+	inline Handle<T> MakeHandle(U32 index) const
+	{
+		return Handle<T>(((U64)TYPE << RESOURCE_HANDLE_TYPE_SHIFT) | ((U64)m_slots[index].generation << RESOURCE_HANDLE_INDEX_BITS) | index);
+	}
+
+
+	inline Slot* GetSlot(Handle<T> handle)
+	{
+		U32 index = handle.GetIndex();
+		if (handle.GetType() != (U32)TYPE || index >= m_slots.size())
 		{
 			return nullptr;
 		}
+
+		Slot& slot = m_slots[index];
+		return slot.active && slot.generation == handle.GetGeneration() ? &slot : nullptr;
+	}
+
+
+	// appended at the back, the most recently released end
+	inline void Cache(U32 index)
+	{
+		Slot& slot = m_slots[index];
+		slot.cached = true;
+		slot.lruPrev = m_lruBack;
+		slot.lruNext = NO_SLOT;
+
+		if (m_lruBack != NO_SLOT)
+		{
+			m_slots[m_lruBack].lruNext = index;
+		}
+		else
+		{
+			m_lruFront = index;
+		}
+		m_lruBack = index;
+		m_stats.numUnreferenced++;
+	}
+
+
+	inline void Uncache(U32 index)
+	{
+		Slot& slot = m_slots[index];
+		slot.cached = false;
+
+		if (slot.lruPrev != NO_SLOT)
+		{
+			m_slots[slot.lruPrev].lruNext = slot.lruNext;
+		}
+		else
+		{
+			m_lruFront = slot.lruNext;
+		}
+
+		if (slot.lruNext != NO_SLOT)
+		{
+			m_slots[slot.lruNext].lruPrev = slot.lruPrev;
+		}
 		else
 		{
-			return Get(itr->second);
+			m_lruBack = slot.lruPrev;
 		}
+
+		slot.lruPrev = NO_SLOT;
+		slot.lruNext = NO_SLOT;
+		m_stats.numUnreferenced--;
 	}
 
 
-	inline Resource* Get(U64 handle)
+	// the front of the list is the least recently released
+	inline void Trim()
 	{
-		return *m_pool.GetObjectByHandle(handle);
+		while (m_stats.memorySize > m_stats.budget && m_lruFront != NO_SLOT)
+		{
+			U32 index = m_lruFront;
+			m_evictedKeys.insert(m_slots[index].key);
+			m_stats.numEvictions++;
+			Destroy(index);
+		}
 	}
 
 
-	inline void DestroyByStringId(const StringId key)
+	inline void Destroy(U32 index)
 	{
-		auto itr = m_resourceMap.find(key);
-		if (itr != m_resourceMap.end())
+		Slot& slot = m_slots[index];
+		if (slot.cached)
 		{
-			U64 handle = itr->second;
-			Resource* resource = *m_pool.GetObjectByHandle(handle);
-			resource->ShutDown();
-			delete resource;
-			m_pool.DestroyObject(handle);
-			m_resourceMap.erase(itr);
+			Uncache(index);
 		}
+
+		m_stats.memorySize -= slot.memorySize;
+		m_stats.numResident--;
+
+		slot.Object()->~T();
+		m_resourceMap.erase(slot.key);
+
+		slot.active = false;
+		slot.generation = (slot.generation + 1) & RESOURCE_HANDLE_GENERATION_MASK;
+		slot.nextFree = m_freeList;
+		m_freeList = index;
 	}
 
+private:
+	std::deque<Slot> m_slots;
+	U32 m_freeList = NO_SLOT;
+	std::unordered_map<StringId, U32> m_resourceMap;
+
+	// unreferenced resources threaded through their slots, slots never move so the links stay valid
+	U32 m_lruFront = NO_SLOT;
+	U32 m_lruBack = NO_SLOT;
+	ResourceStats m_stats;
 
-protected:
-	CompactPool<Resource*> m_pool;
-	std::unordered_map<StringId, U64> m_resourceMap;
+	// keys evicted since they were last loaded, so loading one again counts as a reload
+	std::unordered_set<StringId> m_evictedKeys;
 };
\ No newline at end of file
@@ -1,8 +1,9 @@
 #include "RigidBody.h"
 #include "Physics.h"
+#include "Assert.h"
 
 
-RigidBody::RigidBody(btRigidBody* body)
+RigidBody::RigidBody(btCollisionObject* body)
 {
 	m_body = body;
 }
@@ -14,21 +15,21 @@ RigidBody::~RigidBody()
 
 void RigidBody::SetTransform(XMMATRIX transform)
 {
-	m_body->getMotionState()->setWorldTransform(Physics::MatFromDX(transform));
+	WriteTransform(Physics::MatFromDX(transform));
 }
 
 
 void RigidBody::SetTransform(XMVECTOR position, XMVECTOR rotation)
 {
 	btTransform t(Physics::QuatFromDX(rotation), Physics::VecFromDX(position));
-	m_body->getMotionState()->setWorldTransform(t);
+	WriteTransform(t);
 }
 
 
 XMMATRIX RigidBody::GetTransform()
 {
 	btTransform t;
-	m_body->getMotionState()->getWorldTransform(t);
+	ReadTransform(t);
 
 	return Physics::MatToDX(t);
 }
@@ -37,16 +38,16 @@ XMMATRIX RigidBody::GetTransform()
 void RigidBody::SetPosition(XMVECTOR position)
 {
 	btTransform t;
-	m_body->getMotionState()->getWorldTransform(t);
+	ReadTransform(t);
 	t.setOrigin(Physics::VecFromDX(position));
-	m_body->getMotionState()->setWorldTransform(t);
+	WriteTransform(t);
 }
 
 
 XMVECTOR RigidBody::GetPosition()
 {
 	btTransform t;
-	m_body->getMotionState()->getWorldTransform(t);
+	ReadTransform(t);
 
 	return Physics::VecToDX(t.getOrigin());
 }
@@ -55,16 +56,16 @@ XMVECTOR RigidBody::GetPosition()
 void RigidBody::SetRotation(XMVECTOR rotation)
 {
 	btTransform t;
-	m_body->getMotionState()->getWorldTransform(t);
+	ReadTransform(t);
 	t.setRotation(Physics::QuatFromDX(rotation));
-	m_body->getMotionState()->setWorldTransform(t);
+	WriteTransform(t);
 }
 
 
 XMVECTOR RigidBody::GetRotation()
 {
 	btTransform t;
-	m_body->getMotionState()->getWorldTransform(t);
+	ReadTransform(t);
 
 	return Physics::QuatToDX(t.getRotation());
 }
@@ -72,25 +73,35 @@ XMVECTOR RigidBody::GetRotation()
 
 void RigidBody::SetLinearVelocity(XMVECTOR velocity)
 {
-	m_body->setLinearVelocity(Physics::VecFromDX(velocity));
+	btRigidBody* body = btRigidBody::upcast(m_body);
+	if (body)
+	{
+		body->setLinearVelocity(Physics::VecFromDX(velocity));
+	}
 }
 
 
 XMVECTOR RigidBody::GetLinearVelocity()
 {
-	return Physics::VecToDX(m_body->getLinearVelocity());
+	btRigidBody* body = btRigidBody::upcast(m_body);
+	return body ? Physics::VecToDX(body->getLinearVelocity()) : XMVectorZero();
 }
 
 
 void RigidBody::SetAngularVelocity(XMVECTOR velocity)
 {
-	m_body->setAngularVelocity(Physics::VecFromDX(velocity));
+	btRigidBody* body = btRigidBody::upcast(m_body);
+	if (body)
+	{
+		body->setAngularVelocity(Physics::VecFromDX(velocity));
+	}
 }
 
 
 XMVECTOR RigidBody::GetAngularVelocity()
 {
-	return Physics::VecToDX(m_body->getAngularVelocity());
+	btRigidBody* body = btRigidBody::upcast(m_body);
+	return body ? Physics::VecToDX(body->getAngularVelocity()) : XMVectorZero();
 }
 
 
@@ -129,12 +140,53 @@ bool RigidBody::IsKinematic()
 
 void RigidBody::SetGravity(float gravity)
 {
-	btVector3 grav(0, gravity, 0);
-	m_body->setGravity(grav);
+	btRigidBody* body = btRigidBody::upcast(m_body);
+	if (body)
+	{
+		btVector3 grav(0, gravity, 0);
+		body->setGravity(grav);
+	}
 }
 
 
 bool RigidBody::IsTrigger()
 {
 	return m_body->getCollisionFlags() & btCollisionObject::CF_NO_CONTACT_RESPONSE ? true : false;
+}
+
+
+void RigidBody::SetMotionStateListener(MotionStateListener* listener, U64 handle)
+{
+	btRigidBody* body = btRigidBody::upcast(m_body);
+	ASSERT_VERBOSE(body, "Only rigid bodies have a motion state");
+	static_cast<MotionState*>(body->getMotionState())->SetListener(listener, handle);
+}
+
+
+void RigidBody::ReadTransform(btTransform& t)
+{
+	btRigidBody* body = btRigidBody::upcast(m_body);
+	if (body)
+	{
+		body->getMotionState()->getWorldTransform(t);
+	}
+	else
+	{
+		t = m_body->getWorldTransform();
+	}
+}
+
+
+void RigidBody::WriteTransform(const btTransform& t)
+{
+	btRigidBody* body = btRigidBody::upcast(m_body);
+	if (body)
+	{
+		body->getMotionState()->setWorldTransform(t);
+	}
+	else
+	{
+		// the broadphase picks up the new bounds on the next step
+		m_body->setWorldTransform(t);
+	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Types.h"
 #include "Entity.h"
+#include "MotionState.h"
 #include "btBulletDynamicsCommon.h"
 #include <DirectXMath.h>
 using namespace DirectX;
@@ -13,7 +14,7 @@ class RigidBody
 public:
 	friend class Physics;
 	RigidBody() {};
-	RigidBody(btRigidBody* body);
+	RigidBody(btCollisionObject* body);
 	~RigidBody();
 	void SetTransform(XMMATRIX transform);
 	void SetTransform(XMVECTOR position, XMVECTOR rotation);
@@ -34,6 +35,14 @@ public:
 	void SetGravity(float gravity);
 	bool IsTrigger();
 
+	// the listener is told whenever the simulation moves the body
+	void SetMotionStateListener(MotionStateListener* listener, U64 handle);
+
 protected:
-	btRigidBody* m_body;
+	// rigid bodies move through their motion state, trigger ghosts are moved directly
+	void ReadTransform(btTransform& t);
+	void WriteTransform(const btTransform& t);
+
+	// either a btRigidBody or, for triggers, a btPairCachingGhostObject
+	btCollisionObject* m_body;
 };
\ No newline at end of file
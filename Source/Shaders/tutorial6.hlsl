@@ -12,6 +12,30 @@ cbuffer Constants : register(b0)
 	float4 specularColor;
 }
 
+#ifdef QUANTIZED_VERTICES
+// set by the model, positions arrive as fractions of the mesh bounds
+cbuffer MeshConstants : register(b1)
+{
+	float3 positionScale;
+	float3 positionOffset;
+}
+
+struct VSInput
+{
+	float4 pos : POSITION;
+	float2 normal : NORMAL;
+	float2 uv : TEXCOORD0;
+	float4 color : TEXCOORD1;
+};
+
+float3 DecodeOctahedral(float2 e)
+{
+	float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+	float t = saturate(-n.z);
+	n.xy += n.xy >= 0.0f ? -t : t;
+	return normalize(n);
+}
+#else
 struct VSInput
 {
 	float3 pos : POSITION;
@@ -19,6 +43,7 @@ struct VSInput
 	float2 uv : TEXCOORD0;
 	float4 color : TEXCOORD1;
 };
+#endif
 
 struct PSInput
 {
@@ -31,13 +56,21 @@ struct PSInput
 
 PSInput vsmain(VSInput input)
 {
-	float4 worldPos = mul(float4(input.pos, 1.0f), worldMat);
+#ifdef QUANTIZED_VERTICES
+	float3 pos = input.pos.xyz * positionScale + positionOffset;
+	float3 inputNormal = DecodeOctahedral(input.normal);
+#else
+	float3 pos = input.pos;
+	float3 inputNormal = input.normal;
+#endif
+
+	float4 worldPos = mul(float4(pos, 1.0f), worldMat);
 
 	PSInput output;
 	output.pos = mul(worldPos, viewProjMat);
 	output.uv = input.uv;
 	output.color = input.color;
-	float3 normal = mul(input.normal, (float3x3)worldMat);
+	float3 normal = mul(inputNormal, (float3x3)worldMat);
 	output.normal = normal;
 	output.viewDir = cameraPos - worldPos;
 
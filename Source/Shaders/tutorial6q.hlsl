@@ -0,0 +1,3 @@
+// tutorial6 for meshes cooked with quantized vertices, load the vertex shader with VertPosNormUVColorQuantized
+#define QUANTIZED_VERTICES
+#include "tutorial6.hlsl"
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Types.h"
+#include <stddef.h>
 
 typedef U32 StringId;
 
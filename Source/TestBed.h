@@ -67,110 +67,91 @@ public:
 			nullptr))
 			return false;
 
-		U64 handle;
+		Handle<VertexShader> hVsBase;
+		Handle<VertexShader> hVsBaseQ;
+		Handle<PixelShader> hPsBase;
 
 		// Load shaders
-		VertexShader* vsBase;
-		PixelShader* psBase;
-
-		if (!m_resourceManager.LoadVertexShader("Shaders/tutorial6.hlsl", handle, VertPosNormUVColor::GetVertexFormat(), "vsbase"_sid))
+		if (!m_resourceManager.LoadVertexShader("Shaders/tutorial6.hlsl", hVsBase, VertPosNormUVColor::GetVertexFormat(), "vsbase"_sid))
 		{
 			return false;
 		}
 
-		vsBase = static_cast<VertexShader*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadPixelShader("Shaders/tutorial6.hlsl", handle, "psbase"_sid))
+		// for meshes cooked with quantized vertices
+		if (!m_resourceManager.LoadVertexShader("Shaders/tutorial6q.hlsl", hVsBaseQ, VertPosNormUVColorQuantized::GetVertexFormat(), "vsbaseq"_sid))
 		{
 			return false;
 		}
 
-		psBase = static_cast<PixelShader*>(m_resourceManager.GetResourceByHandle(handle));
-
-		// Load models
-		Model* modelMonkey;
-		Model* modelCube;
-		Model* modelSphere;
-		Model* modelCylinder;
-		Model* modelCone;
-
-		if (!m_resourceManager.LoadModel("Assets/monkey.obj", handle, "Assets/monkey.obj"_sid))
+		if (!m_resourceManager.LoadPixelShader("Shaders/tutorial6.hlsl", hPsBase, "psbase"_sid))
 		{
 			return false;
 		}
 
-		modelMonkey = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
+		// Load models
+		Handle<Model> modelMonkey;
+		Handle<Model> modelCube;
+		Handle<Model> modelSphere;
+		Handle<Model> modelCylinder;
+		Handle<Model> modelCone;
 
-		if (!m_resourceManager.LoadModel("Assets/cube.obj", handle, "Assets/cube.obj"_sid))
+		if (!m_resourceManager.LoadModel("Assets/monkey.mesh", modelMonkey, "Assets/monkey.mesh"_sid))
 		{
 			return false;
 		}
 
-		modelCube = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadModel("Assets/sphere.obj", handle, "Assets/sphere.obj"_sid))
+		if (!m_resourceManager.LoadModel("Assets/cube.mesh", modelCube, "Assets/cube.mesh"_sid))
 		{
 			return false;
 		}
 
-		modelSphere = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadModel("Assets/sphere.obj", handle, "Assets/sphere.obj"_sid))
+		if (!m_resourceManager.LoadModel("Assets/sphere.mesh", modelSphere, "Assets/sphere.mesh"_sid))
 		{
 			return false;
 		}
 
-		modelSphere = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadModel("Assets/cylinder.obj", handle, "Assets/cylinder.obj"_sid))
+		if (!m_resourceManager.LoadModel("Assets/cylinder.mesh", modelCylinder, "Assets/cylinder.mesh"_sid))
 		{
 			return false;
 		}
 
-		modelCylinder = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadModel("Assets/cone.obj", handle, "Assets/cone.obj"_sid))
+		if (!m_resourceManager.LoadModel("Assets/cone.mesh", modelCone, "Assets/cone.mesh"_sid))
 		{
 			return false;
 		}
 
-		modelCone = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
 		// Load textures
-		Texture* texStone;
-		Texture* texSeafloor;
+		Handle<Texture> texStone;
+		Handle<Texture> texSeafloor;
 
-		if (!m_resourceManager.LoadTexture("Assets/stone.tga", handle, "Assets/stone.tga"_sid))
+		if (!m_resourceManager.LoadTexture("Assets/stone.tex", texStone, "Assets/stone.tex"_sid))
 		{
 			return false;
 		}
 
-		texStone = static_cast<Texture*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadTexture("Assets/seafloor.tga", handle, "Assets/seafloor.tga"_sid))
+		if (!m_resourceManager.LoadTexture("Assets/seafloor.tex", texSeafloor, "Assets/seafloor.tex"_sid))
 		{
 			return false;
 		}
 
-		texSeafloor = static_cast<Texture*>(m_resourceManager.GetResourceByHandle(handle));
-
-		// Load materials
-		Material* matStone;
-		Material* matSand;
-
-		m_resourceManager.CreateMaterial(handle, "Stone"_sid);
-		matStone = static_cast<Material*>(m_resourceManager.GetResourceByHandle(handle));
-		matStone->SetShaders(vsBase, psBase);
-		matStone->SetConstantBuffer(0, m_cb);
-		matStone->AddTexture(*texStone);
-		matStone->AddShaderSampler(m_graphics.GetLinearWrapSampler());
-
-		m_resourceManager.CreateMaterial(handle, "Sand"_sid);
-		matSand = static_cast<Material*>(m_resourceManager.GetResourceByHandle(handle));
-		matSand->SetShaders(vsBase, psBase);
-		matSand->SetConstantBuffer(0, m_cb);
-		matSand->AddTexture(*texSeafloor);
-		matSand->AddShaderSampler(m_graphics.GetLinearWrapSampler());
+		// Load materials, they resolve the shaders and textures by handle when drawn
+		Handle<Material> matStone;
+		Handle<Material> matSand;
+		Material* material;
+
+		m_resourceManager.CreateMaterial(matStone, "Stone"_sid);
+		material = m_resourceManager.GetResourceByHandle(matStone);
+		material->SetShaders(hVsBase, hPsBase, hVsBaseQ);
+		material->SetConstantBuffer(0, m_cb);
+		material->AddTexture(texStone);
+		material->AddShaderSampler(m_graphics.GetLinearWrapSampler());
+
+		m_resourceManager.CreateMaterial(matSand, "Sand"_sid);
+		material = m_resourceManager.GetResourceByHandle(matSand);
+		material->SetShaders(hVsBase, hPsBase, hVsBaseQ);
+		material->SetConstantBuffer(0, m_cb);
+		material->AddTexture(texSeafloor);
+		material->AddShaderSampler(m_graphics.GetLinearWrapSampler());
 
 		// Create render targets
 
@@ -215,10 +196,10 @@ public:
 		m_rbGunSystem.StartUp(1, m_entityManager, m_transformSystem, m_primFactory, m_inputManager,
 			                  m_eventBus, m_rbBulletSystem);
 		m_kinematicRBSystem.StartUp(1, m_entityManager, m_transformSystem, m_rigidBodySystem);
-		m_rbBulletSystem.StartUp(1, m_entityManager, m_eventBus);
-		m_kinematicCCSystem.StartUp(1, m_entityManager, m_transformSystem, m_eventBus);
+		m_rbBulletSystem.StartUp(1, m_entityManager, m_physics);
+		m_kinematicCCSystem.StartUp(1, m_entityManager, m_transformSystem, m_physics);
 		m_doorSystem.StartUp(1, m_entityManager, m_transformSystem, m_eventBus);
-		m_doorTriggerSystem.StartUp(1, m_entityManager, m_eventBus);
+		m_doorTriggerSystem.StartUp(1, m_entityManager, m_eventBus, m_physics);
 
 
 		// Create Entities
@@ -258,8 +239,7 @@ public:
 		hTransform = m_transformSystem.CreateComponent(e, Vector3(-25, 10, 25), Quaternion(90.0_rad, 0, 0), Vector3(5, 1, 5));
 		transform = m_transformSystem.GetComponentByHandle(hTransform);
 		m_meshSystem.CreateComponent(e, hTransform, modelCube, matSand);
-		collider = m_physics.CreateCollisionBox(1, 1, 1);
-		collider.SetScale(transform->scale);
+		collider = m_physics.CreateCollisionBox(1, 1, 1, transform->scale);
 		rb = m_physics.CreateKinematicRigidBody(e, collider, transform->position, transform->rotation);
 		hRigidBody = m_rigidBodySystem.CreateComponent(e, rb);
 		m_kinematicRBSystem.CreateComponent(e, hTransform, hRigidBody);
@@ -272,9 +252,8 @@ public:
 															XMVectorSet(3, 3, 3, 1));
 		transform = m_transformSystem.GetComponentByHandle(hTransform);
 		m_meshSystem.CreateComponent(e, hTransform, modelCube, matStone);
-		collider = m_physics.CreateCollisionBox(1, 1, 1);
-		collider.SetScale(transform->scale);
-		rb = m_physics.CreateStaticRigidBody(e, collider, transform->position, transform->rotation, true);
+		collider = m_physics.CreateCollisionBox(1, 1, 1, transform->scale);
+		rb = m_physics.CreateTrigger(e, collider, transform->position, transform->rotation);
 		m_rigidBodySystem.CreateComponent(e, rb);
 		m_doorTriggerSystem.CreateComponent(e, doorEntity);
 		
@@ -289,8 +268,7 @@ public:
 		transform = m_transformSystem.GetComponentByHandle(hTransform);
 		m_meshSystem.CreateComponent(e, hTransform, modelCube, matStone);
 		m_rotatorSystem.CreateComponent(e, hTransform, 2, XMQuaternionIdentity());
-		collider = m_physics.CreateCollisionBox(1, 1, 1);
-		collider.SetScale(transform->scale);
+		collider = m_physics.CreateCollisionBox(1, 1, 1, transform->scale);
 		rb = m_physics.CreateKinematicRigidBody(e, collider, transform->position, transform->rotation);
 		hRigidBody = m_rigidBodySystem.CreateComponent(e, rb);
 		m_kinematicRBSystem.CreateComponent(e, hTransform, hRigidBody);
@@ -338,6 +316,7 @@ public:
 		m_doorSystem.Execute(dt);
 		m_kinematicRBSystem.Execute(dt);
 		m_physics.RunSimulation(dt);
+		AccumulatePhysicsStats();
 		m_dynamicRBSystem.Execute(dt);
 		m_yDespawnSystem.Execute(dt);
 		m_transformSystem.Execute(dt);
@@ -363,20 +342,65 @@ public:
 
 		m_rtState.Begin(m_graphics);
 
+		float pixelsPerUnit = m_cameraSystem.GetPixelsPerUnit(m_cameraSystem[0]);
 		for (int i = 0; i < m_meshSystem.Size(); ++i)
 		{
 			MeshComponent* mesh = m_meshSystem[i];
+			Model* model = m_resourceManager.GetResourceByHandle(mesh->model);
+			Material* material = m_resourceManager.GetResourceByHandle(mesh->material);
+			if (model == nullptr || material == nullptr || model->GetState() != RESOURCE_READY)
+			{
+				continue;
+			}
+
 			consts.m_world = m_transformSystem.GetComponentByHandle(mesh->transform)->world;
 			m_cb.MapAndSet(m_graphics, consts);
 
-			mesh->model->Select(m_graphics);
-			mesh->material->Select(m_graphics);
-			mesh->model->Draw(m_graphics);
+			if (!material->Select(m_graphics, m_resourceManager, model->IsQuantized()))
+			{
+				continue;
+			}
+
+			unsigned int lod = model->SelectLod(consts.m_world, consts.m_cameraPos, pixelsPerUnit);
+			model->Select(m_graphics, lod);
+			model->Draw(m_graphics, lod);
 		}
 
 		m_rtState.End(m_graphics);
 	}
 
+private:
+	// averages the physics step stats and logs them every few seconds so a slow step can be put down to a phase
+	void AccumulatePhysicsStats()
+	{
+		const PhysicsStepStats& stats = m_physics.GetStepStats();
+		for (int i = 0; i < NUM_PHYSICS_PHASES; ++i)
+		{
+			m_physicsPhaseMs[i] += stats.phaseMs[i];
+		}
+		m_physicsStepMs += stats.totalMs;
+
+		if (++m_physicsStatFrames < PHYSICS_STAT_FRAMES)
+		{
+			return;
+		}
+
+		float scale = 1.f / m_physicsStatFrames;
+		DEBUG_PRINT("physics %.3f ms: broadphase %.3f narrowphase %.3f solver %.3f integration %.3f callbacks %.3f other %.3f",
+			m_physicsStepMs * scale, m_physicsPhaseMs[PHYSICS_PHASE_BROADPHASE] * scale, m_physicsPhaseMs[PHYSICS_PHASE_NARROWPHASE] * scale,
+			m_physicsPhaseMs[PHYSICS_PHASE_SOLVER] * scale, m_physicsPhaseMs[PHYSICS_PHASE_INTEGRATION] * scale,
+			m_physicsPhaseMs[PHYSICS_PHASE_CALLBACKS] * scale, m_physicsPhaseMs[PHYSICS_PHASE_OTHER] * scale);
+		DEBUG_PRINT("physics last step: %u active bodies, %u pairs, %u manifolds, %u contacts, %u islands",
+			stats.numActiveBodies, stats.numOverlappingPairs, stats.numManifolds, stats.numContacts, stats.numIslands);
+
+		m_physicsStatFrames = 0;
+		m_physicsStepMs = 0;
+		for (int i = 0; i < NUM_PHYSICS_PHASES; ++i)
+		{
+			m_physicsPhaseMs[i] = 0;
+		}
+	}
+
 private:
 	// rendering instances
 	RenderTargetState m_rtState;
@@ -401,6 +425,12 @@ private:
 	DoorSystem m_doorSystem;
 	DoorTriggerSystem m_doorTriggerSystem;
 
+	// physics stats summed since they were last logged
+	static const U32 PHYSICS_STAT_FRAMES = 300;
+	float m_physicsPhaseMs[NUM_PHYSICS_PHASES] = {};
+	float m_physicsStepMs = 0;
+	U32 m_physicsStatFrames = 0;
+
 	// other
 	PrimitiveFactory m_primFactory;
 };
\ No newline at end of file
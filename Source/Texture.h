@@ -2,16 +2,19 @@
 
 #include "Graphics.h"
 #include "Resource.h"
+#include "TextureFile.h"
 
 class Texture : public Resource
 {
 public:
+	static const ResourceType TYPE = RESOURCE_TEXTURE;
+
 	~Texture()
 	{
 		ShutDown();
 	}
 
-	virtual void ShutDown() override
+	void ShutDown()
 	{
 		if (m_srv != nullptr)
 		{
@@ -28,12 +31,80 @@ public:
 
 	bool Load(Graphics& graphics, const wchar_t* fileName)
 	{
-		m_texture = graphics.CreateTextureFromTGAFile(fileName);
+		DirectX::ScratchImage image;
+		if (!graphics.LoadImageFromTGAFile(fileName, image))
+		{
+			return false;
+		}
+
+		return Create(graphics, image);
+	}
+
+	// creates the texture from a cooked .tex file, mips and block compression were done offline.
+	// data is only read during the call
+	bool Create(Graphics& graphics, const TextureFileHeader* header)
+	{
+		// UNORM like the TGA path so cooked textures look the same, the file's sRGB flag is there for when the
+		// shaders move to sRGB views
+		static const DXGI_FORMAT FORMATS[NUM_TEXTURE_FORMATS] =
+		{
+			DXGI_FORMAT_R8G8B8A8_UNORM,
+			DXGI_FORMAT_BC1_UNORM,
+			DXGI_FORMAT_BC3_UNORM,
+		};
+
+		D3D11_SUBRESOURCE_DATA mips[MAX_TEXTURE_MIPS];
+		for (U32 i = 0; i < header->numMips; ++i)
+		{
+			mips[i].pSysMem = GetTextureMipData(header, i);
+			mips[i].SysMemPitch = header->mips[i].rowPitch;
+			mips[i].SysMemSlicePitch = header->mips[i].size;
+		}
+
+		D3D11_TEXTURE2D_DESC desc;
+		desc.Width = header->width;
+		desc.Height = header->height;
+		desc.MipLevels = header->numMips;
+		desc.ArraySize = 1;
+		desc.Format = FORMATS[header->format];
+		desc.SampleDesc.Count = 1;
+		desc.SampleDesc.Quality = 0;
+		desc.Usage = D3D11_USAGE_IMMUTABLE;
+		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+		desc.CPUAccessFlags = 0;
+		desc.MiscFlags = 0;
+
+		m_texture = graphics.CreateTexture2D(desc, mips);
 		if (!m_texture)
 		{
 			return false;
 		}
 
+		for (U32 i = 0; i < header->numMips; ++i)
+		{
+			AddMemorySize(header->mips[i].size);
+		}
+
+		m_srv = graphics.CreateShaderResource(m_texture);
+		if (!m_srv)
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	// second half of a load, the image was decoded on a loader thread and the device objects are made here
+	bool Create(Graphics& graphics, const DirectX::ScratchImage& image)
+	{
+		m_texture = graphics.CreateTextureFromImage(image);
+		if (!m_texture)
+		{
+			return false;
+		}
+
+		AddMemorySize(image.GetPixelsSize());
+
 		m_srv = graphics.CreateShaderResource(m_texture);
 		if (!m_srv)
 		{
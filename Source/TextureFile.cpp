@@ -0,0 +1,39 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "TextureFile.h"
+#include "WriteLog.h"
+#include <stdio.h>
+
+
+const TextureFileHeader* ReadTextureFile(const char* path, std::vector<U8>& data)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == nullptr)
+	{
+		DEBUG_ERROR("Could not open file: %s", path);
+		return nullptr;
+	}
+
+	long size = -1;
+	if (fseek(file, 0, SEEK_END) == 0)
+	{
+		size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+	}
+
+	bool read = size > 0;
+	if (read)
+	{
+		data.resize((size_t)size);
+		read = fread(data.data(), 1, data.size(), file) == data.size();
+	}
+	fclose(file);
+
+	const TextureFileHeader* header = read ? ValidateTextureFile(data.data(), data.size()) : nullptr;
+	if (header == nullptr)
+	{
+		DEBUG_ERROR("Invalid texture file: %s", path);
+	}
+
+	return header;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Types.h"
+#include <stddef.h>
+#include <vector>
+
+// Cooked texture file written by the asset cooker from a TGA source, the whole file is read with one call at load
+// time and the mips are handed to texture creation where they lie.
+// Layout: TextureFileHeader, then every mip from the largest down, each starting on a 16 byte boundary.
+
+
+static const U32 TEXTURE_FILE_MAGIC = 0x58455443;	// "CTEX"
+static const U32 TEXTURE_FILE_VERSION = 1;
+static const U32 TEXTURE_FILE_ALIGNMENT = 16;
+static const U32 MAX_TEXTURE_MIPS = 16;
+
+
+enum TextureFileFormat
+{
+	TEXTURE_FORMAT_RGBA8,		// R8G8B8A8, for sizes that don't fit in 4x4 blocks
+	TEXTURE_FORMAT_BC1,			// 8 bytes per 4x4 block, opaque colour
+	TEXTURE_FORMAT_BC3,			// 16 bytes per 4x4 block, colour and alpha
+	NUM_TEXTURE_FORMATS
+};
+
+
+// texels are sRGB encoded and the mips were filtered in linear light
+static const U32 TEXTURE_FILE_SRGB = 1 << 0;
+
+
+struct TextureMip
+{
+	U64 offset;				// from the start of the file
+	U32 size;
+	U32 rowPitch;			// bytes per row of texels, or of blocks for compressed formats
+};
+
+
+struct TextureFileHeader
+{
+	U32 magic;
+	U32 version;
+	U32 format;
+	U32 flags;
+	U32 width;
+	U32 height;
+	U32 numMips;
+	U32 reserved;
+	TextureMip mips[MAX_TEXTURE_MIPS];
+};
+
+
+inline U64 AlignTextureOffset(U64 offset)
+{
+	return (offset + TEXTURE_FILE_ALIGNMENT - 1) & ~(U64)(TEXTURE_FILE_ALIGNMENT - 1);
+}
+
+
+inline U32 GetTextureMipDimension(U32 size, U32 mip)
+{
+	U32 dim = size >> mip;
+	return dim > 0 ? dim : 1;
+}
+
+
+inline U32 GetTextureRowPitch(U32 format, U32 width)
+{
+	switch (format)
+	{
+	case TEXTURE_FORMAT_RGBA8: return width * 4;
+	case TEXTURE_FORMAT_BC1: return (width + 3) / 4 * 8;
+	case TEXTURE_FORMAT_BC3: return (width + 3) / 4 * 16;
+	default: return 0;
+	}
+}
+
+
+inline U32 GetTextureNumRows(U32 format, U32 height)
+{
+	return format == TEXTURE_FORMAT_RGBA8 ? height : (height + 3) / 4;
+}
+
+
+// checks a loaded file before its mips are used, returns the header or null if the file is damaged or out of date
+inline const TextureFileHeader* ValidateTextureFile(const void* data, size_t size)
+{
+	if (size < sizeof(TextureFileHeader))
+	{
+		return nullptr;
+	}
+
+	const TextureFileHeader* header = static_cast<const TextureFileHeader*>(data);
+	if (header->magic != TEXTURE_FILE_MAGIC || header->version != TEXTURE_FILE_VERSION || header->format >= NUM_TEXTURE_FORMATS ||
+		header->width == 0 || header->height == 0 || header->numMips == 0 || header->numMips > MAX_TEXTURE_MIPS)
+	{
+		return nullptr;
+	}
+
+	for (U32 i = 0; i < header->numMips; ++i)
+	{
+		const TextureMip& mip = header->mips[i];
+		U32 rowPitch = GetTextureRowPitch(header->format, GetTextureMipDimension(header->width, i));
+		U32 numRows = GetTextureNumRows(header->format, GetTextureMipDimension(header->height, i));
+		if (mip.rowPitch != rowPitch || mip.size != (U64)rowPitch * numRows || mip.offset % TEXTURE_FILE_ALIGNMENT != 0 ||
+			mip.offset < sizeof(TextureFileHeader) || mip.offset + mip.size > size)
+		{
+			return nullptr;
+		}
+	}
+
+	return header;
+}
+
+
+inline const U8* GetTextureMipData(const TextureFileHeader* header, U32 mip)
+{
+	return reinterpret_cast<const U8*>(header) + header->mips[mip].offset;
+}
+
+
+// reads the whole file with a single read, returns the validated header inside data or null
+const TextureFileHeader* ReadTextureFile(const char* path, std::vector<U8>& data);
\ No newline at end of file
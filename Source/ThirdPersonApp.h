@@ -26,11 +26,10 @@
 #include "PivotCamSystem.h"
 #include "KinematicGravitySystem.h"
 #include "RigidBodySystem.h"
-#include "LegCastSystem.h"
 #include "MovementSystem.h"
 #include "VelocitySystem.h"
 #include "KinematicRigidBodySystem.h"
-#include "KinematicCharacterControllerSystem.h"
+#include "CharacterControllerSystem.h"
 #include "JumpSystem.h"
 #include "CoinSystem.h"
 #include "RotatorSystem.h"
@@ -43,6 +42,8 @@
 #include "DoorTriggerSystem.h"
 #include "EndTriggerSystem.h"
 
+#include <chrono>
+
 // preprocessor directives
 #define SHOW_TRIGGERS false;
 
@@ -76,172 +77,53 @@ public:
 			nullptr))
 			return false;
 
-		U64 handle;
+		// every startup resource is read and decoded on the loader threads at once,
+		// the device objects are made here when the group is waited on
+		static const U32 STARTUP_GROUP = 1;
+		auto loadStart = std::chrono::steady_clock::now();
 
 		// Load shaders
-		VertexShader* vsBase;
-		PixelShader* psBase;
-
-		if (!m_resourceManager.LoadVertexShader("Shaders/tutorial6.hlsl", handle, VertPosNormUVColor::GetVertexFormat(), "vsbase"_sid))
-		{
-			return false;
-		}
-
-		vsBase = static_cast<VertexShader*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadPixelShader("Shaders/tutorial6.hlsl", handle, "psbase"_sid))
-		{
-			return false;
-		}
-
-		psBase = static_cast<PixelShader*>(m_resourceManager.GetResourceByHandle(handle));
+		Handle<VertexShader> hVsBase = m_resourceManager.LoadVertexShaderAsync("Shaders/tutorial6.hlsl", VertPosNormUVColor::GetVertexFormat(), "vsbase"_sid, STARTUP_GROUP);
+		Handle<VertexShader> hVsBaseQ = m_resourceManager.LoadVertexShaderAsync("Shaders/tutorial6q.hlsl", VertPosNormUVColorQuantized::GetVertexFormat(), "vsbaseq"_sid, STARTUP_GROUP);
+		Handle<PixelShader> hPsBase = m_resourceManager.LoadPixelShaderAsync("Shaders/tutorial6.hlsl", "psbase"_sid, STARTUP_GROUP);
 
 		// Load models
-		Model* modelMonkey;
-		Model* modelCube;
-		Model* modelSphere;
-		Model* modelCylinder;
-		Model* modelCone;
-		Model* modelCapsule;
-
-		if (!m_resourceManager.LoadModel("Assets/monkey.obj", handle, "Assets/monkey.obj"_sid))
-		{
-			return false;
-		}
-
-		modelMonkey = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadModel("Assets/cube.obj", handle, "Assets/cube.obj"_sid))
-		{
-			return false;
-		}
-
-		modelCube = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadModel("Assets/sphere.obj", handle, "Assets/sphere.obj"_sid))
-		{
-			return false;
-		}
-
-		modelSphere = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadModel("Assets/cylinder.obj", handle, "Assets/cylinder.obj"_sid))
-		{
-			return false;
-		}
-
-		modelCylinder = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadModel("Assets/cone.obj", handle, "Assets/cone.obj"_sid))
-		{
-			return false;
-		}
-
-		modelCone = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadModel("Assets/capsule.obj", handle, "Assets/capsule.obj"_sid))
-		{
-			return false;
-		}
-
-		modelCapsule = static_cast<Model*>(m_resourceManager.GetResourceByHandle(handle));
+		Handle<Model> hMonkey = m_resourceManager.LoadModelAsync("Assets/monkey.mesh", "Assets/monkey.mesh"_sid, STARTUP_GROUP);
+		Handle<Model> hCube = m_resourceManager.LoadModelAsync("Assets/cube.mesh", "Assets/cube.mesh"_sid, STARTUP_GROUP);
+		Handle<Model> hSphere = m_resourceManager.LoadModelAsync("Assets/sphere.mesh", "Assets/sphere.mesh"_sid, STARTUP_GROUP);
+		Handle<Model> hCylinder = m_resourceManager.LoadModelAsync("Assets/cylinder.mesh", "Assets/cylinder.mesh"_sid, STARTUP_GROUP);
+		Handle<Model> hCone = m_resourceManager.LoadModelAsync("Assets/cone.mesh", "Assets/cone.mesh"_sid, STARTUP_GROUP);
+		Handle<Model> hCapsule = m_resourceManager.LoadModelAsync("Assets/capsule.mesh", "Assets/capsule.mesh"_sid, STARTUP_GROUP);
 
 		// Load textures
-		Texture* texStone;
-		Texture* texSeafloor;
-		Texture* texdanger;
-		Texture* texGold;
-		Texture* texBlank;
-
-		if (!m_resourceManager.LoadTexture("Assets/stone.tga", handle, "Assets/stone.tga"_sid))
-		{
-			return false;
-		}
-
-		texStone = static_cast<Texture*>(m_resourceManager.GetResourceByHandle(handle));
+		Handle<Texture> hStone = m_resourceManager.LoadTextureAsync("Assets/stone.tex", "Assets/stone.tex"_sid, STARTUP_GROUP);
+		Handle<Texture> hSeafloor = m_resourceManager.LoadTextureAsync("Assets/seafloor.tex", "Assets/seafloor.tex"_sid, STARTUP_GROUP);
+		Handle<Texture> hDanger = m_resourceManager.LoadTextureAsync("Assets/danger.tex", "Assets/danger.tex"_sid, STARTUP_GROUP);
+		Handle<Texture> hGold = m_resourceManager.LoadTextureAsync("Assets/gold.tex", "Assets/gold.tex"_sid, STARTUP_GROUP);
+		Handle<Texture> hBlank = m_resourceManager.LoadTextureAsync("Assets/blank.tex", "Assets/blank.tex"_sid, STARTUP_GROUP);
 
-		if (!m_resourceManager.LoadTexture("Assets/seafloor.tga", handle, "Assets/seafloor.tga"_sid))
+		if (!m_resourceManager.WaitForGroup(STARTUP_GROUP))
 		{
 			return false;
 		}
 
-		texSeafloor = static_cast<Texture*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadTexture("Assets/danger.tga", handle, "Assets/danger.tga"_sid))
-		{
-			return false;
-		}
-
-		texdanger = static_cast<Texture*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadTexture("Assets/gold.tga", handle, "Assets/gold.tga"_sid))
-		{
-			return false;
-		}
+		DEBUG_PRINT("Startup resources loaded in %.1f ms",
+			std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count());
 
-		texGold = static_cast<Texture*>(m_resourceManager.GetResourceByHandle(handle));
-
-		if (!m_resourceManager.LoadTexture("Assets/blank.tga", handle, "Assets/blank.tga"_sid))
-		{
-			return false;
-		}
-
-		texBlank = static_cast<Texture*>(m_resourceManager.GetResourceByHandle(handle));
-
-		// Load materials
-		Material* matStone;
-		Material* matSand;
-		Material* matdanger;
-		Material* matGold;
-		Material* matBlank;
-
-		m_resourceManager.CreateMaterial(handle, "Stone"_sid);
-		matStone = static_cast<Material*>(m_resourceManager.GetResourceByHandle(handle));
-		matStone->SetShaders(vsBase, psBase);
-		matStone->SetConstantBuffer(0, m_cb);
-		matStone->AddTexture(*texStone);
-		matStone->AddShaderSampler(m_graphics.GetLinearWrapSampler());
-
-		m_resourceManager.CreateMaterial(handle, "Sand"_sid);
-		matSand = static_cast<Material*>(m_resourceManager.GetResourceByHandle(handle));
-		matSand->SetShaders(vsBase, psBase);
-		matSand->SetConstantBuffer(0, m_cb);
-		matSand->AddTexture(*texSeafloor);
-		matSand->AddShaderSampler(m_graphics.GetLinearWrapSampler());
-
-		m_resourceManager.CreateMaterial(handle, "Danger"_sid);
-		matdanger = static_cast<Material*>(m_resourceManager.GetResourceByHandle(handle));
-		matdanger->SetShaders(vsBase, psBase);
-		matdanger->SetConstantBuffer(0, m_cb);
-		matdanger->AddTexture(*texdanger);
-		matdanger->AddShaderSampler(m_graphics.GetLinearWrapSampler());
-
-		m_resourceManager.CreateMaterial(handle, "Gold"_sid);
-		matGold = static_cast<Material*>(m_resourceManager.GetResourceByHandle(handle));
-		matGold->SetShaders(vsBase, psBase);
-		matGold->SetConstantBuffer(0, m_cb);
-		matGold->AddTexture(*texGold);
-		matGold->AddShaderSampler(m_graphics.GetLinearWrapSampler());
-
-		m_resourceManager.CreateMaterial(handle, "Blank"_sid);
-		matBlank = static_cast<Material*>(m_resourceManager.GetResourceByHandle(handle));
-		matBlank->SetShaders(vsBase, psBase);
-		matBlank->SetConstantBuffer(0, m_cb);
-		matBlank->AddTexture(*texBlank);
-		matBlank->AddShaderSampler(m_graphics.GetLinearWrapSampler());
+		// Load materials, they resolve the shaders and textures by handle when drawn
+		m_stone = MakeMaterial("Stone"_sid, hVsBase, hVsBaseQ, hPsBase, hStone);
+		m_sand = MakeMaterial("Sand"_sid, hVsBase, hVsBaseQ, hPsBase, hSeafloor);
+		m_danger = MakeMaterial("Danger"_sid, hVsBase, hVsBaseQ, hPsBase, hDanger);
+		m_gold = MakeMaterial("Gold"_sid, hVsBase, hVsBaseQ, hPsBase, hGold);
+		m_blank = MakeMaterial("Blank"_sid, hVsBase, hVsBaseQ, hPsBase, hBlank);
 
 		// Add resources to app (used for factory functions)
-		m_monkey = modelMonkey;
-		m_cube = modelCube;
-		m_sphere = modelSphere;
-		m_cone = modelCone;
-		m_capsule = modelCapsule;
-		m_cylinder = modelCylinder;
-		m_stone = matStone;
-		m_sand = matSand;
-		m_danger = matdanger;
-		m_gold = matGold;
-		m_blank = matBlank;
+		m_monkey = hMonkey;
+		m_cube = hCube;
+		m_sphere = hSphere;
+		m_cone = hCone;
+		m_capsule = hCapsule;
+		m_cylinder = hCylinder;
 
 		// Create render targets
 
@@ -275,24 +157,27 @@ public:
 		m_cameraSystem.StartUp(1, m_entityManager, m_transformSystem, m_window);
 		m_meshSystem.StartUp(2, m_entityManager);
 		m_pivotCamSystem.StartUp(1, m_entityManager, m_transformSystem, m_inputManager);
-		m_gravitySystem.StartUp(1, m_entityManager, m_transformSystem, m_velocitySystem, m_legCastSystem);
+		m_gravitySystem.StartUp(1, m_entityManager, m_transformSystem, m_velocitySystem);
 		m_rigidBodySystem.StartUp(2, m_entityManager, m_physics);
-		m_legCastSystem.StartUp(1, m_entityManager, m_transformSystem, m_physics, m_velocitySystem);
 		m_movementSystem.StartUp(1, m_entityManager, m_transformSystem, m_inputManager, m_pivotCamSystem, m_velocitySystem);
 		m_velocitySystem.StartUp(1, m_entityManager, m_transformSystem, m_physics);
 		m_kinematicRBSystem.StartUp(1, m_entityManager, m_transformSystem, m_rigidBodySystem);
-		m_kinematicCCSystem.StartUp(1, m_entityManager, m_transformSystem, m_eventBus);
-		m_jumpSystem.StartUp(1, m_entityManager, m_velocitySystem, m_legCastSystem, m_inputManager);
-		m_coinSystem.StartUp(5, m_entityManager, m_eventBus);
+		m_characterControllerSystem.StartUp(1, m_entityManager, m_transformSystem, m_velocitySystem, m_rigidBodySystem, m_physics);
+		m_jumpSystem.StartUp(1, m_entityManager, m_velocitySystem, m_characterControllerSystem, m_inputManager);
+		m_coinSystem.StartUp(5, m_entityManager, m_physics);
 		m_rotatorSystem.StartUp(5, m_entityManager, m_transformSystem);
 		m_spawnSystem.StartUp(1, m_entityManager);
-		m_deadlyTouchSystem.StartUp(1, m_entityManager, m_eventBus);
+		m_deadlyTouchSystem.StartUp(1, m_entityManager, m_eventBus, m_physics);
 		m_deathSystem.StartUp(1, m_entityManager, m_eventBus, m_transformSystem, m_velocitySystem, m_spawnSystem);
-		m_checkpointTriggerSystem.StartUp(1, m_entityManager, m_eventBus, m_spawnSystem);
+		m_checkpointTriggerSystem.StartUp(1, m_entityManager, m_physics, m_spawnSystem);
 		m_pistonSystem.StartUp(1, m_entityManager, m_transformSystem);
 		m_doorSystem.StartUp(1, m_entityManager, m_transformSystem, m_eventBus);
-		m_doorTriggerSystem.StartUp(1, m_entityManager, m_eventBus);
-		m_endTriggerSystem.StartUp(1, m_entityManager, m_eventBus, m_timer, m_deathSystem, m_coinSystem);
+		m_doorTriggerSystem.StartUp(1, m_entityManager, m_eventBus, m_physics);
+		m_endTriggerSystem.StartUp(1, m_entityManager, m_physics, m_timer, m_deathSystem, m_coinSystem);
+
+		// the character controller sweeps against static geometry itself, so those contacts would go unused.
+		// kinematic contacts stay on, doors and platforms report touching the character
+		m_physics.SetLayerCollision(LAYER_CHARACTER, LAYER_STATIC, false);
 
 		// Create Entities
 		Entity e;
@@ -314,6 +199,11 @@ public:
 		e = m_entityManager.CreateEntity();
 		m_spawnSystem.CreateComponent(e, Vector3(0, 3, -8), Quaternion(0, 180.0_rad, 0));
 
+		// monkey statue on the starting wall, its mesh is cooked with quantized vertices
+		e = m_entityManager.CreateEntity();
+		hTransform = m_transformSystem.CreateComponent(e, Vector3(0, 5, 0), Quaternion(0, 180.0_rad, 0), Vector3(1.5));
+		m_meshSystem.CreateComponent(e, hTransform, m_monkey, m_gold);
+
 		// player
 		e = m_entityManager.CreateEntity();
 		Entity player = e;
@@ -321,17 +211,17 @@ public:
 		hTransform = m_transformSystem.CreateComponent(e, defaultSpawn->position, defaultSpawn->rotation);
 		transform = m_transformSystem.GetComponentByHandle(hTransform);
 		hVelocity = m_velocitySystem.CreateComponent(e, hTransform);
-		m_meshSystem.CreateComponent(e, hTransform, modelCapsule, matSand);
+		m_meshSystem.CreateComponent(e, hTransform, m_capsule, m_sand);
 		U64 hPivotCam = m_pivotCamSystem.CreateComponent(e, hTransform, hCamTransform, 5, 5);
-		U64 hLegCast =  m_legCastSystem.CreateComponent(e, hTransform, hVelocity, 1.5);
-		m_gravitySystem.CreateComponent(e, hTransform, hVelocity, hLegCast, 0.3);
-		m_movementSystem.CreateComponent(e, hTransform, hPivotCam, hVelocity, 1);
-		m_jumpSystem.CreateComponent(e, hVelocity, hLegCast, 0.2);
+		// the character controller takes velocities in units per second
+		m_gravitySystem.CreateComponent(e, hTransform, hVelocity, 18);
+		m_movementSystem.CreateComponent(e, hTransform, hPivotCam, hVelocity, 60);
 		collider = m_physics.CreateCollisionCapsule(0.5, 1);
 		rb = m_physics.CreateCharacterBody(e, collider, transform->position, transform->rotation);
 		hRigidBody = m_rigidBodySystem.CreateComponent(e, rb);
 		m_kinematicRBSystem.CreateComponent(e, hTransform, hRigidBody);
-		m_kinematicCCSystem.CreateComponent(e, hTransform);
+		U64 hController = m_characterControllerSystem.CreateComponent(e, hTransform, hVelocity, hRigidBody);
+		m_jumpSystem.CreateComponent(e, hVelocity, hController, 12);
 		m_deathSystem.CreateComponent(e, hTransform, hVelocity);
 
 		// intro
@@ -430,9 +320,8 @@ public:
 		e = m_entityManager.CreateEntity();
 		hTransform = m_transformSystem.CreateComponent(e, Vector3(40, 24, 2.5), Quaternion(), Vector3(3, 3, 0.5));
 		transform = m_transformSystem.GetComponentByHandle(hTransform);
-		m_meshSystem.CreateComponent(e, hTransform, modelCube, matStone);
-		collider = m_physics.CreateCollisionBox(1, 1, 1);
-		collider.SetScale(transform->scale);
+		m_meshSystem.CreateComponent(e, hTransform, m_cube, m_stone);
+		collider = m_physics.CreateCollisionBox(1, 1, 1, transform->scale);
 		rb = m_physics.CreateKinematicRigidBody(e, collider, transform->position, transform->rotation);
 		hRigidBody = m_rigidBodySystem.CreateComponent(e, rb);
 		m_kinematicRBSystem.CreateComponent(e, hTransform, hRigidBody);
@@ -447,6 +336,9 @@ public:
 		e = MakeCoin(Vector3(40, 25, 13));
 		m_endTriggerSystem.CreateComponent(e, player);
 
+		// the level's platforms never move, merge them into one collider
+		m_physics.BakeStaticGeometry();
+
 		return true;
 	}
 
@@ -472,7 +364,7 @@ public:
 		m_movementSystem.Execute(dt);
 		m_jumpSystem.Execute(dt);
 		m_gravitySystem.Execute(dt);
-		m_velocitySystem.Execute(dt);
+		m_characterControllerSystem.Execute(dt);
 		m_rotatorSystem.Execute(dt);
 		m_pistonSystem.Execute(dt);
 		m_doorSystem.Execute(dt);
@@ -480,7 +372,6 @@ public:
 		m_kinematicRBSystem.Execute(dt);
 		m_physics.RunSimulation(dt);
 		
-		m_legCastSystem.Execute(dt);
 		m_pivotCamSystem.Execute(dt);
 		m_transformSystem.Execute(dt);
 		m_cameraSystem.Execute(dt);
@@ -507,15 +398,28 @@ public:
 
 		m_rtState.Begin(m_graphics);
 
+		float pixelsPerUnit = m_cameraSystem.GetPixelsPerUnit(m_cameraSystem[0]);
 		for (int i = 0; i < m_meshSystem.Size(); ++i)
 		{
 			MeshComponent* mesh = m_meshSystem[i];
+			Model* model = m_resourceManager.GetResourceByHandle(mesh->model);
+			Material* material = m_resourceManager.GetResourceByHandle(mesh->material);
+			if (model == nullptr || material == nullptr || model->GetState() != RESOURCE_READY)
+			{
+				continue;
+			}
+
 			consts.m_world = m_transformSystem.GetComponentByHandle(mesh->transform)->world;
 			m_cb.MapAndSet(m_graphics, consts);
 
-			mesh->model->Select(m_graphics);
-			mesh->material->Select(m_graphics);
-			mesh->model->Draw(m_graphics);
+			if (!material->Select(m_graphics, m_resourceManager, model->IsQuantized()))
+			{
+				continue;
+			}
+
+			unsigned int lod = model->SelectLod(consts.m_world, consts.m_cameraPos, pixelsPerUnit);
+			model->Select(m_graphics, lod);
+			model->Draw(m_graphics, lod);
 		}
 
 		m_rtState.End(m_graphics);
@@ -536,11 +440,10 @@ private:
 	PivotCamSystem m_pivotCamSystem;
 	KinematicGravitySystem m_gravitySystem;
 	RigidBodySystem m_rigidBodySystem;
-	LegCastSystem m_legCastSystem;
 	MovementSystem m_movementSystem;
 	VelocitySystem m_velocitySystem;
 	KinematicRigidBodySystem m_kinematicRBSystem;
-	KinematicCharacterControllerSystem m_kinematicCCSystem;
+	CharacterControllerSystem m_characterControllerSystem;
 	JumpSystem m_jumpSystem;
 	CoinSystem m_coinSystem;
 	RotatorSystem m_rotatorSystem;
@@ -555,21 +458,22 @@ private:
 	
 // Cache resources for use in factory methods
 private:
-	Model* m_monkey;
-	Model* m_cube;
-	Model* m_capsule;
-	Model* m_cylinder;
-	Model* m_cone;
-	Model* m_sphere;
-	Material* m_sand;
-	Material* m_stone;
-	Material* m_danger;
-	Material* m_gold;
-	Material* m_blank;
+	Handle<Model> m_monkey;
+	Handle<Model> m_cube;
+	Handle<Model> m_capsule;
+	Handle<Model> m_cylinder;
+	Handle<Model> m_cone;
+	Handle<Model> m_sphere;
+	Handle<Material> m_sand;
+	Handle<Material> m_stone;
+	Handle<Material> m_danger;
+	Handle<Material> m_gold;
+	Handle<Material> m_blank;
 
 // Factory method declarations
 private:
-	Entity MakePlatform(XMVECTOR pos, XMVECTOR rot, XMVECTOR scale, Material* material);
+	Handle<Material> MakeMaterial(const StringId key, Handle<VertexShader> vs, Handle<VertexShader> quantizedVs, Handle<PixelShader> ps, Handle<Texture> texture);
+	Entity MakePlatform(XMVECTOR pos, XMVECTOR rot, XMVECTOR scale, Handle<Material> material);
 	Entity MakeCoin(XMVECTOR position);
 	Entity MakeCheckpoint(XMVECTOR spawnPos, XMVECTOR spawnRot, XMVECTOR triggerPos, XMVECTOR triggerRot, XMVECTOR triggerScale);
 	Entity MakePropeller(XMVECTOR pos, XMVECTOR rot, XMVECTOR scale, XMVECTOR axis, float speed);
@@ -580,14 +484,27 @@ private:
 
 // Factory Methods
 
-Entity ThirdPersonApp::MakePlatform(XMVECTOR pos, XMVECTOR rot, XMVECTOR scale, Material* material)
+Handle<Material> ThirdPersonApp::MakeMaterial(const StringId key, Handle<VertexShader> vs, Handle<VertexShader> quantizedVs, Handle<PixelShader> ps, Handle<Texture> texture)
+{
+	Handle<Material> handle;
+	m_resourceManager.CreateMaterial(handle, key);
+
+	Material* material = m_resourceManager.GetResourceByHandle(handle);
+	material->SetShaders(vs, ps, quantizedVs);
+	material->SetConstantBuffer(0, m_cb);
+	material->AddTexture(texture);
+	material->AddShaderSampler(m_graphics.GetLinearWrapSampler());
+
+	return handle;
+}
+
+Entity ThirdPersonApp::MakePlatform(XMVECTOR pos, XMVECTOR rot, XMVECTOR scale, Handle<Material> material)
 {
 	Entity e = m_entityManager.CreateEntity();
 	U64 hTransform = m_transformSystem.CreateComponent(e, pos, rot, scale);
 	TransformComponent* transform = m_transformSystem.GetComponentByHandle(hTransform);
 	m_meshSystem.CreateComponent(e, hTransform, m_cube, material);
-	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1);
-	collider.SetScale(transform->scale);
+	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1, transform->scale);
 	RigidBody rb = m_physics.CreateStaticRigidBody(e, collider, transform->position, transform->rotation);
 	m_rigidBodySystem.CreateComponent(e, rb);
 
@@ -601,7 +518,7 @@ Entity ThirdPersonApp::MakeCoin(XMVECTOR position)
 	TransformComponent* transform = m_transformSystem.GetComponentByHandle(hTransform);
 	m_meshSystem.CreateComponent(e, hTransform, m_cylinder, m_gold);
 	ColliderPtr collider = m_physics.CreateCollisionSphere(0.5);
-	RigidBody rb = m_physics.CreateStaticRigidBody(e, collider, transform->position, Quaternion(), true);
+	RigidBody rb = m_physics.CreateTrigger(e, collider, transform->position, Quaternion());
 	m_rigidBodySystem.CreateComponent(e, rb);
 	m_coinSystem.CreateComponent(e);
 	m_rotatorSystem.CreateComponent(e, hTransform, 3, transform->rotation);
@@ -622,9 +539,8 @@ Entity ThirdPersonApp::MakeCheckpoint(XMVECTOR spawnPos, XMVECTOR spawnRot, XMVE
 	#if SHOW_TRIGGERS == true
 		m_meshSystem.CreateComponent(e, hTransform, m_cube, m_stone);
 	#endif
-	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1);
-	collider.SetScale(transform->scale);
-	RigidBody rb = m_physics.CreateStaticRigidBody(e, collider, transform->position, transform->rotation, true);
+	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1, transform->scale);
+	RigidBody rb = m_physics.CreateTrigger(e, collider, transform->position, transform->rotation);
 	m_rigidBodySystem.CreateComponent(e, rb);
 	m_checkpointTriggerSystem.CreateComponent(e, hSpawn);
 
@@ -637,9 +553,8 @@ Entity ThirdPersonApp::MakePropeller(XMVECTOR pos, XMVECTOR rot, XMVECTOR scale,
 	U64 hTransform = m_transformSystem.CreateComponent(e, pos, rot, scale);
 	TransformComponent* transform = m_transformSystem.GetComponentByHandle(hTransform);
 	m_meshSystem.CreateComponent(e, hTransform, m_cube, m_danger);
-	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1);
-	collider.SetScale(transform->scale);
-	RigidBody rb = m_physics.CreateKinematicRigidBody(e, collider, transform->position, transform->rotation, true);
+	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1, transform->scale);
+	RigidBody rb = m_physics.CreateTrigger(e, collider, transform->position, transform->rotation);
 	U64 hRigidBody = m_rigidBodySystem.CreateComponent(e, rb);
 	m_kinematicRBSystem.CreateComponent(e, hTransform, hRigidBody);
 	m_deadlyTouchSystem.CreateComponent(e);
@@ -654,9 +569,8 @@ Entity ThirdPersonApp::MakePiston(XMVECTOR startPos, XMVECTOR endPos, XMVECTOR s
 	U64 hTransform = m_transformSystem.CreateComponent(e, startPos, Quaternion(), scale);
 	TransformComponent* transform = m_transformSystem.GetComponentByHandle(hTransform);
 	m_meshSystem.CreateComponent(e, hTransform, m_cube, m_danger);
-	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1);
-	collider.SetScale(transform->scale);
-	RigidBody rb = m_physics.CreateKinematicRigidBody(e, collider, transform->position, transform->rotation, true);
+	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1, transform->scale);
+	RigidBody rb = m_physics.CreateTrigger(e, collider, transform->position, transform->rotation);
 	U64 hRigidBody = m_rigidBodySystem.CreateComponent(e, rb);
 	m_kinematicRBSystem.CreateComponent(e, hTransform, hRigidBody);
 	m_deadlyTouchSystem.CreateComponent(e);
@@ -673,9 +587,8 @@ Entity ThirdPersonApp::MakeKillTrigger(XMVECTOR pos, XMVECTOR scale)
 	#if SHOW_TRIGGERS == true
 		m_meshSystem.CreateComponent(e, hTransform, m_cube, m_stone);
 	#endif
-	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1);
-	collider.SetScale(transform->scale);
-	RigidBody rb = m_physics.CreateStaticRigidBody(e, collider, transform->position, transform->rotation, true);
+	ColliderPtr collider = m_physics.CreateCollisionBox(1, 1, 1, transform->scale);
+	RigidBody rb = m_physics.CreateTrigger(e, collider, transform->position, transform->rotation);
 	m_rigidBodySystem.CreateComponent(e, rb);
 	m_deadlyTouchSystem.CreateComponent(e);
 
@@ -0,0 +1,82 @@
+#include "ThreadPool.h"
+#include "Assert.h"
+
+
+ThreadPool::ThreadPool()
+{
+}
+
+
+ThreadPool::~ThreadPool()
+{
+	ShutDown();
+}
+
+
+bool ThreadPool::StartUp(U32 numThreads)
+{
+	ASSERT(m_threads.empty());
+
+	if (numThreads == 0)
+	{
+		U32 hardwareThreads = std::thread::hardware_concurrency();
+		numThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	m_stopping = false;
+	for (U32 i = 0; i < numThreads; ++i)
+	{
+		m_threads.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+
+	return true;
+}
+
+
+void ThreadPool::ShutDown()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+		m_tasks.clear();
+	}
+	m_wake.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+	m_threads.clear();
+}
+
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+	}
+	m_wake.notify_one();
+}
+
+
+void ThreadPool::WorkerLoop()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+			if (m_stopping)
+			{
+				return;
+			}
+
+			task = std::move(m_tasks.front());
+			m_tasks.pop_front();
+		}
+
+		task();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Types.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running queued tasks in the order they were submitted.
+class ThreadPool
+{
+public:
+	ThreadPool();
+	~ThreadPool();
+
+	// 0 threads uses one less than the hardware threads so the main thread keeps a core
+	bool StartUp(U32 numThreads = 0);
+
+	// waits for running tasks to finish, queued tasks that haven't started are dropped
+	void ShutDown();
+
+	void Submit(std::function<void()> task);
+
+	inline U32 GetNumThreads() const
+	{
+		return (U32)m_threads.size();
+	}
+
+private:
+	void WorkerLoop();
+
+private:
+	std::vector<std::thread> m_threads;
+	std::deque<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	bool m_stopping = false;
+};
\ No newline at end of file
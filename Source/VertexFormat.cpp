@@ -55,3 +55,14 @@ VertexFormat VertPosNormUVColor::GetVertexFormat()
 	return fmt;
 
 }
+
+
+VertexFormat VertPosNormUVColorQuantized::GetVertexFormat()
+{
+	VertexFormat fmt;
+	fmt.AddElement(DXGI_FORMAT_R16G16B16A16_UNORM, sizeof(unsigned short) * 4, "POSITION");
+	fmt.AddElement(DXGI_FORMAT_R16G16_SNORM, sizeof(short) * 2, "NORMAL");
+	fmt.AddElement(DXGI_FORMAT_R16G16_FLOAT, sizeof(unsigned short) * 2, "TEXCOORD");
+	fmt.AddElement(DXGI_FORMAT_R8G8B8A8_UNORM, sizeof(unsigned char) * 4, "TEXCOORD", 1);
+	return fmt;
+}
\ No newline at end of file
@@ -61,6 +61,21 @@ public:
 };
 
 
+// Compact form of VertPosNormUVColor for large meshes, 20 bytes instead of 36. Positions are 16 bit fractions of
+// the mesh bounds that the vertex shader scales back, normals are octahedral encoded and UVs are half floats.
+// Written by the asset cooker and drawn with the QUANTIZED_VERTICES variant of the shaders.
+class VertPosNormUVColorQuantized
+{
+public:
+	unsigned short x, y, z, w;
+	short nx, ny;
+	unsigned short u, v;
+	unsigned int color;
+
+	static VertexFormat GetVertexFormat();
+};
+
+
 
 // Helper function to create a color uint from red, green, blue, and alpha values
 inline unsigned int MakeColorUInt(unsigned char r, unsigned char g, unsigned char b,
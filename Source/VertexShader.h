@@ -6,12 +6,14 @@
 class VertexShader : public Resource
 {
 public:
+	static const ResourceType TYPE = RESOURCE_VERTEX_SHADER;
+
 	~VertexShader()
 	{
 		ShutDown();
 	}
 
-	virtual void ShutDown() override
+	void ShutDown()
 	{
 		if (m_shader != nullptr)
 		{
@@ -30,26 +32,46 @@ public:
 	{
 		ID3DBlob* blob = nullptr;
 
-		blob = graphics.CreateShaderFromFile(fileName, "vsmain", "vs_5_0");
+		blob = Compile(graphics, fileName);
 		if (!blob)
 		{
 			return false;
 		}
 
+		bool created = Create(graphics, blob, format);
+		blob->Release();
+
+		return created;
+	}
+
+	// compiling doesn't touch the device so it may run on a loader thread
+	static ID3DBlob* Compile(Graphics& graphics, const wchar_t* fileName)
+	{
+		return graphics.CreateShaderFromFile(fileName, "vsmain", "vs_5_0");
+	}
+
+	static ID3DBlob* Compile(Graphics& graphics, const void* source, size_t size, const char* name, ID3DInclude* include)
+	{
+		return graphics.CreateShaderFromMemory(source, size, name, "vsmain", "vs_5_0", include);
+	}
+
+	// the caller keeps ownership of the blob
+	bool Create(Graphics& graphics, ID3DBlob* blob, const VertexFormat& format)
+	{
 		m_shader = graphics.CreateVertexShader(blob);
 		if (!m_shader)
 		{
 			return false;
 		}
 
+		AddMemorySize(blob->GetBufferSize());
+
 		m_layout = graphics.CreateInputLayout(blob, format);
 		if (!m_layout)
 		{
 			return false;
 		}
 
-		blob->Release();
-
 		return true;
 	}
 
@@ -5,10 +5,16 @@
 #define _CRT_SECURE_NO_WARNINGS
 #endif
 
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <errno.h>
+#include <sys/stat.h>
+#endif
 #include <ctime>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include "Assert.h"
 
 static FILE* file = nullptr;
@@ -20,7 +26,9 @@ char* GetTimeStr(const char* format)
 {
 	time_t rawTime;
 	struct tm* timeInfo;
-	char buffer[80];
+
+	// returned to the caller, so it can't live on the stack. loader threads log too
+	static thread_local char buffer[80];
 
 	time(&rawTime);
 	timeInfo = localtime(&rawTime);
@@ -34,14 +42,21 @@ char* GetTimeStr(const char* format)
 bool StartUpLogger()
 {
 	// Create console for printf output on debug
-#ifdef _DEBUG
+#if defined(_DEBUG) && defined(_WIN32)
 	AllocConsole();
 	freopen("CONOUT$", "w", stdout);
 #endif
 
 	ASSERT(file == nullptr);
 
-	if (CreateDirectory(folderName, NULL) || ERROR_ALREADY_EXISTS == GetLastError())
+#ifdef _WIN32
+	bool folderExists = CreateDirectory(folderName, NULL) || ERROR_ALREADY_EXISTS == GetLastError();
+#else
+	// console builds like the benchmark log next to the executable too
+	bool folderExists = mkdir("Logs", 0755) == 0 || errno == EEXIST;
+#endif
+
+	if (folderExists)
 	{
 		char fileName[100];
 		strcpy(fileName, "Logs/Output-");
@@ -75,7 +90,7 @@ void ShutDownLogger()
 	}
 
 	// free console on debug
-#ifdef _DEBUG
+#if defined(_DEBUG) && defined(_WIN32)
 	FreeConsole();
 #endif
 }
@@ -116,7 +131,9 @@ int WriteLog(LogType type, const char* fmt, ...)
 	buffer[maxChars] = '\0';
 
 	// print to VS output
+#ifdef _WIN32
 	OutputDebugStringA(buffer);
+#endif
 
 	// print to console
 	printf(buffer);
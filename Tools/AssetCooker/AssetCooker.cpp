@@ -0,0 +1,943 @@
+// Offline asset cooker, turns source assets into the binary files the engine maps at load time.
+// OBJ and TGA stay the source formats, the engine loads the cooked .mesh and .tex next to them.
+//
+// Windows: build the AssetCooker project in GameEngine.sln
+// Linux, from the repository root, as one command:
+//   g++ -O2 -std=c++17 -pthread -ISource -IThirdparty/Headers
+//       Tools/AssetCooker/*.cpp Source/OBJLoader.cpp Source/MappedFile.cpp Source/TextureFile.cpp
+//       Source/PackageReader.cpp -o asset_cooker
+//
+// Usage: asset_cooker cook [-q] <in.obj> <out.mesh>
+//        asset_cooker cook <in.tga> <out.tex>
+//        asset_cooker cook [-q] <dir>                          cooks every .obj in dir to a .mesh and every .tga to a
+//                                                              .tex beside it
+//                                                              -q writes quantized vertices and reports their error
+//                                                              LODs go to a .lod sidecar beside each .mesh, keeping
+//                                                              at most 50%, 25% and 12.5% of the triangles
+//        asset_cooker bench-tex <dir|file> [iterations] [threads]
+//                                                              encoder throughput, quality and memory for TGA sources
+//        asset_cooker pack <out.pak> <root> <dir>...           packs every file in each dir under root by its path from
+//                                                              root, sources are left out when their cooked file is there.
+//                                                              the engine loads a loose file instead once it is newer
+//        asset_cooker bench-pack <in.pak> <root> [iterations]  opening every packaged file loose against the package
+//        asset_cooker bench <dir> [iterations]                 compares OBJ parsing against mapping the cooked meshes
+//        asset_cooker analyze <dir|file>                       post transform cache and fetch figures after each optimizer stage
+//        asset_cooker bench-import <dir|file> [iterations] [threads]
+//                                                              times the OBJ importer against tinyobj and checks they agree
+//        asset_cooker gen-obj <out.obj> <triangles>            writes a synthetic grid mesh for import benchmarks
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "MeshCook.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexQuantizer.h"
+#include "TextureCook.h"
+#include "BCEncoder.h"
+#include "PackageWriter.h"
+#include "PackageReader.h"
+#include "MappedFile.h"
+#include "OBJLoader.h"
+#include "WriteLog.h"
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+// most of the source triangles each level of detail keeps. a collapse removes two or more triangles at once, so small
+// meshes land under the ratio, e.g. the cone's last level keeps 9.7% and the cylinder's 11.3%
+static const float LOD_RATIOS[] = { 0.5f, 0.25f, 0.125f };
+
+// source formats the engine only loads once cooked, left out of packages when the cooked file sits beside them
+static const char* const COOKED_EXTENSIONS[][2] = { { ".obj", ".mesh" }, { ".tga", ".tex" } };
+
+
+// the engine logger needs a window console, the tool just prints
+int WriteLog(LogType type, const char* fmt, ...)
+{
+	FILE* out = type == LOG_TYPE_PRINT ? stdout : stderr;
+	fputs(type == LOG_TYPE_ERROR ? "error: " : (type == LOG_TYPE_WARNING ? "warning: " : ""), out);
+
+	va_list args;
+	va_start(args, fmt);
+	int written = vfprintf(out, fmt, args);
+	va_end(args);
+
+	fputc('\n', out);
+	return written;
+}
+
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+
+static bool HasExtension(const std::string& path, const char* ext)
+{
+	size_t extLength = strlen(ext);
+	return path.size() >= extLength && path.compare(path.size() - extLength, extLength, ext) == 0;
+}
+
+
+static std::string ReplaceExtension(const std::string& path, const char* ext)
+{
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+	{
+		return path + ext;
+	}
+	return path.substr(0, dot) + ext;
+}
+
+
+// sorted so cooks and benchmark rows come out in the same order everywhere
+static std::vector<std::string> ListFiles(const std::string& dir, const char* ext)
+{
+	std::vector<std::string> files;
+
+#ifdef _WIN32
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((dir + "\\*").c_str(), &data);
+	if (find != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && HasExtension(data.cFileName, ext))
+			{
+				files.push_back(dir + "/" + data.cFileName);
+			}
+		} while (FindNextFileA(find, &data));
+		FindClose(find);
+	}
+#else
+	DIR* d = opendir(dir.c_str());
+	if (d != nullptr)
+	{
+		while (dirent* entry = readdir(d))
+		{
+			if (entry->d_name[0] != '.' && HasExtension(entry->d_name, ext))
+			{
+				files.push_back(dir + "/" + entry->d_name);
+			}
+		}
+		closedir(d);
+	}
+#endif
+
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+
+static long FileSize(const std::string& path)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr)
+	{
+		return 0;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fclose(file);
+	return size;
+}
+
+
+static bool CookMesh(const std::string& in, const std::string& out, MeshVertexFormat format)
+{
+	CookedMesh mesh;
+	if (!ImportOBJ(in.c_str(), mesh))
+	{
+		return false;
+	}
+
+	MeshCacheStats before = MeshOptimizer::Analyze(mesh);
+	MeshOptimizer::Optimize(mesh);
+	MeshCacheStats after = MeshOptimizer::Analyze(mesh);
+
+	// after the fetch pass, which renumbers the vertices the levels index
+	MeshSimplifier::GenerateLods(mesh, LOD_RATIOS, sizeof(LOD_RATIOS) / sizeof(LOD_RATIOS[0]));
+
+	std::string lodPath = GetLodFilePath(out);
+	if (!WriteMeshFile(out.c_str(), mesh, format) || !WriteLodFile(lodPath.c_str(), mesh))
+	{
+		return false;
+	}
+
+	printf("%s -> %s, %zu verts, %zu tris, %ld -> %ld bytes, acmr %.3f -> %.3f, atvr %.3f -> %.3f, overfetch %.3f -> %.3f\n",
+		in.c_str(), out.c_str(), mesh.vertices.size(), mesh.indices.size() / 3, FileSize(in), FileSize(out),
+		before.acmr, after.acmr, before.atvr, after.atvr, before.overfetch, after.overfetch);
+
+	for (size_t i = 0; i < mesh.lods.size(); ++i)
+	{
+		const MeshLod& lod = mesh.lods[i];
+		printf("  lod %zu: %zu tris (%.1f%%), error %g\n", i + 1, lod.indices.size() / 3,
+			100.0 * lod.indices.size() / mesh.indices.size(), lod.error);
+	}
+
+	if (format == MESH_VERTEX_QUANTIZED)
+	{
+		std::vector<MeshVertexQuantized> quantized;
+		VertexQuantizer::Encode(mesh, quantized);
+		QuantizationError error = VertexQuantizer::Measure(mesh, quantized);
+
+		float extent[3] = {};
+		for (int i = 0; i < 3; ++i)
+		{
+			extent[i] = mesh.boundsMax[i] - mesh.boundsMin[i];
+		}
+		float diagonal = sqrtf(extent[0] * extent[0] + extent[1] * extent[1] + extent[2] * extent[2]);
+
+		printf("  quantized %zu -> %zu bytes/vert, position max %g rms %g (%.2g of bounds), normal max %.4f rms %.4f deg, uv max %g\n",
+			sizeof(MeshVertex), sizeof(MeshVertexQuantized), error.maxPosition, error.rmsPosition,
+			diagonal > 0.f ? error.maxPosition / diagonal : 0.f, error.maxNormalDegrees, error.rmsNormalDegrees, error.maxUV);
+	}
+
+	return true;
+}
+
+
+static const char* TextureFormatName(TextureFileFormat format)
+{
+	static const char* NAMES[NUM_TEXTURE_FORMATS] = { "RGBA8", "BC1", "BC3" };
+	return NAMES[format];
+}
+
+
+static size_t CookedTextureSize(const CookedTexture& texture)
+{
+	size_t size = 0;
+	for (const std::vector<U8>& mip : texture.mips)
+	{
+		size += mip.size();
+	}
+	return size;
+}
+
+
+static bool CookTextureFile(const std::string& in, const std::string& out)
+{
+	TextureImage image;
+	if (!ImportTGA(in.c_str(), image))
+	{
+		return false;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	std::vector<TextureImage> mips;
+	GenerateMips(image, mips);
+	double mipMs = ElapsedMs(start);
+
+	TextureFileFormat format = ChooseTextureFormat(image);
+	start = std::chrono::high_resolution_clock::now();
+	CookedTexture texture;
+	CookTexture(mips, format, texture);
+	double encodeMs = ElapsedMs(start);
+
+	if (!WriteTextureFile(out.c_str(), texture))
+	{
+		return false;
+	}
+
+	printf("%s -> %s, %ux%u %s, %zu mips, %ld -> %ld bytes, mips %.1f ms, encode %.1f ms\n", in.c_str(), out.c_str(),
+		texture.width, texture.height, TextureFormatName(format), texture.mips.size(), FileSize(in), FileSize(out), mipMs, encodeMs);
+	return true;
+}
+
+
+static int Cook(int argc, char** argv)
+{
+	MeshVertexFormat format = MESH_VERTEX_POS_NORM_UV_COLOR;
+	if (argc > 1 && strcmp(argv[0], "-q") == 0)
+	{
+		format = MESH_VERTEX_QUANTIZED;
+		--argc;
+		++argv;
+	}
+
+	if (argc == 2)
+	{
+		bool cooked = HasExtension(argv[0], ".tga") ? CookTextureFile(argv[0], argv[1]) : CookMesh(argv[0], argv[1], format);
+		return cooked ? 0 : 1;
+	}
+
+	std::vector<std::string> sources = ListFiles(argv[0], ".obj");
+	std::vector<std::string> textures = ListFiles(argv[0], ".tga");
+	if (sources.empty() && textures.empty())
+	{
+		printf("error: no .obj or .tga files in %s\n", argv[0]);
+		return 1;
+	}
+
+	int failed = 0;
+	for (const std::string& source : sources)
+	{
+		failed += CookMesh(source, ReplaceExtension(source, ".mesh"), format) ? 0 : 1;
+	}
+
+	for (const std::string& source : textures)
+	{
+		failed += CookTextureFile(source, ReplaceExtension(source, ".tex")) ? 0 : 1;
+	}
+
+	return failed == 0 ? 0 : 1;
+}
+
+
+// both paths stop where the engine hands the arrays to buffer creation: OBJ is parsed by tinyobj and converted like
+// Model::ReadOBJ, the cooked mesh is mapped, validated and its pages faulted in like the async mesh loader
+static int Bench(int argc, char** argv)
+{
+	int iterations = argc > 1 ? atoi(argv[1]) : 20;
+	std::vector<std::string> sources = ListFiles(argv[0], ".obj");
+	if (sources.empty() || iterations <= 0)
+	{
+		printf("error: nothing to benchmark in %s\n", argv[0]);
+		return 1;
+	}
+
+	printf("%-24s %8s %8s %9s %9s %10s %10s %8s\n", "mesh", "verts", "tris", "obj KB", "mesh KB", "obj ms", "mesh ms", "speedup");
+
+	double totalObjMs = 0.0;
+	double totalMeshMs = 0.0;
+	for (const std::string& source : sources)
+	{
+		std::string cooked = ReplaceExtension(source, ".mesh");
+
+		CookedMesh mesh;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			mesh = CookedMesh();
+			if (!ImportOBJReference(source.c_str(), mesh))
+			{
+				return 1;
+			}
+		}
+		double objMs = ElapsedMs(start) / iterations;
+
+		U32 numVertices = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			MappedFile file;
+			const MeshFileHeader* header = file.Open(cooked.c_str()) ? ValidateMeshFile(file.GetData(), file.GetSize()) : nullptr;
+			if (header == nullptr)
+			{
+				printf("error: %s is missing or out of date, run cook first\n", cooked.c_str());
+				return 1;
+			}
+
+			file.Prefetch();
+			numVertices = header->numVertices;
+		}
+		double meshMs = ElapsedMs(start) / iterations;
+
+		if (numVertices != mesh.vertices.size())
+		{
+			printf("warning: %s has %u verts, the source has %zu\n", cooked.c_str(), numVertices, mesh.vertices.size());
+		}
+
+		size_t slash = source.find_last_of("/\\");
+		printf("%-24s %8zu %8zu %9.1f %9.1f %10.3f %10.3f %7.1fx\n", source.c_str() + (slash == std::string::npos ? 0 : slash + 1),
+			mesh.vertices.size(), mesh.indices.size() / 3, FileSize(source) / 1024.0, FileSize(cooked) / 1024.0,
+			objMs, meshMs, objMs / meshMs);
+
+		totalObjMs += objMs;
+		totalMeshMs += meshMs;
+	}
+
+	printf("%-24s %8s %8s %9s %9s %10.3f %10.3f %7.1fx\n", "total", "", "", "", "", totalObjMs, totalMeshMs, totalObjMs / totalMeshMs);
+	return 0;
+}
+
+
+// cache and fetch figures after each optimizer stage, for checking the stages headless
+static int Analyze(int, char** argv)
+{
+	std::vector<std::string> sources = HasExtension(argv[0], ".obj") ? std::vector<std::string>{ argv[0] } : ListFiles(argv[0], ".obj");
+	if (sources.empty())
+	{
+		printf("error: no .obj files in %s\n", argv[0]);
+		return 1;
+	}
+
+	printf("%-24s %-10s %9s %8s %8s %10s %10s\n", "mesh", "stage", "tris", "acmr", "atvr", "overfetch", "ms");
+	for (const std::string& source : sources)
+	{
+		CookedMesh mesh;
+		if (!ImportOBJ(source.c_str(), mesh))
+		{
+			return 1;
+		}
+
+		size_t slash = source.find_last_of("/\\");
+		const char* name = source.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+		auto print = [&](const char* stage, double ms)
+		{
+			MeshCacheStats stats = MeshOptimizer::Analyze(mesh);
+			printf("%-24s %-10s %9zu %8.3f %8.3f %10.3f %10.3f\n", name, stage, mesh.indices.size() / 3, stats.acmr, stats.atvr, stats.overfetch, ms);
+		};
+
+		print("source", 0.0);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		MeshOptimizer::OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+		print("cache", ElapsedMs(start));
+
+		start = std::chrono::high_resolution_clock::now();
+		MeshOptimizer::OptimizeOverdraw(mesh.indices, mesh.vertices);
+		print("overdraw", ElapsedMs(start));
+
+		start = std::chrono::high_resolution_clock::now();
+		MeshOptimizer::OptimizeVertexFetch(mesh);
+		print("fetch", ElapsedMs(start));
+	}
+
+	return 0;
+}
+
+
+// largest difference between two imports of the same file, or -1 if their topology differs
+static float CompareMeshes(const CookedMesh& a, const CookedMesh& b)
+{
+	if (a.vertices.size() != b.vertices.size() || a.indices != b.indices)
+	{
+		return -1.f;
+	}
+
+	float maxError = 0.f;
+	for (size_t i = 0; i < a.vertices.size(); ++i)
+	{
+		const float* fa = &a.vertices[i].x;
+		const float* fb = &b.vertices[i].x;
+		for (int f = 0; f < 8; ++f)
+		{
+			float error = fabsf(fa[f] - fb[f]);
+			maxError = error > maxError ? error : maxError;
+		}
+
+		if (a.vertices[i].color != b.vertices[i].color)
+		{
+			return -1.f;
+		}
+	}
+
+	return maxError;
+}
+
+
+static int BenchImport(int argc, char** argv)
+{
+	int iterations = argc > 1 ? atoi(argv[1]) : 5;
+	U32 numThreads = argc > 2 ? (U32)atoi(argv[2]) : std::thread::hardware_concurrency();
+	numThreads = numThreads > 0 ? numThreads : 1;
+
+	std::vector<std::string> sources = HasExtension(argv[0], ".obj") ? std::vector<std::string>{ argv[0] } : ListFiles(argv[0], ".obj");
+	if (sources.empty() || iterations <= 0)
+	{
+		printf("error: nothing to benchmark in %s\n", argv[0]);
+		return 1;
+	}
+
+	printf("%-24s %9s %9s %9s %11s %11s %11s %8s %10s\n", "mesh", "verts", "tris", "MB", "tinyobj ms", "1 thread ms",
+		"threads ms", "speedup", "max error");
+
+	int mismatches = 0;
+	for (const std::string& source : sources)
+	{
+		CookedMesh reference;
+		CookedMesh single;
+		CookedMesh threaded;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			reference = CookedMesh();
+			if (!ImportOBJReference(source.c_str(), reference))
+			{
+				return 1;
+			}
+		}
+		double referenceMs = ElapsedMs(start) / iterations;
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			single = CookedMesh();
+			if (!ImportOBJ(source.c_str(), single, 1))
+			{
+				return 1;
+			}
+		}
+		double singleMs = ElapsedMs(start) / iterations;
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			threaded = CookedMesh();
+			if (!ImportOBJ(source.c_str(), threaded, numThreads))
+			{
+				return 1;
+			}
+		}
+		double threadedMs = ElapsedMs(start) / iterations;
+
+		float error = CompareMeshes(reference, single);
+		float threadedError = CompareMeshes(single, threaded);
+		bool match = error >= 0.f && threadedError == 0.f;
+		mismatches += match ? 0 : 1;
+
+		size_t slash = source.find_last_of("/\\");
+		printf("%-24s %9zu %9zu %9.1f %11.3f %11.3f %11.3f %7.1fx %10s\n", source.c_str() + (slash == std::string::npos ? 0 : slash + 1),
+			single.vertices.size(), single.indices.size() / 3, FileSize(source) / (1024.0 * 1024.0), referenceMs, singleMs,
+			threadedMs, referenceMs / threadedMs, match ? std::to_string(error).c_str() : "MISMATCH");
+	}
+
+	printf("%u importer threads, %u hardware threads\n", numThreads, std::thread::hardware_concurrency());
+	return mismatches == 0 ? 0 : 1;
+}
+
+
+static int Pack(int argc, char** argv)
+{
+	std::string root = argv[1];
+	std::vector<PackageSource> sources;
+	for (int i = 2; i < argc; ++i)
+	{
+		std::string dir = argv[i];
+		for (const std::string& file : ListFiles(root + "/" + dir, ""))
+		{
+			bool cooked = false;
+			for (const auto& extensions : COOKED_EXTENSIONS)
+			{
+				cooked = cooked || (HasExtension(file, extensions[0]) && FileSize(ReplaceExtension(file, extensions[1])) > 0);
+			}
+
+			if (!cooked)
+			{
+				// keys are made from forward slash paths relative to the engine's working directory
+				sources.push_back({ dir + "/" + file.substr(root.size() + dir.size() + 2), file });
+			}
+		}
+	}
+
+	if (sources.empty())
+	{
+		printf("error: nothing to pack under %s\n", root.c_str());
+		return 1;
+	}
+
+	if (!WritePackageFile(argv[0], sources))
+	{
+		return 1;
+	}
+
+	PackageReader package;
+	if (!package.Open(argv[0]))
+	{
+		return 1;
+	}
+
+	U64 fileBytes = 0;
+	for (U32 i = 0; i < package.GetNumEntries(); ++i)
+	{
+		const PackageEntry& entry = package.GetEntry(i);
+		printf("  %08x %10llu %s\n", entry.key, (unsigned long long)entry.size, package.GetName(entry));
+		fileBytes += entry.size;
+	}
+
+	long size = FileSize(argv[0]);
+	printf("%s: %u files, %.1f KB of files, %.1f KB with table and padding\n", argv[0], package.GetNumEntries(),
+		fileBytes / 1024.0, size / 1024.0);
+	return 0;
+}
+
+
+// drops a file's pages from the OS cache so the next open reads the disk, the kernel only drops clean pages which is
+// all a read only file has. windows has no per file equivalent, so there every pass is warm
+static void EvictFromCache(const std::string& path)
+{
+#ifndef _WIN32
+	int file = open(path.c_str(), O_RDONLY);
+	if (file >= 0)
+	{
+		posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+		close(file);
+	}
+#else
+	(void)path;
+#endif
+}
+
+
+// maps, checks and faults in every file the package holds, once as loose files under root and once through the
+// package, the way the resource manager would at startup
+static int BenchPackage(int argc, char** argv)
+{
+	std::string root = argv[1];
+	int iterations = argc > 2 ? atoi(argv[2]) : 20;
+
+	PackageReader package;
+	if (!package.Open(argv[0]) || iterations <= 0)
+	{
+		printf("error: nothing to benchmark in %s\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<std::string> names;
+	for (U32 i = 0; i < package.GetNumEntries(); ++i)
+	{
+		names.push_back(package.GetName(package.GetEntry(i)));
+	}
+	package.Close();
+
+	auto runLoose = [&]()
+	{
+		for (const std::string& name : names)
+		{
+			MappedFile file;
+			if (!file.Open((root + "/" + name).c_str()))
+			{
+				return false;
+			}
+			file.Prefetch();
+		}
+		return true;
+	};
+
+	auto runPackage = [&]()
+	{
+		PackageReader reader;
+		if (!reader.Open(argv[0]))
+		{
+			return false;
+		}
+
+		for (const std::string& name : names)
+		{
+			size_t size = 0;
+			const U8* data = reader.Find(name.c_str(), size);
+			if (data == nullptr)
+			{
+				return false;
+			}
+			PrefetchMemory(data, size);
+		}
+		return true;
+	};
+
+	printf("%-8s %10s %12s %12s %9s\n", "cache", "opens", "loose ms", "package ms", "speedup");
+	for (int cold = 0; cold < 2; ++cold)
+	{
+		double looseMs = 0.0;
+		double packageMs = 0.0;
+		for (int i = 0; i < iterations; ++i)
+		{
+			if (cold)
+			{
+				for (const std::string& name : names)
+				{
+					EvictFromCache(root + "/" + name);
+				}
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			if (!runLoose())
+			{
+				printf("error: %s doesn't match the files under %s, repack\n", argv[0], root.c_str());
+				return 1;
+			}
+			looseMs += ElapsedMs(start);
+
+			if (cold)
+			{
+				EvictFromCache(argv[0]);
+			}
+
+			start = std::chrono::high_resolution_clock::now();
+			if (!runPackage())
+			{
+				return 1;
+			}
+			packageMs += ElapsedMs(start);
+		}
+
+		std::string opens = std::to_string(names.size()) + " / 1";
+		printf("%-8s %10s %12.3f %12.3f %8.1fx\n", cold ? "cold" : "warm", opens.c_str(), looseMs / iterations,
+			packageMs / iterations, looseMs / packageMs);
+	}
+
+	return 0;
+}
+
+
+// peak signal to noise ratio in dB over the chosen channels, higher is better, identical images are capped at 99
+static double ComputePSNR(const TextureImage& a, const TextureImage& b, int firstChannel, int numChannels)
+{
+	double sum = 0.0;
+	size_t numTexels = (size_t)a.width * a.height;
+	for (size_t i = 0; i < numTexels; ++i)
+	{
+		for (int c = firstChannel; c < firstChannel + numChannels; ++c)
+		{
+			double d = (double)a.texels[i * 4 + c] - b.texels[i * 4 + c];
+			sum += d * d;
+		}
+	}
+
+	double mse = sum / ((double)numTexels * numChannels);
+	return mse > 0.0 ? 10.0 * log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+
+// times mip generation and the block encoder over the whole chain with one thread and with many, measures the top
+// level's quality after a decode and compares the memory of the uncompressed source with no mips against the cook
+static int BenchTexture(int argc, char** argv)
+{
+	int iterations = argc > 1 ? atoi(argv[1]) : 5;
+	U32 numThreads = argc > 2 ? (U32)atoi(argv[2]) : std::thread::hardware_concurrency();
+	numThreads = numThreads > 0 ? numThreads : 1;
+
+	std::vector<std::string> sources = HasExtension(argv[0], ".tga") ? std::vector<std::string>{ argv[0] } : ListFiles(argv[0], ".tga");
+	if (sources.empty() || iterations <= 0)
+	{
+		printf("error: nothing to benchmark in %s\n", argv[0]);
+		return 1;
+	}
+
+	printf("%-16s %9s %6s %8s %11s %11s %11s %9s %9s %10s %10s %9s\n", "texture", "size", "format", "mips ms", "1 thread ms",
+		"threads ms", "MPix/s", "rgb dB", "alpha dB", "source KB", "cooked KB", "read ms");
+
+	double totalPixels = 0.0;
+	double totalSingleMs = 0.0;
+	double totalThreadedMs = 0.0;
+	size_t totalSource = 0;
+	size_t totalCooked = 0;
+	for (const std::string& source : sources)
+	{
+		TextureImage image;
+		if (!ImportTGA(source.c_str(), image))
+		{
+			return 1;
+		}
+
+		std::vector<TextureImage> mips;
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			GenerateMips(image, mips);
+		}
+		double mipMs = ElapsedMs(start) / iterations;
+
+		TextureFileFormat format = ChooseTextureFormat(image);
+		CookedTexture texture;
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			CookTexture(mips, format, texture, 1);
+		}
+		double singleMs = ElapsedMs(start) / iterations;
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			CookTexture(mips, format, texture, numThreads);
+		}
+		double threadedMs = ElapsedMs(start) / iterations;
+
+		double pixels = 0.0;
+		for (const TextureImage& mip : mips)
+		{
+			pixels += (double)mip.width * mip.height;
+		}
+
+		double rgbPSNR = 99.0;
+		double alphaPSNR = 99.0;
+		if (format != TEXTURE_FORMAT_RGBA8)
+		{
+			TextureImage decoded;
+			BCEncoder::Decode(texture.mips[0].data(), texture.width, texture.height, format, decoded);
+			rgbPSNR = ComputePSNR(image, decoded, 0, 3);
+			alphaPSNR = ComputePSNR(image, decoded, 3, 1);
+		}
+
+		// the load path the engine takes, the file must already be cooked
+		std::string cooked = ReplaceExtension(source, ".tex");
+		std::vector<U8> data;
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			if (ReadTextureFile(cooked.c_str(), data) == nullptr)
+			{
+				printf("error: %s is missing or out of date, run cook first\n", cooked.c_str());
+				return 1;
+			}
+		}
+		double readMs = ElapsedMs(start) / iterations;
+
+		size_t sourceBytes = image.texels.size();
+		size_t cookedBytes = CookedTextureSize(texture);
+
+		size_t slash = source.find_last_of("/\\");
+		std::string size = std::to_string(image.width) + "x" + std::to_string(image.height);
+		printf("%-16s %9s %6s %8.2f %11.2f %11.2f %11.1f %9.2f %9.2f %10.1f %10.1f %9.3f\n",
+			source.c_str() + (slash == std::string::npos ? 0 : slash + 1), size.c_str(), TextureFormatName(format), mipMs,
+			singleMs, threadedMs, pixels / (threadedMs * 1000.0), rgbPSNR, alphaPSNR, sourceBytes / 1024.0, cookedBytes / 1024.0, readMs);
+
+		totalPixels += pixels;
+		totalSingleMs += singleMs;
+		totalThreadedMs += threadedMs;
+		totalSource += sourceBytes;
+		totalCooked += cookedBytes;
+	}
+
+	printf("%-16s %9s %6s %8s %11.2f %11.2f %11.1f %9s %9s %10.1f %10.1f\n", "total", "", "", "", totalSingleMs, totalThreadedMs,
+		totalPixels / (totalThreadedMs * 1000.0), "", "", totalSource / 1024.0, totalCooked / 1024.0);
+	printf("%u encoder threads, %.1f MPix/s on one, %.1fx smaller with every mip than RGBA8 without\n", numThreads,
+		totalPixels / (totalSingleMs * 1000.0), (double)totalSource / totalCooked);
+	return 0;
+}
+
+
+// a wavy grid of quads with positions, colours, uvs and normals, each quad is a four corner face so the fan
+// triangulation is exercised as well
+static int GenerateOBJ(int, char** argv)
+{
+	long triangles = atol(argv[1]);
+	int n = (int)sqrt((double)(triangles > 2 ? triangles : 2) / 2.0);
+	n = n > 1 ? n : 1;
+
+	FILE* file = fopen(argv[0], "wb");
+	if (file == nullptr)
+	{
+		printf("error: could not open %s for writing\n", argv[0]);
+		return 1;
+	}
+
+	fprintf(file, "# synthetic %dx%d grid\n", n, n);
+	for (int z = 0; z <= n; ++z)
+	{
+		for (int x = 0; x <= n; ++x)
+		{
+			float u = (float)x / n;
+			float v = (float)z / n;
+			float h = 0.05f * sinf(u * 40.f) * cosf(v * 40.f);
+			fprintf(file, "v %.6f %.6f %.6f %.4f %.4f %.4f\n", u * 100.f - 50.f, h, v * 100.f - 50.f, u, v, 1.f - u);
+		}
+	}
+
+	for (int z = 0; z <= n; ++z)
+	{
+		for (int x = 0; x <= n; ++x)
+		{
+			fprintf(file, "vt %.6f %.6f\n", (float)x / n, (float)z / n);
+		}
+	}
+
+	for (int z = 0; z <= n; ++z)
+	{
+		for (int x = 0; x <= n; ++x)
+		{
+			float u = (float)x / n;
+			float v = (float)z / n;
+			float dx = -2.f * cosf(u * 40.f) * cosf(v * 40.f) / 100.f;
+			float dz = 2.f * sinf(u * 40.f) * sinf(v * 40.f) / 100.f;
+			float length = sqrtf(dx * dx + 1.f + dz * dz);
+			fprintf(file, "vn %.6f %.6f %.6f\n", -dx / length, 1.f / length, -dz / length);
+		}
+	}
+
+	for (int z = 0; z < n; ++z)
+	{
+		for (int x = 0; x < n; ++x)
+		{
+			int a = z * (n + 1) + x + 1;
+			int b = a + 1;
+			int c = a + n + 2;
+			int d = a + n + 1;
+			fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, d, d, d, c, c, c, b, b, b);
+		}
+	}
+
+	fclose(file);
+	printf("%s: %d verts, %ld tris, %ld bytes\n", argv[0], (n + 1) * (n + 1), 2L * n * n, FileSize(argv[0]));
+	return 0;
+}
+
+
+int main(int argc, char** argv)
+{
+	std::string command = argc > 1 ? argv[1] : "";
+
+	if (command == "cook" && argc >= 3 && argc <= 5)
+	{
+		return Cook(argc - 2, argv + 2);
+	}
+
+	if (command == "bench" && (argc == 3 || argc == 4))
+	{
+		return Bench(argc - 2, argv + 2);
+	}
+
+	if (command == "analyze" && argc == 3)
+	{
+		return Analyze(argc - 2, argv + 2);
+	}
+
+	if (command == "bench-import" && argc >= 3 && argc <= 5)
+	{
+		return BenchImport(argc - 2, argv + 2);
+	}
+
+	if (command == "bench-tex" && argc >= 3 && argc <= 5)
+	{
+		return BenchTexture(argc - 2, argv + 2);
+	}
+
+	if (command == "pack" && argc >= 5)
+	{
+		return Pack(argc - 2, argv + 2);
+	}
+
+	if (command == "bench-pack" && (argc == 4 || argc == 5))
+	{
+		return BenchPackage(argc - 2, argv + 2);
+	}
+
+	if (command == "gen-obj" && argc == 4)
+	{
+		return GenerateOBJ(argc - 2, argv + 2);
+	}
+
+	printf("usage: asset_cooker cook [-q] <in.obj> <out.mesh>\n");
+	printf("       asset_cooker cook <in.tga> <out.tex>\n");
+	printf("       asset_cooker cook [-q] <dir>\n");
+	printf("       asset_cooker bench <dir> [iterations]\n");
+	printf("       asset_cooker analyze <dir|file>\n");
+	printf("       asset_cooker bench-import <dir|file> [iterations] [threads]\n");
+	printf("       asset_cooker bench-tex <dir|file> [iterations] [threads]\n");
+	printf("       asset_cooker pack <out.pak> <root> <dir>...\n");
+	printf("       asset_cooker bench-pack <in.pak> <root> [iterations]\n");
+	printf("       asset_cooker gen-obj <out.obj> <triangles>\n");
+	return 1;
+}
\ No newline at end of file
@@ -0,0 +1,580 @@
+#include "BCEncoder.h"
+#include <math.h>
+#include <stdlib.h>
+#include <thread>
+
+
+// every pair of quantized endpoints whose first interpolant lands closest to each 8 bit value, for one colour blocks
+struct SingleColorTables
+{
+	U8 red[256][2];
+	U8 green[256][2];
+
+	SingleColorTables()
+	{
+		Build(red, 5);
+		Build(green, 6);
+	}
+
+	static void Build(U8 table[256][2], int bits)
+	{
+		int levels = 1 << bits;
+		for (int value = 0; value < 256; ++value)
+		{
+			int bestError = 256;
+			int bestSpread = levels;
+			for (int e0 = 0; e0 < levels; ++e0)
+			{
+				for (int e1 = 0; e1 < levels; ++e1)
+				{
+					int c0 = (e0 << (8 - bits)) | (e0 >> (2 * bits - 8));
+					int c1 = (e1 << (8 - bits)) | (e1 >> (2 * bits - 8));
+					int error = abs((2 * c0 + c1) / 3 - value);
+
+					// close endpoints keep the result the same on decoders that round the interpolant differently
+					int spread = abs(e0 - e1);
+					if (error < bestError || (error == bestError && spread < bestSpread))
+					{
+						bestError = error;
+						bestSpread = spread;
+						table[value][0] = (U8)e0;
+						table[value][1] = (U8)e1;
+					}
+				}
+			}
+		}
+	}
+};
+
+
+struct ColorFit
+{
+	U16 c0 = 0;
+	U16 c1 = 0;
+	U32 indices = 0;
+	U32 error = 0xffffffff;
+};
+
+
+template <typename Func>
+static void RunParallel(U32 numTasks, Func func)
+{
+	std::vector<std::thread> threads;
+	for (U32 i = 1; i < numTasks; ++i)
+	{
+		threads.emplace_back(func, i);
+	}
+
+	func(0);
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+
+static inline void UnpackColor565(U16 color, int rgb[3])
+{
+	int r = (color >> 11) & 31;
+	int g = (color >> 5) & 63;
+	int b = color & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+
+static inline U16 PackColor565(const float rgb[3])
+{
+	static const float MAX_VALUES[3] = { 31.f, 63.f, 31.f };
+
+	int packed[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		float c = rgb[i] < 0.f ? 0.f : (rgb[i] > 255.f ? 255.f : rgb[i]);
+		packed[i] = (int)(c * MAX_VALUES[i] / 255.f + 0.5f);
+	}
+
+	return (U16)((packed[0] << 11) | (packed[1] << 5) | packed[2]);
+}
+
+
+// the four colour palette, the only one BC3 knows and the one BC1 uses while c0 > c1
+static void ColorPalette(U16 c0, U16 c1, int palette[4][3])
+{
+	UnpackColor565(c0, palette[0]);
+	UnpackColor565(c1, palette[1]);
+	for (int i = 0; i < 3; ++i)
+	{
+		palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+		palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+	}
+}
+
+
+// orders the endpoints for four colour mode, picks the nearest palette entry per texel and keeps the fit if it beats best
+static void TryColorEndpoints(const U8 block[64], U16 c0, U16 c1, ColorFit& best)
+{
+	if (c0 < c1)
+	{
+		U16 swap = c0;
+		c0 = c1;
+		c1 = swap;
+	}
+
+	int palette[4][3];
+	ColorPalette(c0, c1, palette);
+
+	U32 indices = 0;
+	U32 error = 0;
+	for (int i = 0; i < 16; ++i)
+	{
+		const U8* texel = block + 4 * i;
+		int bestDistance = 0x7fffffff;
+		int bestIndex = 0;
+		for (int p = 0; p < 4; ++p)
+		{
+			int dr = texel[0] - palette[p][0];
+			int dg = texel[1] - palette[p][1];
+			int db = texel[2] - palette[p][2];
+			int distance = dr * dr + dg * dg + db * db;
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				bestIndex = p;
+			}
+		}
+
+		indices |= (U32)bestIndex << (2 * i);
+		error += (U32)bestDistance;
+	}
+
+	if (error < best.error)
+	{
+		best.c0 = c0;
+		best.c1 = c1;
+		best.indices = indices;
+		best.error = error;
+	}
+}
+
+
+// solves for the two endpoints that best reproduce the block with the fit's indices held fixed
+static bool RefineColorEndpoints(const U8 block[64], const ColorFit& fit, U16& c0, U16& c1)
+{
+	static const float WEIGHTS[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+
+	float aa = 0.f;
+	float ab = 0.f;
+	float bb = 0.f;
+	float ax[3] = {};
+	float bx[3] = {};
+	for (int i = 0; i < 16; ++i)
+	{
+		float a = WEIGHTS[(fit.indices >> (2 * i)) & 3];
+		float b = 1.f - a;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < 3; ++c)
+		{
+			ax[c] += a * block[4 * i + c];
+			bx[c] += b * block[4 * i + c];
+		}
+	}
+
+	float det = aa * bb - ab * ab;
+	if (fabsf(det) < 1e-6f)
+	{
+		return false;
+	}
+
+	float end0[3];
+	float end1[3];
+	for (int c = 0; c < 3; ++c)
+	{
+		end0[c] = (bb * ax[c] - ab * bx[c]) / det;
+		end1[c] = (aa * bx[c] - ab * ax[c]) / det;
+	}
+
+	c0 = PackColor565(end0);
+	c1 = PackColor565(end1);
+	return true;
+}
+
+
+static void EncodeColor(const U8 block[64], U8 out[8])
+{
+	static const SingleColorTables tables;
+
+	ColorFit best;
+
+	bool single = true;
+	for (int i = 1; i < 16 && single; ++i)
+	{
+		single = block[4 * i] == block[0] && block[4 * i + 1] == block[1] && block[4 * i + 2] == block[2];
+	}
+
+	if (single)
+	{
+		U16 c0 = (U16)((tables.red[block[0]][0] << 11) | (tables.green[block[1]][0] << 5) | tables.red[block[2]][0]);
+		U16 c1 = (U16)((tables.red[block[0]][1] << 11) | (tables.green[block[1]][1] << 5) | tables.red[block[2]][1]);
+		TryColorEndpoints(block, c0, c1, best);
+	}
+	else
+	{
+		float mean[3] = {};
+		float minimum[3] = { 255.f, 255.f, 255.f };
+		float maximum[3] = {};
+		for (int i = 0; i < 16; ++i)
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				float value = block[4 * i + c];
+				mean[c] += value / 16.f;
+				minimum[c] = value < minimum[c] ? value : minimum[c];
+				maximum[c] = value > maximum[c] ? value : maximum[c];
+			}
+		}
+
+		float covariance[6] = {};
+		for (int i = 0; i < 16; ++i)
+		{
+			float r = block[4 * i] - mean[0];
+			float g = block[4 * i + 1] - mean[1];
+			float b = block[4 * i + 2] - mean[2];
+			covariance[0] += r * r;
+			covariance[1] += r * g;
+			covariance[2] += r * b;
+			covariance[3] += g * g;
+			covariance[4] += g * b;
+			covariance[5] += b * b;
+		}
+
+		// power iteration from the bounding box diagonal converges on the principal axis in a few steps
+		float axis[3] = { maximum[0] - minimum[0], maximum[1] - minimum[1], maximum[2] - minimum[2] };
+		for (int iteration = 0; iteration < 8; ++iteration)
+		{
+			float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+			float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+			float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+			float length = fmaxf(fabsf(x), fmaxf(fabsf(y), fabsf(z)));
+			if (length < 1e-6f)
+			{
+				break;
+			}
+			axis[0] = x / length;
+			axis[1] = y / length;
+			axis[2] = z / length;
+		}
+
+		float lengthSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+		float minT = 0.f;
+		float maxT = 0.f;
+		for (int i = 0; i < 16 && lengthSq > 0.f; ++i)
+		{
+			float t = ((block[4 * i] - mean[0]) * axis[0] + (block[4 * i + 1] - mean[1]) * axis[1] + (block[4 * i + 2] - mean[2]) * axis[2]) / lengthSq;
+			minT = t < minT ? t : minT;
+			maxT = t > maxT ? t : maxT;
+		}
+
+		float end0[3];
+		float end1[3];
+		for (int c = 0; c < 3; ++c)
+		{
+			end0[c] = mean[c] + axis[c] * maxT;
+			end1[c] = mean[c] + axis[c] * minT;
+		}
+
+		TryColorEndpoints(block, PackColor565(end0), PackColor565(end1), best);
+		TryColorEndpoints(block, PackColor565(maximum), PackColor565(minimum), best);
+
+		for (int iteration = 0; iteration < 2; ++iteration)
+		{
+			U16 c0;
+			U16 c1;
+			U32 error = best.error;
+			if (!RefineColorEndpoints(block, best, c0, c1))
+			{
+				break;
+			}
+
+			TryColorEndpoints(block, c0, c1, best);
+			if (best.error == error)
+			{
+				break;
+			}
+		}
+	}
+
+	out[0] = (U8)best.c0;
+	out[1] = (U8)(best.c0 >> 8);
+	out[2] = (U8)best.c1;
+	out[3] = (U8)(best.c1 >> 8);
+	for (int i = 0; i < 4; ++i)
+	{
+		out[4 + i] = (U8)(best.indices >> (8 * i));
+	}
+}
+
+
+static void AlphaPalette(int a0, int a1, int palette[8])
+{
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1)
+	{
+		for (int i = 1; i < 7; ++i)
+		{
+			palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+		}
+	}
+	else
+	{
+		for (int i = 1; i < 5; ++i)
+		{
+			palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+
+static U32 FitAlpha(const U8 block[64], int a0, int a1, U64& indices)
+{
+	int palette[8];
+	AlphaPalette(a0, a1, palette);
+
+	indices = 0;
+	U32 error = 0;
+	for (int i = 0; i < 16; ++i)
+	{
+		int alpha = block[4 * i + 3];
+		int bestDistance = 0x7fffffff;
+		int bestIndex = 0;
+		for (int p = 0; p < 8; ++p)
+		{
+			int distance = (alpha - palette[p]) * (alpha - palette[p]);
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				bestIndex = p;
+			}
+		}
+
+		indices |= (U64)bestIndex << (3 * i);
+		error += (U32)bestDistance;
+	}
+
+	return error;
+}
+
+
+// tries the eight value mode across the full range and the six value mode, which has exact 0 and 255 of its own,
+// across the range of everything else
+static void EncodeAlpha(const U8 block[64], U8 out[8])
+{
+	int minimum = 255;
+	int maximum = 0;
+	int innerMin = 255;
+	int innerMax = 0;
+	for (int i = 0; i < 16; ++i)
+	{
+		int alpha = block[4 * i + 3];
+		minimum = alpha < minimum ? alpha : minimum;
+		maximum = alpha > maximum ? alpha : maximum;
+		if (alpha != 0 && alpha != 255)
+		{
+			innerMin = alpha < innerMin ? alpha : innerMin;
+			innerMax = alpha > innerMax ? alpha : innerMax;
+		}
+	}
+
+	int a0 = maximum;
+	int a1 = minimum;
+	U64 indices;
+	U32 error = FitAlpha(block, a0, a1, indices);
+
+	if (error > 0)
+	{
+		int b0 = innerMin <= innerMax ? innerMin : 0;
+		int b1 = innerMin <= innerMax ? innerMax : 0;
+		U64 sixIndices;
+		U32 sixError = FitAlpha(block, b0, b1, sixIndices);
+		if (sixError < error)
+		{
+			a0 = b0;
+			a1 = b1;
+			indices = sixIndices;
+		}
+	}
+
+	out[0] = (U8)a0;
+	out[1] = (U8)a1;
+	for (int i = 0; i < 6; ++i)
+	{
+		out[2 + i] = (U8)(indices >> (8 * i));
+	}
+}
+
+
+static void DecodeColor(const U8 in[8], U8 block[64], bool allowThreeColor)
+{
+	U16 c0 = (U16)(in[0] | (in[1] << 8));
+	U16 c1 = (U16)(in[2] | (in[3] << 8));
+
+	int palette[4][3];
+	ColorPalette(c0, c1, palette);
+	int alpha[4] = { 255, 255, 255, 255 };
+	if (allowThreeColor && c0 <= c1)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+			palette[3][i] = 0;
+		}
+		alpha[3] = 0;
+	}
+
+	U32 indices = (U32)in[4] | ((U32)in[5] << 8) | ((U32)in[6] << 16) | ((U32)in[7] << 24);
+	for (int i = 0; i < 16; ++i)
+	{
+		U32 index = (indices >> (2 * i)) & 3;
+		block[4 * i] = (U8)palette[index][0];
+		block[4 * i + 1] = (U8)palette[index][1];
+		block[4 * i + 2] = (U8)palette[index][2];
+		block[4 * i + 3] = (U8)alpha[index];
+	}
+}
+
+
+void BCEncoder::EncodeBC1Block(const U8 block[64], U8 out[8])
+{
+	EncodeColor(block, out);
+}
+
+
+void BCEncoder::EncodeBC3Block(const U8 block[64], U8 out[16])
+{
+	EncodeAlpha(block, out);
+	EncodeColor(block, out + 8);
+}
+
+
+void BCEncoder::DecodeBC1Block(const U8 in[8], U8 block[64])
+{
+	DecodeColor(in, block, true);
+}
+
+
+void BCEncoder::DecodeBC3Block(const U8 in[16], U8 block[64])
+{
+	DecodeColor(in + 8, block, false);
+
+	int palette[8];
+	AlphaPalette(in[0], in[1], palette);
+
+	U64 indices = 0;
+	for (int i = 0; i < 6; ++i)
+	{
+		indices |= (U64)in[2 + i] << (8 * i);
+	}
+
+	for (int i = 0; i < 16; ++i)
+	{
+		block[4 * i + 3] = (U8)palette[(indices >> (3 * i)) & 7];
+	}
+}
+
+
+void BCEncoder::Encode(const TextureImage& image, TextureFileFormat format, std::vector<U8>& out, U32 numThreads)
+{
+	U32 blockBytes = format == TEXTURE_FORMAT_BC1 ? 8 : 16;
+	U32 blocksX = (image.width + 3) / 4;
+	U32 blocksY = (image.height + 3) / 4;
+	out.resize((size_t)blocksX * blocksY * blockBytes);
+
+	numThreads = numThreads > 0 ? numThreads : std::thread::hardware_concurrency();
+	numThreads = numThreads < 1 ? 1 : (numThreads > blocksY ? blocksY : numThreads);
+
+	// contiguous bands of block rows so each thread reads and writes its own stretch of memory
+	RunParallel(numThreads, [&](U32 thread)
+	{
+		U32 firstRow = (U32)((U64)blocksY * thread / numThreads);
+		U32 endRow = (U32)((U64)blocksY * (thread + 1) / numThreads);
+		U8 block[64];
+		for (U32 by = firstRow; by < endRow; ++by)
+		{
+			for (U32 bx = 0; bx < blocksX; ++bx)
+			{
+				for (U32 i = 0; i < 16; ++i)
+				{
+					U32 x = bx * 4 + (i & 3);
+					U32 y = by * 4 + (i >> 2);
+					x = x < image.width ? x : image.width - 1;
+					y = y < image.height ? y : image.height - 1;
+					const U8* texel = &image.texels[((size_t)y * image.width + x) * 4];
+					block[4 * i] = texel[0];
+					block[4 * i + 1] = texel[1];
+					block[4 * i + 2] = texel[2];
+					block[4 * i + 3] = texel[3];
+				}
+
+				U8* dest = &out[((size_t)by * blocksX + bx) * blockBytes];
+				if (format == TEXTURE_FORMAT_BC1)
+				{
+					EncodeBC1Block(block, dest);
+				}
+				else
+				{
+					EncodeBC3Block(block, dest);
+				}
+			}
+		}
+	});
+}
+
+
+void BCEncoder::Decode(const U8* data, U32 width, U32 height, TextureFileFormat format, TextureImage& image)
+{
+	U32 blockBytes = format == TEXTURE_FORMAT_BC1 ? 8 : 16;
+	U32 blocksX = (width + 3) / 4;
+	U32 blocksY = (height + 3) / 4;
+
+	image.width = width;
+	image.height = height;
+	image.texels.resize((size_t)width * height * 4);
+
+	U8 block[64];
+	for (U32 by = 0; by < blocksY; ++by)
+	{
+		for (U32 bx = 0; bx < blocksX; ++bx)
+		{
+			const U8* in = data + ((size_t)by * blocksX + bx) * blockBytes;
+			if (format == TEXTURE_FORMAT_BC1)
+			{
+				DecodeBC1Block(in, block);
+			}
+			else
+			{
+				DecodeBC3Block(in, block);
+			}
+
+			for (U32 i = 0; i < 16; ++i)
+			{
+				U32 x = bx * 4 + (i & 3);
+				U32 y = by * 4 + (i >> 2);
+				if (x < width && y < height)
+				{
+					U8* texel = &image.texels[((size_t)y * width + x) * 4];
+					texel[0] = block[4 * i];
+					texel[1] = block[4 * i + 1];
+					texel[2] = block[4 * i + 2];
+					texel[3] = block[4 * i + 3];
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "TextureCook.h"
+
+
+// block compression for cooked textures, every 4x4 block of RGBA texels becomes 8 bytes of BC1 or 16 of BC3.
+// colour endpoints come from the principal axis of the block and are refit by least squares to the chosen indices,
+// blocks of one colour use tables of the endpoint pairs whose interpolant lands closest to it
+class BCEncoder
+{
+public:
+	// block holds 16 texels of R, G, B, A bytes in rows
+	static void EncodeBC1Block(const U8 block[64], U8 out[8]);
+	static void EncodeBC3Block(const U8 block[64], U8 out[16]);
+
+	// the decoders follow the D3D rules, they are used to measure what the encoders lose
+	static void DecodeBC1Block(const U8 in[8], U8 block[64]);
+	static void DecodeBC3Block(const U8 in[16], U8 block[64]);
+
+	// whole image, partial blocks at the edges repeat their last texel. block rows are split across threads,
+	// 0 threads uses every hardware thread
+	static void Encode(const TextureImage& image, TextureFileFormat format, std::vector<U8>& out, U32 numThreads = 0);
+	static void Decode(const U8* data, U32 width, U32 height, TextureFileFormat format, TextureImage& image);
+};
\ No newline at end of file
@@ -0,0 +1,194 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "MeshCook.h"
+#include "OBJImporter.h"
+#include "VertexQuantizer.h"
+#include "OBJLoader.h"
+#include "MappedFile.h"
+#include <float.h>
+#include <stdio.h>
+
+
+U32 PackMeshColor(float r, float g, float b, float a)
+{
+	const float rgba[4] = { r, g, b, a };
+
+	U32 packed = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		float c = rgba[i] < 0.f ? 0.f : (rgba[i] > 1.f ? 1.f : rgba[i]);
+		packed |= (U32)(U8)(255.f * c) << (8 * i);
+	}
+	return packed;
+}
+
+
+bool ImportOBJ(const char* path, CookedMesh& mesh, U32 numThreads)
+{
+	MappedFile file;
+	if (!file.Open(path) || !OBJImporter::Parse(reinterpret_cast<const char*>(file.GetData()), file.GetSize(), mesh, numThreads, path))
+	{
+		return false;
+	}
+
+	ComputeMeshBounds(mesh);
+	return true;
+}
+
+
+bool ImportOBJReference(const char* path, CookedMesh& mesh)
+{
+	std::vector<OBJLoader::Vertex> objVerts;
+	if (!OBJLoader::LoadFromFile(path, objVerts, mesh.indices))
+	{
+		return false;
+	}
+
+	mesh.vertices.resize(objVerts.size());
+	for (size_t i = 0; i < objVerts.size(); ++i)
+	{
+		MeshVertex& v = mesh.vertices[i];
+		v.x = objVerts[i].Position[0];
+		v.y = objVerts[i].Position[1];
+		v.z = objVerts[i].Position[2];
+		v.nx = objVerts[i].Normal[0];
+		v.ny = objVerts[i].Normal[1];
+		v.nz = objVerts[i].Normal[2];
+		v.u = objVerts[i].UV[0];
+		v.v = objVerts[i].UV[1];
+		v.color = PackMeshColor(objVerts[i].Color[0], objVerts[i].Color[1], objVerts[i].Color[2], objVerts[i].Color[3]);
+	}
+
+	ComputeMeshBounds(mesh);
+	return true;
+}
+
+
+void ComputeMeshBounds(CookedMesh& mesh)
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		mesh.boundsMin[i] = mesh.vertices.empty() ? 0.f : FLT_MAX;
+		mesh.boundsMax[i] = mesh.vertices.empty() ? 0.f : -FLT_MAX;
+	}
+
+	for (const MeshVertex& v : mesh.vertices)
+	{
+		const float pos[3] = { v.x, v.y, v.z };
+		for (int i = 0; i < 3; ++i)
+		{
+			mesh.boundsMin[i] = pos[i] < mesh.boundsMin[i] ? pos[i] : mesh.boundsMin[i];
+			mesh.boundsMax[i] = pos[i] > mesh.boundsMax[i] ? pos[i] : mesh.boundsMax[i];
+		}
+	}
+}
+
+
+static bool WritePadding(FILE* file, U64& offset)
+{
+	static const U8 zeros[MESH_FILE_ALIGNMENT] = {};
+
+	U64 aligned = AlignMeshOffset(offset);
+	size_t padding = (size_t)(aligned - offset);
+	offset = aligned;
+	return fwrite(zeros, 1, padding, file) == padding;
+}
+
+
+bool WriteMeshFile(const char* path, const CookedMesh& mesh, MeshVertexFormat format)
+{
+	if (mesh.vertices.empty() || mesh.indices.empty())
+	{
+		printf("error: %s has no triangles\n", path);
+		return false;
+	}
+
+	std::vector<MeshVertexQuantized> quantized;
+	const void* vertices = mesh.vertices.data();
+	if (format == MESH_VERTEX_QUANTIZED)
+	{
+		VertexQuantizer::Encode(mesh, quantized);
+		vertices = quantized.data();
+	}
+
+	MeshFileHeader header = {};
+	header.magic = MESH_FILE_MAGIC;
+	header.version = MESH_FILE_VERSION;
+	header.vertexFormat = format;
+	header.vertexStride = GetMeshVertexStride(format);
+	header.numVertices = (U32)mesh.vertices.size();
+	header.numIndices = (U32)mesh.indices.size();
+	header.vertexOffset = AlignMeshOffset(sizeof(MeshFileHeader));
+	header.indexOffset = AlignMeshOffset(header.vertexOffset + (U64)header.numVertices * header.vertexStride);
+	for (int i = 0; i < 3; ++i)
+	{
+		header.boundsMin[i] = mesh.boundsMin[i];
+		header.boundsMax[i] = mesh.boundsMax[i];
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		printf("error: could not open %s for writing\n", path);
+		return false;
+	}
+
+	U64 offset = sizeof(header);
+	size_t vertexBytes = mesh.vertices.size() * header.vertexStride;
+	size_t indexBytes = mesh.indices.size() * sizeof(U32);
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		WritePadding(file, offset) &&
+		fwrite(vertices, 1, vertexBytes, file) == vertexBytes;
+
+	offset += vertexBytes;
+	written = written && WritePadding(file, offset) &&
+		fwrite(mesh.indices.data(), 1, indexBytes, file) == indexBytes;
+
+	written = fclose(file) == 0 && written;
+	if (!written)
+	{
+		printf("error: failed writing %s\n", path);
+	}
+
+	return written;
+}
+
+
+bool WriteLodFile(const char* path, const CookedMesh& mesh)
+{
+	LodFileHeader header = {};
+	header.magic = LOD_FILE_MAGIC;
+	header.version = LOD_FILE_VERSION;
+	header.numVertices = (U32)mesh.vertices.size();
+	header.numLevels = (U32)mesh.lods.size();
+	header.indexOffset = AlignMeshOffset(sizeof(LodFileHeader));
+	for (size_t i = 0; i < mesh.lods.size(); ++i)
+	{
+		header.levels[i].firstIndex = header.numIndices;
+		header.levels[i].numIndices = (U32)mesh.lods[i].indices.size();
+		header.levels[i].error = mesh.lods[i].error;
+		header.numIndices += header.levels[i].numIndices;
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		printf("error: could not open %s for writing\n", path);
+		return false;
+	}
+
+	U64 offset = sizeof(header);
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 && WritePadding(file, offset);
+	for (const MeshLod& lod : mesh.lods)
+	{
+		written = written && fwrite(lod.indices.data(), sizeof(U32), lod.indices.size(), file) == lod.indices.size();
+	}
+
+	written = fclose(file) == 0 && written;
+	if (!written)
+	{
+		printf("error: failed writing %s\n", path);
+	}
+
+	return written;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "MeshFile.h"
+#include <vector>
+
+
+// a reduced level of detail over the same vertices
+struct MeshLod
+{
+	std::vector<U32> indices;
+	float error = 0.f;
+};
+
+
+// a mesh on its way to a cooked file, vertices are already in the runtime layout
+struct CookedMesh
+{
+	std::vector<MeshVertex> vertices;
+	std::vector<U32> indices;
+	std::vector<MeshLod> lods;
+	float boundsMin[3] = {};
+	float boundsMax[3] = {};
+};
+
+
+// parses an OBJ source with the multithreaded importer, 0 threads uses every hardware thread
+bool ImportOBJ(const char* path, CookedMesh& mesh, U32 numThreads = 0);
+
+// the runtime path, tinyobj through OBJLoader converted like Model::ReadOBJ, kept to check and time the importer against
+bool ImportOBJReference(const char* path, CookedMesh& mesh);
+
+// same packing as MakeColorUInt, which lives with the d3d vertex formats
+U32 PackMeshColor(float r, float g, float b, float a);
+
+void ComputeMeshBounds(CookedMesh& mesh);
+
+// quantized files encode the vertices with VertexQuantizer across the mesh bounds
+bool WriteMeshFile(const char* path, const CookedMesh& mesh, MeshVertexFormat format = MESH_VERTEX_POS_NORM_UV_COLOR);
+
+// the .lod sidecar for mesh.lods, written beside the mesh
+bool WriteLodFile(const char* path, const CookedMesh& mesh);
\ No newline at end of file
@@ -0,0 +1,418 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <math.h>
+
+
+static const U32 NO_TRIANGLE = 0xffffffff;
+static const U32 NO_VERTEX = 0xffffffff;
+
+// Forsyth's tuning, the cache is modelled larger than the hardware one so the order holds up on any of them
+static const int FORSYTH_CACHE_SIZE = 32;
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+static const U32 MAX_SCORED_VALENCE = 32;
+
+static const U32 VERTEX_FETCH_LINE = 64;
+static const U32 VERTEX_FETCH_LINES = 64;
+
+
+// FIFO cache over timestamps, an entry is in the cache while fewer than size misses came after it
+class FIFOCache
+{
+public:
+	FIFOCache(size_t numEntries, U32 size) : m_stamps(numEntries, 0), m_time(size), m_size(size)
+	{
+	}
+
+	// returns true on a miss
+	bool Touch(U32 entry)
+	{
+		if (m_time - m_stamps[entry] < m_size)
+		{
+			return false;
+		}
+
+		m_stamps[entry] = ++m_time;
+		return true;
+	}
+
+	void Reset()
+	{
+		m_time += m_size;
+	}
+
+private:
+	std::vector<U32> m_stamps;
+	U32 m_time;
+	U32 m_size;
+};
+
+
+class ForsythScores
+{
+public:
+	ForsythScores()
+	{
+		for (int i = 0; i < FORSYTH_CACHE_SIZE; ++i)
+		{
+			m_cache[i] = i < 3 ? LAST_TRIANGLE_SCORE : powf(1.f - (float)(i - 3) / (FORSYTH_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+		}
+
+		m_valence[0] = 0.f;
+		for (U32 i = 1; i <= MAX_SCORED_VALENCE; ++i)
+		{
+			m_valence[i] = VALENCE_BOOST_SCALE * powf((float)i, -VALENCE_BOOST_POWER);
+		}
+	}
+
+	// vertices with nothing left to draw score nothing, the rest score by cache position and how few triangles remain
+	float Vertex(int cachePosition, U32 remaining) const
+	{
+		if (remaining == 0)
+		{
+			return -1.f;
+		}
+
+		float score = cachePosition >= 0 ? m_cache[cachePosition] : 0.f;
+		return score + m_valence[remaining < MAX_SCORED_VALENCE ? remaining : MAX_SCORED_VALENCE];
+	}
+
+private:
+	float m_cache[FORSYTH_CACHE_SIZE];
+	float m_valence[MAX_SCORED_VALENCE + 1];
+};
+
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<U32>& indices, size_t numVertices)
+{
+	static const ForsythScores scores;
+
+	size_t numTriangles = indices.size() / 3;
+	if (numTriangles == 0)
+	{
+		return;
+	}
+
+	// triangles around each vertex, the first remaining[v] entries are the ones not drawn yet
+	std::vector<U32> remaining(numVertices, 0);
+	for (U32 index : indices)
+	{
+		remaining[index]++;
+	}
+
+	std::vector<U32> offsets(numVertices + 1, 0);
+	for (size_t v = 0; v < numVertices; ++v)
+	{
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+
+	std::vector<U32> adjacency(indices.size());
+	std::vector<U32> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0; i < indices.size(); ++i)
+	{
+		adjacency[fill[indices[i]]++] = (U32)(i / 3);
+	}
+
+	std::vector<int> cachePosition(numVertices, -1);
+	std::vector<float> vertexScore(numVertices);
+	for (size_t v = 0; v < numVertices; ++v)
+	{
+		vertexScore[v] = scores.Vertex(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScore(numTriangles);
+	std::vector<bool> drawn(numTriangles, false);
+	U32 best = 0;
+	for (size_t t = 0; t < numTriangles; ++t)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+		best = triangleScore[t] > triangleScore[best] ? (U32)t : best;
+	}
+
+	std::vector<U32> output;
+	output.reserve(indices.size());
+
+	std::vector<U32> cache;
+	std::vector<U32> nextCache;
+	cache.reserve(FORSYTH_CACHE_SIZE + 3);
+	nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+	size_t cursor = 0;
+	for (size_t n = 0; n < numTriangles; ++n)
+	{
+		// nothing in the cache has triangles left, start again from the next undrawn one in input order
+		if (best == NO_TRIANGLE)
+		{
+			while (drawn[cursor])
+			{
+				++cursor;
+			}
+			best = (U32)cursor;
+		}
+
+		const U32* tri = &indices[best * 3];
+		output.insert(output.end(), tri, tri + 3);
+		drawn[best] = true;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			U32 v = tri[k];
+			U32* first = &adjacency[offsets[v]];
+			U32* last = first + remaining[v] - 1;
+			U32* found = std::find(first, last + 1, best);
+			std::swap(*found, *last);
+			remaining[v]--;
+		}
+
+		// the triangle's vertices move to the front, the rest keep their order behind them
+		nextCache.assign(tri, tri + 3);
+		for (U32 v : cache)
+		{
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+			{
+				nextCache.push_back(v);
+			}
+		}
+
+		best = NO_TRIANGLE;
+		float bestScore = -1.f;
+		for (size_t i = 0; i < nextCache.size(); ++i)
+		{
+			U32 v = nextCache[i];
+			cachePosition[v] = i < FORSYTH_CACHE_SIZE ? (int)i : -1;
+			vertexScore[v] = scores.Vertex(cachePosition[v], remaining[v]);
+		}
+
+		for (size_t i = 0; i < nextCache.size(); ++i)
+		{
+			U32 v = nextCache[i];
+			for (U32 a = offsets[v]; a < offsets[v] + remaining[v]; ++a)
+			{
+				U32 t = adjacency[a];
+				triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+				if (triangleScore[t] > bestScore)
+				{
+					bestScore = triangleScore[t];
+					best = t;
+				}
+			}
+		}
+
+		if (nextCache.size() > FORSYTH_CACHE_SIZE)
+		{
+			nextCache.resize(FORSYTH_CACHE_SIZE);
+		}
+		cache.swap(nextCache);
+	}
+
+	indices.swap(output);
+}
+
+
+struct TriangleCluster
+{
+	U32 first;
+	U32 count;
+	float sortKey;
+};
+
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<U32>& indices, const std::vector<MeshVertex>& vertices, float threshold)
+{
+	static const U32 CLUSTER_CACHE_SIZE = 16;
+
+	U32 numTriangles = (U32)(indices.size() / 3);
+	if (numTriangles < 2)
+	{
+		return;
+	}
+
+	// hard boundaries where the cache has nothing to reuse, the order can be cut there for free
+	FIFOCache cache(vertices.size(), CLUSTER_CACHE_SIZE);
+	std::vector<U32> hard;
+	for (U32 t = 0; t < numTriangles; ++t)
+	{
+		int misses = cache.Touch(indices[t * 3]) + cache.Touch(indices[t * 3 + 1]) + cache.Touch(indices[t * 3 + 2]);
+		if (misses == 3 || t == 0)
+		{
+			hard.push_back(t);
+		}
+	}
+	hard.push_back(numTriangles);
+
+	// soft boundaries inside them wherever the cluster so far misses no more than threshold times the whole one
+	std::vector<TriangleCluster> clusters;
+	for (size_t h = 0; h + 1 < hard.size(); ++h)
+	{
+		U32 start = hard[h];
+		U32 end = hard[h + 1];
+
+		cache.Reset();
+		U32 clusterMisses = 0;
+		for (U32 t = start; t < end; ++t)
+		{
+			clusterMisses += cache.Touch(indices[t * 3]) + cache.Touch(indices[t * 3 + 1]) + cache.Touch(indices[t * 3 + 2]);
+		}
+		float limit = threshold * clusterMisses / (end - start);
+
+		cache.Reset();
+		U32 misses = 0;
+		U32 first = start;
+		for (U32 t = start; t < end; ++t)
+		{
+			misses += cache.Touch(indices[t * 3]) + cache.Touch(indices[t * 3 + 1]) + cache.Touch(indices[t * 3 + 2]);
+			if (t + 1 == end || (float)misses / (t + 1 - first) <= limit)
+			{
+				clusters.push_back({ first, t + 1 - first, 0.f });
+				first = t + 1;
+				misses = 0;
+				cache.Reset();
+			}
+		}
+	}
+
+	// area weighted centre of the whole mesh
+	float centre[3] = {};
+	float totalArea = 0.f;
+	std::vector<float> triangleData(numTriangles * 7);
+	for (U32 t = 0; t < numTriangles; ++t)
+	{
+		const MeshVertex& a = vertices[indices[t * 3]];
+		const MeshVertex& b = vertices[indices[t * 3 + 1]];
+		const MeshVertex& c = vertices[indices[t * 3 + 2]];
+
+		float e0[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+		float e1[3] = { c.x - a.x, c.y - a.y, c.z - a.z };
+		float n[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+		float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+		float* data = &triangleData[t * 7];
+		data[0] = (a.x + b.x + c.x) / 3.f;
+		data[1] = (a.y + b.y + c.y) / 3.f;
+		data[2] = (a.z + b.z + c.z) / 3.f;
+		data[3] = n[0];
+		data[4] = n[1];
+		data[5] = n[2];
+		data[6] = area;
+
+		for (int i = 0; i < 3; ++i)
+		{
+			centre[i] += data[i] * area;
+		}
+		totalArea += area;
+	}
+
+	for (int i = 0; i < 3 && totalArea > 0.f; ++i)
+	{
+		centre[i] /= totalArea;
+	}
+
+	// clusters facing away from the centre are on the outside and likely to cover the others, so they go first
+	for (TriangleCluster& cluster : clusters)
+	{
+		float clusterCentre[3] = {};
+		float normal[3] = {};
+		float area = 0.f;
+		for (U32 t = cluster.first; t < cluster.first + cluster.count; ++t)
+		{
+			const float* data = &triangleData[t * 7];
+			for (int i = 0; i < 3; ++i)
+			{
+				clusterCentre[i] += data[i] * data[6];
+				normal[i] += data[3 + i];
+			}
+			area += data[6];
+		}
+
+		float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (area > 0.f && length > 0.f)
+		{
+			cluster.sortKey = ((clusterCentre[0] / area - centre[0]) * normal[0] +
+				(clusterCentre[1] / area - centre[1]) * normal[1] +
+				(clusterCentre[2] / area - centre[2]) * normal[2]) / length;
+		}
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(), [](const TriangleCluster& a, const TriangleCluster& b)
+	{
+		return a.sortKey > b.sortKey;
+	});
+
+	std::vector<U32> output;
+	output.reserve(indices.size());
+	for (const TriangleCluster& cluster : clusters)
+	{
+		output.insert(output.end(), indices.begin() + cluster.first * 3, indices.begin() + (cluster.first + cluster.count) * 3);
+	}
+
+	indices.swap(output);
+}
+
+
+void MeshOptimizer::OptimizeVertexFetch(CookedMesh& mesh)
+{
+	std::vector<U32> remap(mesh.vertices.size(), NO_VERTEX);
+	std::vector<MeshVertex> vertices;
+	vertices.reserve(mesh.vertices.size());
+
+	for (U32& index : mesh.indices)
+	{
+		if (remap[index] == NO_VERTEX)
+		{
+			remap[index] = (U32)vertices.size();
+			vertices.push_back(mesh.vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	mesh.vertices.swap(vertices);
+}
+
+
+void MeshOptimizer::Optimize(CookedMesh& mesh)
+{
+	OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+	OptimizeOverdraw(mesh.indices, mesh.vertices);
+	OptimizeVertexFetch(mesh);
+}
+
+
+MeshCacheStats MeshOptimizer::Analyze(const CookedMesh& mesh, U32 cacheSize)
+{
+	MeshCacheStats stats;
+	size_t numTriangles = mesh.indices.size() / 3;
+	if (numTriangles == 0 || mesh.vertices.empty())
+	{
+		return stats;
+	}
+
+	size_t bufferBytes = mesh.vertices.size() * sizeof(MeshVertex);
+	FIFOCache transformCache(mesh.vertices.size(), cacheSize);
+	FIFOCache fetchCache((bufferBytes + VERTEX_FETCH_LINE - 1) / VERTEX_FETCH_LINE, VERTEX_FETCH_LINES);
+
+	U32 misses = 0;
+	U64 fetchedLines = 0;
+	for (U32 index : mesh.indices)
+	{
+		if (!transformCache.Touch(index))
+		{
+			continue;
+		}
+
+		// every vertex shader run reads the vertex, which may straddle two lines
+		misses++;
+		size_t firstLine = index * sizeof(MeshVertex) / VERTEX_FETCH_LINE;
+		size_t lastLine = ((index + 1) * sizeof(MeshVertex) - 1) / VERTEX_FETCH_LINE;
+		for (size_t line = firstLine; line <= lastLine; ++line)
+		{
+			fetchedLines += fetchCache.Touch((U32)line) ? 1 : 0;
+		}
+	}
+
+	stats.acmr = (float)misses / numTriangles;
+	stats.atvr = (float)misses / mesh.vertices.size();
+	stats.overfetch = (float)(fetchedLines * VERTEX_FETCH_LINE) / bufferBytes;
+	return stats;
+}
\ No newline at end of file
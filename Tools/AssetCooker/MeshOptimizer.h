@@ -0,0 +1,33 @@
+#pragma once
+
+#include "MeshCook.h"
+
+
+// post transform cache and vertex fetch figures for an index order, lower is better for all three
+struct MeshCacheStats
+{
+	float acmr = 0.f;			// vertex shader runs per triangle, 0.5 is the floor for a regular grid, 3 means no reuse
+	float atvr = 0.f;			// vertex shader runs per vertex, 1 is the floor
+	float overfetch = 0.f;		// bytes read from the vertex buffer over its size, 1 is the floor
+};
+
+
+// the stages run in this order when a mesh is cooked, every stage keeps each triangle's winding
+class MeshOptimizer
+{
+public:
+	// Forsyth's linear speed reordering of triangles for a small post transform cache
+	static void OptimizeVertexCache(std::vector<U32>& indices, size_t numVertices);
+
+	// splits the cache optimized order into clusters and draws the most outward facing first, so closer geometry
+	// covers the rest. clusters are only cut where the cache miss rate stays within threshold of the input's
+	static void OptimizeOverdraw(std::vector<U32>& indices, const std::vector<MeshVertex>& vertices, float threshold = 1.05f);
+
+	// renumbers vertices in order of first use so fetches walk the buffer forwards, drops unused vertices
+	static void OptimizeVertexFetch(CookedMesh& mesh);
+
+	static void Optimize(CookedMesh& mesh);
+
+	// simulates a FIFO post transform cache like most hardware and a small cache of 64 byte lines for fetch
+	static MeshCacheStats Analyze(const CookedMesh& mesh, U32 cacheSize = 16);
+};
\ No newline at end of file
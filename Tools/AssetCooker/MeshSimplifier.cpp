@@ -0,0 +1,662 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <numeric>
+#include <stddef.h>
+#include <string.h>
+
+
+static const U32 NO_VERTEX = 0xffffffff;
+
+// open borders and seams pull this much harder than the surface, so collapses stay along them
+static const double BORDER_WEIGHT = 10.0;
+
+// a pass takes collapses up to this much over the error of the one that would reach the target, the rest wait
+// for the next pass once their neighbourhood has settled
+static const float PASS_ERROR_SLACK = 1.5f;
+
+// a collapse may turn a triangle by up to about 75 degrees, limiting it per collapse rather than just rejecting
+// flips keeps passes from folding the surface a little at a time
+static const double MIN_NORMAL_COS = 0.25;
+
+// a level has to keep no more than this share of the previous level's triangles, and stray no further than this
+// share of the bounds diagonal from the source, or the chain ends
+static const float MAX_LOD_SHARE = 0.85f;
+static const float MAX_LOD_ERROR = 0.1f;
+
+
+// plane distance quadric, accumulated over the planes around a vertex and weighted by area
+struct Quadric
+{
+	double a2 = 0.0, b2 = 0.0, c2 = 0.0, d2 = 0.0;
+	double ab = 0.0, ac = 0.0, ad = 0.0, bc = 0.0, bd = 0.0, cd = 0.0;
+	double w = 0.0;
+
+	void AddPlane(double a, double b, double c, double d, double weight)
+	{
+		a2 += a * a * weight;
+		b2 += b * b * weight;
+		c2 += c * c * weight;
+		d2 += d * d * weight;
+		ab += a * b * weight;
+		ac += a * c * weight;
+		ad += a * d * weight;
+		bc += b * c * weight;
+		bd += b * d * weight;
+		cd += c * d * weight;
+		w += weight;
+	}
+
+	void Add(const Quadric& q)
+	{
+		a2 += q.a2;
+		b2 += q.b2;
+		c2 += q.c2;
+		d2 += q.d2;
+		ab += q.ab;
+		ac += q.ac;
+		ad += q.ad;
+		bc += q.bc;
+		bd += q.bd;
+		cd += q.cd;
+		w += q.w;
+	}
+
+	// weighted mean of the squared distances to the planes
+	double Evaluate(const MeshVertex& v) const
+	{
+		double x = v.x, y = v.y, z = v.z;
+		double r = a2 * x * x + b2 * y * y + c2 * z * z + 2.0 * (ab * x * y + ac * x * z + bc * y * z) +
+			2.0 * (ad * x + bd * y + cd * z) + d2;
+		return fabs(r) / (w > 0.0 ? w : 1.0);
+	}
+};
+
+
+// from and to are position groups, the collapse moves every vertex of from onto the matching vertex of to
+struct EdgeCollapse
+{
+	U32 from;
+	U32 to;
+	float error;
+};
+
+
+static void Cross(const MeshVertex& a, const MeshVertex& b, const MeshVertex& c, double n[3])
+{
+	double e0[3] = { (double)b.x - a.x, (double)b.y - a.y, (double)b.z - a.z };
+	double e1[3] = { (double)c.x - a.x, (double)c.y - a.y, (double)c.z - a.z };
+	n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+	n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+	n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+}
+
+
+static U64 EdgeKey(U32 a, U32 b)
+{
+	return ((U64)a << 32) | b;
+}
+
+
+class Simplifier
+{
+public:
+	Simplifier(const std::vector<MeshVertex>& vertices, std::vector<U32>& indices)
+		: m_vertices(vertices), m_indices(indices), m_numVertices(vertices.size())
+	{
+		GroupPositions();
+
+		m_quadrics.resize(m_numVertices);
+		m_remap.resize(m_numVertices);
+		m_locked.resize(m_numVertices);
+		m_border.resize(m_numVertices);
+	}
+
+	float Run(size_t targetIndexCount)
+	{
+		float maxError = 0.f;
+		bool first = true;
+
+		while (m_indices.size() > targetIndexCount)
+		{
+			BuildEdges();
+			BuildAdjacency();
+
+			if (first)
+			{
+				AddSurfaceQuadrics();
+				first = false;
+			}
+
+			std::vector<EdgeCollapse> collapses;
+			PickCollapses(collapses);
+			if (collapses.empty())
+			{
+				break;
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const EdgeCollapse& a, const EdgeCollapse& b)
+			{
+				return a.error < b.error;
+			});
+
+			size_t trianglesToRemove = (m_indices.size() - targetIndexCount) / 3;
+			size_t collapseGoal = trianglesToRemove / 2;
+			float errorLimit = collapseGoal < collapses.size() ? collapses[collapseGoal].error * PASS_ERROR_SLACK : FLT_MAX;
+
+			size_t performed = PerformCollapses(collapses, trianglesToRemove, errorLimit, maxError);
+			if (performed == 0)
+			{
+				break;
+			}
+
+			RemapIndices();
+		}
+
+		return sqrtf(maxError);
+	}
+
+private:
+	// vertices sharing a position form a group, told apart only by their normals, uvs or colours. the group is
+	// named by its lowest vertex and its vertices are chained in a ring. vertices that also share uvs and colour
+	// form a chart group, different normals alone are a soft seam that collapses may cross
+	void GroupPositions()
+	{
+		static const size_t POSITION_BYTES = sizeof(float) * 3;
+		static const size_t CHART_OFFSET = offsetof(MeshVertex, u);
+		static const size_t CHART_BYTES = sizeof(MeshVertex) - CHART_OFFSET;
+
+		auto compare = [&](U32 a, U32 b)
+		{
+			int c = memcmp(&m_vertices[a].x, &m_vertices[b].x, POSITION_BYTES);
+			if (c == 0)
+			{
+				c = memcmp(reinterpret_cast<const U8*>(&m_vertices[a]) + CHART_OFFSET, reinterpret_cast<const U8*>(&m_vertices[b]) + CHART_OFFSET, CHART_BYTES);
+			}
+			return c < 0 || (c == 0 && a < b);
+		};
+
+		std::vector<U32> order(m_numVertices);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), compare);
+
+		m_group.resize(m_numVertices);
+		m_chart.resize(m_numVertices);
+		m_nextWedge.resize(m_numVertices);
+		for (size_t i = 0; i < m_numVertices; ++i)
+		{
+			U32 v = order[i];
+			U32 prev = i > 0 ? order[i - 1] : v;
+			m_nextWedge[v] = v;
+
+			if (i > 0 && memcmp(&m_vertices[v].x, &m_vertices[prev].x, POSITION_BYTES) == 0)
+			{
+				U32 head = m_group[prev];
+				m_group[v] = head;
+				m_nextWedge[v] = m_nextWedge[head];
+				m_nextWedge[head] = v;
+
+				bool sameChart = memcmp(reinterpret_cast<const U8*>(&m_vertices[v]) + CHART_OFFSET, reinterpret_cast<const U8*>(&m_vertices[prev]) + CHART_OFFSET, CHART_BYTES) == 0;
+				m_chart[v] = sameChart ? m_chart[prev] : v;
+			}
+			else
+			{
+				m_group[v] = v;
+				m_chart[v] = v;
+			}
+		}
+	}
+
+	// directed edges between the charts of the current triangles, sorted so an edge without its reverse can be
+	// found as a border. that's an open edge of the mesh or a uv or colour seam
+	void BuildEdges()
+	{
+		m_edges.resize(m_indices.size());
+		for (size_t t = 0; t < m_indices.size(); t += 3)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				m_edges[t + k] = EdgeKey(m_chart[m_indices[t + k]], m_chart[m_indices[t + (k + 1) % 3]]);
+			}
+		}
+		std::sort(m_edges.begin(), m_edges.end());
+
+		std::fill(m_border.begin(), m_border.end(), 0);
+		for (size_t t = 0; t < m_indices.size(); t += 3)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				U32 a = m_indices[t + k];
+				U32 b = m_indices[t + (k + 1) % 3];
+				if (IsBorderEdge(a, b))
+				{
+					m_border[m_group[a]] = 1;
+					m_border[m_group[b]] = 1;
+				}
+			}
+		}
+	}
+
+	bool IsBorderEdge(U32 a, U32 b) const
+	{
+		return !std::binary_search(m_edges.begin(), m_edges.end(), EdgeKey(m_chart[b], m_chart[a]));
+	}
+
+	void BuildAdjacency()
+	{
+		m_offsets.assign(m_numVertices + 1, 0);
+		for (U32 index : m_indices)
+		{
+			m_offsets[index + 1]++;
+		}
+
+		for (size_t v = 0; v < m_numVertices; ++v)
+		{
+			m_offsets[v + 1] += m_offsets[v];
+		}
+
+		m_adjacency.resize(m_indices.size());
+		std::vector<U32> fill(m_offsets.begin(), m_offsets.end() - 1);
+		for (size_t i = 0; i < m_indices.size(); ++i)
+		{
+			m_adjacency[fill[m_indices[i]]++] = (U32)(i / 3);
+		}
+	}
+
+	// triangle planes weighted by area, then planes standing on border edges to hold borders and seams in place
+	void AddSurfaceQuadrics()
+	{
+		for (size_t t = 0; t < m_indices.size(); t += 3)
+		{
+			const U32* tri = &m_indices[t];
+			double n[3];
+			Cross(m_vertices[tri[0]], m_vertices[tri[1]], m_vertices[tri[2]], n);
+
+			double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if (length == 0.0)
+			{
+				continue;
+			}
+
+			n[0] /= length;
+			n[1] /= length;
+			n[2] /= length;
+
+			const MeshVertex& p0 = m_vertices[tri[0]];
+			double d = -(n[0] * p0.x + n[1] * p0.y + n[2] * p0.z);
+			for (int k = 0; k < 3; ++k)
+			{
+				m_quadrics[m_group[tri[k]]].AddPlane(n[0], n[1], n[2], d, length * 0.5);
+			}
+
+			for (int k = 0; k < 3; ++k)
+			{
+				U32 a = tri[k];
+				U32 b = tri[(k + 1) % 3];
+				if (!IsBorderEdge(a, b))
+				{
+					continue;
+				}
+
+				const MeshVertex& pa = m_vertices[a];
+				const MeshVertex& pb = m_vertices[b];
+				double e[3] = { (double)pb.x - pa.x, (double)pb.y - pa.y, (double)pb.z - pa.z };
+				double edgeLength2 = e[0] * e[0] + e[1] * e[1] + e[2] * e[2];
+				double p[3] = { e[1] * n[2] - e[2] * n[1], e[2] * n[0] - e[0] * n[2], e[0] * n[1] - e[1] * n[0] };
+				double pLength = sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+				if (pLength == 0.0)
+				{
+					continue;
+				}
+
+				p[0] /= pLength;
+				p[1] /= pLength;
+				p[2] /= pLength;
+				double pd = -(p[0] * pa.x + p[1] * pa.y + p[2] * pa.z);
+				m_quadrics[m_group[a]].AddPlane(p[0], p[1], p[2], pd, edgeLength2 * BORDER_WEIGHT);
+				m_quadrics[m_group[b]].AddPlane(p[0], p[1], p[2], pd, edgeLength2 * BORDER_WEIGHT);
+			}
+		}
+	}
+
+	// finds the vertex of group to that each used vertex of group from lands on: the one it shares an edge with,
+	// or across a soft seam the one in the chart it reaches with the closest normal. fails if a vertex reaches no
+	// chart of to or more than one, which happens when from sits on a seam that the edge leaves, or if from is on a
+	// border and the edge isn't
+	bool MatchWedges(U32 from, U32 to, std::vector<std::pair<U32, U32>>& targets) const
+	{
+		targets.clear();
+		bool borderEdge = false;
+
+		U32 w = from;
+		do
+		{
+			if (m_offsets[w + 1] > m_offsets[w])
+			{
+				U32 target = NO_VERTEX;
+				if (!FindNeighbour(w, to, target, borderEdge))
+				{
+					return false;
+				}
+
+				if (target == NO_VERTEX)
+				{
+					target = FindAcrossSoftSeam(w, to);
+					if (target == NO_VERTEX)
+					{
+						return false;
+					}
+				}
+
+				targets.push_back({ w, target });
+			}
+
+			w = m_nextWedge[w];
+		} while (w != from);
+
+		return !targets.empty() && (!m_border[from] || borderEdge);
+	}
+
+	// the vertex of group to that shares a triangle with w, false if there are several
+	bool FindNeighbour(U32 w, U32 to, U32& target, bool& borderEdge) const
+	{
+		for (U32 a = m_offsets[w]; a < m_offsets[w + 1]; ++a)
+		{
+			const U32* tri = &m_indices[m_adjacency[a] * 3];
+			for (int k = 0; k < 3; ++k)
+			{
+				U32 c = m_remap[tri[k]];
+				if (m_group[c] != to)
+				{
+					continue;
+				}
+
+				if (target != NO_VERTEX && target != c)
+				{
+					return false;
+				}
+				target = c;
+
+				// the corner before this one in the triangle or the one after it is w
+				U32 prev = tri[(k + 2) % 3];
+				U32 next = tri[(k + 1) % 3];
+				borderEdge = borderEdge || (prev == w && IsBorderEdge(w, tri[k])) || (next == w && IsBorderEdge(tri[k], w));
+			}
+		}
+
+		return true;
+	}
+
+	// w has no edge to the group but another vertex in its chart does, so w is only split from it by normals
+	U32 FindAcrossSoftSeam(U32 w, U32 to) const
+	{
+		U32 chart = NO_VERTEX;
+		for (U32 s = m_nextWedge[w]; s != w; s = m_nextWedge[s])
+		{
+			if (m_chart[s] != m_chart[w])
+			{
+				continue;
+			}
+
+			for (U32 a = m_offsets[s]; a < m_offsets[s + 1]; ++a)
+			{
+				const U32* tri = &m_indices[m_adjacency[a] * 3];
+				for (int k = 0; k < 3; ++k)
+				{
+					U32 c = m_remap[tri[k]];
+					if (m_group[c] != to)
+					{
+						continue;
+					}
+
+					if (chart != NO_VERTEX && chart != m_chart[c])
+					{
+						return NO_VERTEX;
+					}
+					chart = m_chart[c];
+				}
+			}
+		}
+
+		U32 best = NO_VERTEX;
+		float bestDot = -2.f;
+		const MeshVertex& n = m_vertices[w];
+		U32 c = to;
+		do
+		{
+			const MeshVertex& m = m_vertices[c];
+			float dot = n.nx * m.nx + n.ny * m.ny + n.nz * m.nz;
+			if (chart != NO_VERTEX && m_chart[c] == chart && m_offsets[c + 1] > m_offsets[c] && dot > bestDot)
+			{
+				best = c;
+				bestDot = dot;
+			}
+			c = m_nextWedge[c];
+		} while (c != to);
+
+		return best;
+	}
+
+	void PickCollapses(std::vector<EdgeCollapse>& collapses)
+	{
+		std::vector<U64> groupEdges;
+		groupEdges.reserve(m_indices.size());
+		for (size_t t = 0; t < m_indices.size(); t += 3)
+		{
+			for (int k = 0; k < 3; ++k)
+			{
+				U32 a = m_group[m_indices[t + k]];
+				U32 b = m_group[m_indices[t + (k + 1) % 3]];
+				groupEdges.push_back(a < b ? EdgeKey(a, b) : EdgeKey(b, a));
+			}
+		}
+		std::sort(groupEdges.begin(), groupEdges.end());
+		groupEdges.erase(std::unique(groupEdges.begin(), groupEdges.end()), groupEdges.end());
+
+		std::iota(m_remap.begin(), m_remap.end(), 0);
+
+		std::vector<std::pair<U32, U32>> targets;
+		for (U64 key : groupEdges)
+		{
+			U32 g[2] = { (U32)(key >> 32), (U32)key };
+
+			EdgeCollapse best = { NO_VERTEX, NO_VERTEX, FLT_MAX };
+			for (int dir = 0; dir < 2; ++dir)
+			{
+				U32 from = g[dir];
+				U32 to = g[1 - dir];
+				if (!MatchWedges(from, to, targets))
+				{
+					continue;
+				}
+
+				Quadric q = m_quadrics[from];
+				q.Add(m_quadrics[to]);
+				float error = (float)q.Evaluate(m_vertices[to]);
+				if (error < best.error)
+				{
+					best = { from, to, error };
+				}
+			}
+
+			if (best.from != NO_VERTEX)
+			{
+				collapses.push_back(best);
+			}
+		}
+	}
+
+	// checked against the collapses already taken this pass, a triangle that turns too far is rejected. that also
+	// catches slivers, which stand on edge once they've turned
+	bool FlipsTriangles(const std::vector<std::pair<U32, U32>>& targets) const
+	{
+		for (const std::pair<U32, U32>& target : targets)
+		{
+			for (U32 a = m_offsets[target.first]; a < m_offsets[target.first + 1]; ++a)
+			{
+				const U32* tri = &m_indices[m_adjacency[a] * 3];
+				U32 before[3] = { m_remap[tri[0]], m_remap[tri[1]], m_remap[tri[2]] };
+				U32 after[3] = { before[0], before[1], before[2] };
+				for (int k = 0; k < 3; ++k)
+				{
+					after[k] = after[k] == target.first ? target.second : after[k];
+				}
+
+				if (IsDegenerate(before) || IsDegenerate(after))
+				{
+					continue;
+				}
+
+				double n0[3];
+				double n1[3];
+				Cross(m_vertices[before[0]], m_vertices[before[1]], m_vertices[before[2]], n0);
+				Cross(m_vertices[after[0]], m_vertices[after[1]], m_vertices[after[2]], n1);
+				double dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+				double lengths = sqrt((n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]) * (n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]));
+				if (dot <= MIN_NORMAL_COS * lengths)
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool IsDegenerate(const U32 tri[3]) const
+	{
+		U32 g0 = m_group[tri[0]];
+		U32 g1 = m_group[tri[1]];
+		U32 g2 = m_group[tri[2]];
+		return g0 == g1 || g1 == g2 || g0 == g2;
+	}
+
+	// both groups of a collapse are locked for the rest of the pass, so remaps never chain
+	size_t PerformCollapses(const std::vector<EdgeCollapse>& collapses, size_t trianglesToRemove, float errorLimit, float& maxError)
+	{
+		std::fill(m_locked.begin(), m_locked.end(), 0);
+
+		size_t performed = 0;
+		size_t removed = 0;
+		std::vector<std::pair<U32, U32>> targets;
+		for (const EdgeCollapse& collapse : collapses)
+		{
+			if (collapse.error > errorLimit || removed >= trianglesToRemove)
+			{
+				break;
+			}
+
+			if (m_locked[collapse.from] || m_locked[collapse.to] ||
+				!MatchWedges(collapse.from, collapse.to, targets) || FlipsTriangles(targets))
+			{
+				continue;
+			}
+
+			for (const std::pair<U32, U32>& target : targets)
+			{
+				for (U32 a = m_offsets[target.first]; a < m_offsets[target.first + 1]; ++a)
+				{
+					const U32* tri = &m_indices[m_adjacency[a] * 3];
+					U32 corners[3] = { m_remap[tri[0]], m_remap[tri[1]], m_remap[tri[2]] };
+					bool touchesTo = m_group[corners[0]] == collapse.to || m_group[corners[1]] == collapse.to || m_group[corners[2]] == collapse.to;
+					removed += touchesTo && !IsDegenerate(corners) ? 1 : 0;
+				}
+			}
+
+			for (const std::pair<U32, U32>& target : targets)
+			{
+				m_remap[target.first] = target.second;
+			}
+
+			m_quadrics[collapse.to].Add(m_quadrics[collapse.from]);
+			m_locked[collapse.from] = 1;
+			m_locked[collapse.to] = 1;
+			maxError = collapse.error > maxError ? collapse.error : maxError;
+			++performed;
+		}
+
+		return performed;
+	}
+
+	void RemapIndices()
+	{
+		size_t out = 0;
+		for (size_t t = 0; t < m_indices.size(); t += 3)
+		{
+			U32 tri[3] = { m_remap[m_indices[t]], m_remap[m_indices[t + 1]], m_remap[m_indices[t + 2]] };
+			if (!IsDegenerate(tri))
+			{
+				m_indices[out++] = tri[0];
+				m_indices[out++] = tri[1];
+				m_indices[out++] = tri[2];
+			}
+		}
+		m_indices.resize(out);
+	}
+
+	const std::vector<MeshVertex>& m_vertices;
+	std::vector<U32>& m_indices;
+	size_t m_numVertices;
+
+	std::vector<U32> m_group;
+	std::vector<U32> m_chart;
+	std::vector<U32> m_nextWedge;
+	std::vector<Quadric> m_quadrics;		// by group
+	std::vector<U32> m_remap;				// by vertex, this pass's collapses
+	std::vector<U8> m_locked;				// by group
+	std::vector<U8> m_border;				// by group
+	std::vector<U64> m_edges;
+	std::vector<U32> m_offsets;
+	std::vector<U32> m_adjacency;
+};
+
+
+float MeshSimplifier::Simplify(const std::vector<MeshVertex>& vertices, const std::vector<U32>& indices, size_t targetIndexCount,
+	std::vector<U32>& result)
+{
+	result = indices;
+	if (result.size() <= targetIndexCount || vertices.empty())
+	{
+		return 0.f;
+	}
+
+	Simplifier simplifier(vertices, result);
+	return simplifier.Run(targetIndexCount);
+}
+
+
+void MeshSimplifier::GenerateLods(CookedMesh& mesh, const float* ratios, U32 numRatios)
+{
+	mesh.lods.clear();
+
+	float extent[3] = {};
+	for (int i = 0; i < 3; ++i)
+	{
+		extent[i] = mesh.boundsMax[i] - mesh.boundsMin[i];
+	}
+	float maxError = MAX_LOD_ERROR * sqrtf(extent[0] * extent[0] + extent[1] * extent[1] + extent[2] * extent[2]);
+
+	size_t numTriangles = mesh.indices.size() / 3;
+	size_t previous = mesh.indices.size();
+	float previousError = 0.f;
+	for (U32 i = 0; i < numRatios && mesh.lods.size() < MAX_MESH_LODS; ++i)
+	{
+		MeshLod lod;
+		size_t target = (size_t)(numTriangles * ratios[i]) * 3;
+		lod.error = Simplify(mesh.vertices, mesh.indices, target, lod.indices);
+		if (lod.indices.empty() || lod.indices.size() > previous * MAX_LOD_SHARE || lod.error > maxError)
+		{
+			break;
+		}
+
+		// levels are simplified from the source independently, keep the errors rising for runtime selection
+		lod.error = lod.error > previousError ? lod.error : previousError;
+		MeshOptimizer::OptimizeVertexCache(lod.indices, mesh.vertices.size());
+
+		previous = lod.indices.size();
+		previousError = lod.error;
+		mesh.lods.push_back(std::move(lod));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "MeshCook.h"
+
+
+// Quadric error edge collapse simplifier for building LOD chains. Vertices only ever collapse onto other existing
+// vertices, so every level indexes the mesh's own vertex buffer and only adds indices. Open borders and UV or
+// normal seams can only collapse along themselves, which keeps outlines and texture layout intact.
+class MeshSimplifier
+{
+public:
+	// simplifies towards targetIndexCount, fewer collapses happen if the mesh runs out of legal ones. returns the
+	// largest error taken, an RMS distance from the source surface in mesh units
+	static float Simplify(const std::vector<MeshVertex>& vertices, const std::vector<U32>& indices, size_t targetIndexCount,
+		std::vector<U32>& result);
+
+	// fills mesh.lods with levels at each ratio of the source's triangles, cache optimized. a level that fails to
+	// drop a meaningful share of the previous one's triangles or loses the shape ends the chain
+	static void GenerateLods(CookedMesh& mesh, const float* ratios, U32 numRatios);
+};
\ No newline at end of file
@@ -0,0 +1,813 @@
+#include "OBJImporter.h"
+#include "WriteLog.h"
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <string>
+#include <thread>
+
+
+// chunks smaller than this aren't worth a thread
+static const size_t MIN_CHUNK_BYTES = 256 * 1024;
+static const size_t MIN_GATHER_VERTICES = 64 * 1024;
+
+static const I32 MISSING_INDEX = INT_MIN;
+static const U32 EMPTY_SLOT = 0xffffffff;
+
+// set in Corner::relative when the matching index counts back from the end of its chunk
+static const U8 RELATIVE_V = 1;
+static const U8 RELATIVE_VT = 2;
+static const U8 RELATIVE_VN = 4;
+
+
+struct Corner
+{
+	I32 v;
+	I32 vt;
+	I32 vn;
+	U8 relative;
+};
+
+
+struct OBJChunk
+{
+	const char* begin;
+	const char* end;
+
+	std::vector<float> positions;
+	std::vector<float> colors;
+	std::vector<float> texcoords;
+	std::vector<float> normals;
+
+	// face corners in file order, three per triangle once polygons are split
+	std::vector<Corner> corners;
+
+	// faces with more than three corners, as ranges in corners
+	std::vector<std::pair<size_t, U32>> polygons;
+
+	// counts in the chunks before this one
+	I32 basePositions = 0;
+	I32 baseTexcoords = 0;
+	I32 baseNormals = 0;
+
+	const char* error = nullptr;
+};
+
+
+static inline bool IsSpace(char c)
+{
+	return c == ' ' || c == '\t';
+}
+
+
+static inline const char* SkipSpaces(const char* p, const char* end)
+{
+	while (p < end && IsSpace(*p))
+	{
+		++p;
+	}
+	return p;
+}
+
+
+static inline const char* SkipLine(const char* p, const char* end)
+{
+	while (p < end && *p != '\n')
+	{
+		++p;
+	}
+	return p < end ? p + 1 : end;
+}
+
+
+// decimal with optional fraction and exponent, exact for the digits exporters write, returns null if there's no number
+static const char* ParseFloat(const char* p, const char* end, float& out)
+{
+	static const double POW10[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	p = SkipSpaces(p, end);
+
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		++p;
+	}
+
+	U64 mantissa = 0;
+	int exponent = 0;
+	int digits = 0;
+	bool any = false;
+
+	while (p < end && *p >= '0' && *p <= '9')
+	{
+		if (digits < 19)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			digits += mantissa != 0 ? 1 : 0;
+		}
+		else
+		{
+			exponent++;
+		}
+		any = true;
+		++p;
+	}
+
+	if (p < end && *p == '.')
+	{
+		++p;
+		while (p < end && *p >= '0' && *p <= '9')
+		{
+			if (digits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				digits += mantissa != 0 ? 1 : 0;
+				exponent--;
+			}
+			any = true;
+			++p;
+		}
+	}
+
+	if (!any)
+	{
+		return nullptr;
+	}
+
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		const char* e = p + 1;
+		bool negativeExponent = false;
+		if (e < end && (*e == '-' || *e == '+'))
+		{
+			negativeExponent = *e == '-';
+			++e;
+		}
+
+		if (e < end && *e >= '0' && *e <= '9')
+		{
+			int value = 0;
+			while (e < end && *e >= '0' && *e <= '9')
+			{
+				value = value < 10000 ? value * 10 + (*e - '0') : value;
+				++e;
+			}
+			exponent += negativeExponent ? -value : value;
+			p = e;
+		}
+	}
+
+	double value = (double)mantissa;
+	if (exponent >= 0 && exponent <= 22)
+	{
+		value *= POW10[exponent];
+	}
+	else if (exponent < 0 && exponent >= -22)
+	{
+		value /= POW10[-exponent];
+	}
+	else
+	{
+		value *= pow(10.0, exponent);
+	}
+
+	out = (float)(negative ? -value : value);
+	return p;
+}
+
+
+static const char* ParseInt(const char* p, const char* end, I32& out)
+{
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		++p;
+	}
+
+	if (p >= end || *p < '0' || *p > '9')
+	{
+		return nullptr;
+	}
+
+	I64 value = 0;
+	while (p < end && *p >= '0' && *p <= '9')
+	{
+		value = value < INT_MAX ? value * 10 + (*p - '0') : value;
+		++p;
+	}
+
+	value = value > INT_MAX ? INT_MAX : value;
+	out = (I32)(negative ? -value : value);
+	return p;
+}
+
+
+// positive indices are global and 1 based, negative ones count back from the last element read so far in the chunk
+static inline bool ResolveIndex(I32 index, size_t count, U8 relativeBit, I32& out, U8& relative)
+{
+	if (index > 0)
+	{
+		out = index - 1;
+		return true;
+	}
+
+	if (index < 0)
+	{
+		out = (I32)count + index;
+		relative |= relativeBit;
+		return true;
+	}
+
+	return false;
+}
+
+
+// v, v/vt, v//vn or v/vt/vn
+static const char* ParseCorner(const char* p, const char* end, OBJChunk& chunk, Corner& corner)
+{
+	corner.vt = MISSING_INDEX;
+	corner.vn = MISSING_INDEX;
+	corner.relative = 0;
+
+	I32 index;
+	p = ParseInt(p, end, index);
+	if (p == nullptr || !ResolveIndex(index, chunk.positions.size() / 3, RELATIVE_V, corner.v, corner.relative))
+	{
+		return nullptr;
+	}
+
+	if (p < end && *p == '/')
+	{
+		++p;
+		if (p < end && *p != '/')
+		{
+			p = ParseInt(p, end, index);
+			if (p == nullptr || !ResolveIndex(index, chunk.texcoords.size() / 2, RELATIVE_VT, corner.vt, corner.relative))
+			{
+				return nullptr;
+			}
+		}
+
+		if (p < end && *p == '/')
+		{
+			++p;
+			p = ParseInt(p, end, index);
+			if (p == nullptr || !ResolveIndex(index, chunk.normals.size() / 3, RELATIVE_VN, corner.vn, corner.relative))
+			{
+				return nullptr;
+			}
+		}
+	}
+
+	return p;
+}
+
+
+static const char* ParseFace(const char* p, const char* end, OBJChunk& chunk)
+{
+	size_t first = chunk.corners.size();
+
+	for (;;)
+	{
+		p = SkipSpaces(p, end);
+		if (p >= end || *p == '\n' || *p == '\r' || *p == '#')
+		{
+			break;
+		}
+
+		Corner corner;
+		p = ParseCorner(p, end, chunk, corner);
+		if (p == nullptr)
+		{
+			chunk.error = "malformed face";
+			return nullptr;
+		}
+
+		chunk.corners.push_back(corner);
+	}
+
+	// points and lines have nothing to draw, polygons are split once every position is known
+	U32 numCorners = (U32)(chunk.corners.size() - first);
+	if (numCorners < 3)
+	{
+		chunk.corners.resize(first);
+	}
+	else if (numCorners > 3)
+	{
+		chunk.polygons.emplace_back(first, numCorners);
+	}
+
+	return p;
+}
+
+
+static void ParseChunk(OBJChunk& chunk)
+{
+	const char* p = chunk.begin;
+	const char* end = chunk.end;
+	while (p < end)
+	{
+		p = SkipSpaces(p, end);
+		if (p + 1 >= end)
+		{
+			break;
+		}
+
+		if (p[0] == 'v' && IsSpace(p[1]))
+		{
+			float xyz[3];
+			const char* q = p + 1;
+			for (int i = 0; i < 3 && q != nullptr; ++i)
+			{
+				q = ParseFloat(q, end, xyz[i]);
+			}
+
+			if (q == nullptr)
+			{
+				chunk.error = "malformed vertex";
+				return;
+			}
+
+			// optional vertex colour, white if absent
+			float rgb[3] = { 1.f, 1.f, 1.f };
+			float r, g, b;
+			const char* c = ParseFloat(q, end, r);
+			c = c != nullptr ? ParseFloat(c, end, g) : nullptr;
+			c = c != nullptr ? ParseFloat(c, end, b) : nullptr;
+			if (c != nullptr)
+			{
+				rgb[0] = r;
+				rgb[1] = g;
+				rgb[2] = b;
+			}
+
+			chunk.positions.insert(chunk.positions.end(), xyz, xyz + 3);
+			chunk.colors.insert(chunk.colors.end(), rgb, rgb + 3);
+		}
+		else if (p[0] == 'v' && p[1] == 't')
+		{
+			float uv[2];
+			const char* q = ParseFloat(p + 2, end, uv[0]);
+			q = q != nullptr ? ParseFloat(q, end, uv[1]) : nullptr;
+			if (q == nullptr)
+			{
+				// a lone u is allowed, v defaults to zero like tinyobj
+				if (ParseFloat(p + 2, end, uv[0]) == nullptr)
+				{
+					chunk.error = "malformed texture coordinate";
+					return;
+				}
+				uv[1] = 0.f;
+			}
+
+			chunk.texcoords.insert(chunk.texcoords.end(), uv, uv + 2);
+		}
+		else if (p[0] == 'v' && p[1] == 'n')
+		{
+			float n[3];
+			const char* q = p + 2;
+			for (int i = 0; i < 3 && q != nullptr; ++i)
+			{
+				q = ParseFloat(q, end, n[i]);
+			}
+
+			if (q == nullptr)
+			{
+				chunk.error = "malformed normal";
+				return;
+			}
+
+			chunk.normals.insert(chunk.normals.end(), n, n + 3);
+		}
+		else if (p[0] == 'f' && IsSpace(p[1]))
+		{
+			if (ParseFace(p + 1, end, chunk) == nullptr)
+			{
+				return;
+			}
+		}
+
+		p = SkipLine(p, end);
+	}
+}
+
+
+static const float* ChunkElement(const std::vector<OBJChunk>& chunks, const std::vector<float> OBJChunk::* array,
+	I32 OBJChunk::* base, I32 index, int width)
+{
+	// chunks are few, a linear walk back from the last one is cheaper than keeping a merged copy
+	size_t c = chunks.size() - 1;
+	while (chunks[c].*base > index)
+	{
+		--c;
+	}
+	return &(chunks[c].*array)[(size_t)(index - chunks[c].*base) * width];
+}
+
+
+static const float* CornerPosition(const std::vector<OBJChunk>& chunks, const Corner& corner)
+{
+	return ChunkElement(chunks, &OBJChunk::positions, &OBJChunk::basePositions, corner.v, 3);
+}
+
+
+// point in triangle by crossings, the same test tinyobj uses
+static bool InsideTriangle(const float* vx, const float* vy, float tx, float ty)
+{
+	bool inside = false;
+	for (int i = 0, j = 2; i < 3; j = i++)
+	{
+		if (((vy[i] > ty) != (vy[j] > ty)) && (tx < (vx[j] - vx[i]) * (ty - vy[i]) / (vy[j] - vy[i]) + vx[i]))
+		{
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+
+
+// ear clipping in the polygon's dominant plane, follows tinyobj step for step so cooked meshes split their
+// polygons exactly like the runtime loader did
+static void TriangulatePolygon(const Corner* polygon, U32 numCorners, const std::vector<OBJChunk>& chunks,
+	std::vector<Corner>& remaining, std::vector<Corner>& triangles)
+{
+	size_t axes[2] = { 1, 2 };
+	for (U32 k = 0; k < numCorners; ++k)
+	{
+		const float* v0 = CornerPosition(chunks, polygon[k]);
+		const float* v1 = CornerPosition(chunks, polygon[(k + 1) % numCorners]);
+		const float* v2 = CornerPosition(chunks, polygon[(k + 2) % numCorners]);
+
+		float e0x = v1[0] - v0[0];
+		float e0y = v1[1] - v0[1];
+		float e0z = v1[2] - v0[2];
+		float e1x = v2[0] - v1[0];
+		float e1y = v2[1] - v1[1];
+		float e1z = v2[2] - v1[2];
+		float cx = fabsf(e0y * e1z - e0z * e1y);
+		float cy = fabsf(e0z * e1x - e0x * e1z);
+		float cz = fabsf(e0x * e1y - e0y * e1x);
+		if (cx > FLT_EPSILON || cy > FLT_EPSILON || cz > FLT_EPSILON)
+		{
+			if (!(cx > cy && cx > cz))
+			{
+				axes[0] = 0;
+				if (cz > cx && cz > cy)
+				{
+					axes[1] = 1;
+				}
+			}
+			break;
+		}
+	}
+
+	float area = 0.f;
+	for (U32 k = 0; k < numCorners; ++k)
+	{
+		const float* v0 = CornerPosition(chunks, polygon[k]);
+		const float* v1 = CornerPosition(chunks, polygon[(k + 1) % numCorners]);
+		area += (v0[axes[0]] * v1[axes[1]] - v0[axes[1]] * v1[axes[0]]) * 0.5f;
+	}
+
+	remaining.assign(polygon, polygon + numCorners);
+	size_t guess = 0;
+	size_t iterationsLeft = numCorners;
+	size_t previousRemaining = numCorners;
+
+	while (remaining.size() > 3 && iterationsLeft > 0)
+	{
+		size_t count = remaining.size();
+		guess = guess >= count ? guess - count : guess;
+
+		if (previousRemaining != count)
+		{
+			previousRemaining = count;
+			iterationsLeft = count;
+		}
+		else
+		{
+			iterationsLeft--;
+		}
+
+		Corner ear[3];
+		float vx[3];
+		float vy[3];
+		for (size_t k = 0; k < 3; ++k)
+		{
+			ear[k] = remaining[(guess + k) % count];
+			const float* v = CornerPosition(chunks, ear[k]);
+			vx[k] = v[axes[0]];
+			vy[k] = v[axes[1]];
+		}
+
+		// reflex corner
+		float cross = (vx[1] - vx[0]) * (vy[2] - vy[1]) - (vy[1] - vy[0]) * (vx[2] - vx[1]);
+		if (cross * area < 0.f)
+		{
+			guess++;
+			continue;
+		}
+
+		bool overlap = false;
+		for (size_t other = 3; other < count && !overlap; ++other)
+		{
+			const float* v = CornerPosition(chunks, remaining[(guess + other) % count]);
+			overlap = InsideTriangle(vx, vy, v[axes[0]], v[axes[1]]);
+		}
+
+		if (overlap)
+		{
+			guess++;
+			continue;
+		}
+
+		triangles.insert(triangles.end(), ear, ear + 3);
+		remaining.erase(remaining.begin() + (guess + 1) % count);
+	}
+
+	// polygons the clipper can't finish are dropped like tinyobj does
+	if (remaining.size() == 3)
+	{
+		triangles.insert(triangles.end(), remaining.begin(), remaining.end());
+	}
+}
+
+
+// turns chunk relative indices into file indices, checks everything is in range and splits polygons
+static void ResolveChunk(OBJChunk& chunk, const std::vector<OBJChunk>& chunks, I32 numPositions, I32 numTexcoords, I32 numNormals)
+{
+	for (Corner& corner : chunk.corners)
+	{
+		corner.v += (corner.relative & RELATIVE_V) ? chunk.basePositions : 0;
+		corner.vt += (corner.relative & RELATIVE_VT) ? chunk.baseTexcoords : 0;
+		corner.vn += (corner.relative & RELATIVE_VN) ? chunk.baseNormals : 0;
+
+		if (corner.v < 0 || corner.v >= numPositions ||
+			(corner.vt != MISSING_INDEX && (corner.vt < 0 || corner.vt >= numTexcoords)) ||
+			(corner.vn != MISSING_INDEX && (corner.vn < 0 || corner.vn >= numNormals)))
+		{
+			chunk.error = "face index out of range";
+			return;
+		}
+	}
+
+	if (chunk.polygons.empty())
+	{
+		return;
+	}
+
+	std::vector<Corner> triangles;
+	std::vector<Corner> remaining;
+	triangles.reserve(chunk.corners.size() + chunk.polygons.size() * 3);
+
+	size_t next = 0;
+	for (const std::pair<size_t, U32>& polygon : chunk.polygons)
+	{
+		triangles.insert(triangles.end(), chunk.corners.begin() + next, chunk.corners.begin() + polygon.first);
+		TriangulatePolygon(&chunk.corners[polygon.first], polygon.second, chunks, remaining, triangles);
+		next = polygon.first + polygon.second;
+	}
+
+	triangles.insert(triangles.end(), chunk.corners.begin() + next, chunk.corners.end());
+	chunk.corners.swap(triangles);
+}
+
+
+template <typename Func>
+static void RunParallel(U32 numTasks, Func func)
+{
+	std::vector<std::thread> threads;
+	for (U32 i = 1; i < numTasks; ++i)
+	{
+		threads.emplace_back(func, i);
+	}
+
+	func(0);
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+
+static inline U64 HashCorner(const Corner& corner)
+{
+	// murmur3 finalizer over the packed triple, the low bits feed the table so they must depend on every field
+	U64 h = (U64)(U32)corner.v | ((U64)(U32)corner.vt << 32);
+	h ^= (U64)(U32)corner.vn * 0x9e3779b97f4a7c15ull;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdull;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ull;
+	h ^= h >> 33;
+	return h;
+}
+
+
+static inline bool SameCorner(const Corner& a, const Corner& b)
+{
+	return a.v == b.v && a.vt == b.vt && a.vn == b.vn;
+}
+
+
+// flat table of indices into the unique corner list, grows at half load
+class CornerTable
+{
+public:
+	CornerTable(size_t expected)
+	{
+		size_t capacity = 64;
+		while (capacity < expected * 2)
+		{
+			capacity *= 2;
+		}
+		m_slots.assign(capacity, EMPTY_SLOT);
+		m_mask = capacity - 1;
+	}
+
+	// returns the vertex index for the corner, adding it to unique if it's new
+	U32 Insert(const Corner& corner, std::vector<Corner>& unique)
+	{
+		size_t slot = HashCorner(corner) & m_mask;
+		for (;;)
+		{
+			U32 index = m_slots[slot];
+			if (index == EMPTY_SLOT)
+			{
+				index = (U32)unique.size();
+				unique.push_back(corner);
+				m_slots[slot] = index;
+
+				if (unique.size() * 2 > m_slots.size())
+				{
+					Grow(unique);
+				}
+				return index;
+			}
+
+			if (SameCorner(unique[index], corner))
+			{
+				return index;
+			}
+
+			slot = (slot + 1) & m_mask;
+		}
+	}
+
+private:
+	void Grow(const std::vector<Corner>& unique)
+	{
+		m_slots.assign(m_slots.size() * 2, EMPTY_SLOT);
+		m_mask = m_slots.size() - 1;
+
+		for (U32 i = 0; i < (U32)unique.size(); ++i)
+		{
+			size_t slot = HashCorner(unique[i]) & m_mask;
+			while (m_slots[slot] != EMPTY_SLOT)
+			{
+				slot = (slot + 1) & m_mask;
+			}
+			m_slots[slot] = i;
+		}
+	}
+
+	std::vector<U32> m_slots;
+	size_t m_mask;
+};
+
+
+bool OBJImporter::Parse(const char* text, size_t size, CookedMesh& mesh, U32 numThreads, const char* name)
+{
+	if (numThreads == 0)
+	{
+		numThreads = std::thread::hardware_concurrency();
+		numThreads = numThreads > 0 ? numThreads : 1;
+	}
+
+	size_t maxChunks = size / MIN_CHUNK_BYTES + 1;
+	U32 numChunks = (U32)(numThreads < maxChunks ? numThreads : maxChunks);
+
+	// split at line starts so no line straddles two chunks
+	std::vector<OBJChunk> chunks(numChunks);
+	const char* end = text + size;
+	const char* begin = text;
+	for (U32 i = 0; i < numChunks; ++i)
+	{
+		const char* split = i + 1 == numChunks ? end : text + size / numChunks * (i + 1);
+		split = split < begin ? begin : split;
+		while (split < end && split[-1] != '\n')
+		{
+			++split;
+		}
+
+		chunks[i].begin = begin;
+		chunks[i].end = split;
+		begin = split;
+	}
+
+	RunParallel(numChunks, [&chunks](U32 i) { ParseChunk(chunks[i]); });
+
+	I32 numPositions = 0;
+	I32 numTexcoords = 0;
+	I32 numNormals = 0;
+	for (OBJChunk& chunk : chunks)
+	{
+		if (chunk.error != nullptr)
+		{
+			DEBUG_ERROR("%s: %s", name, chunk.error);
+			return false;
+		}
+
+		chunk.basePositions = numPositions;
+		chunk.baseTexcoords = numTexcoords;
+		chunk.baseNormals = numNormals;
+		numPositions += (I32)(chunk.positions.size() / 3);
+		numTexcoords += (I32)(chunk.texcoords.size() / 2);
+		numNormals += (I32)(chunk.normals.size() / 3);
+	}
+
+	RunParallel(numChunks, [&](U32 i) { ResolveChunk(chunks[i], chunks, numPositions, numTexcoords, numNormals); });
+
+	for (const OBJChunk& chunk : chunks)
+	{
+		if (chunk.error != nullptr)
+		{
+			DEBUG_ERROR("%s: %s", name, chunk.error);
+			return false;
+		}
+	}
+
+	size_t numCorners = 0;
+	for (const OBJChunk& chunk : chunks)
+	{
+		numCorners += chunk.corners.size();
+	}
+
+	// dedupe in file order so vertices are numbered by first use, same as OBJLoader
+	std::vector<Corner> unique;
+	unique.reserve(numPositions);
+	mesh.indices.clear();
+	mesh.indices.reserve(numCorners);
+
+	CornerTable table(numPositions);
+	for (const OBJChunk& chunk : chunks)
+	{
+		for (const Corner& corner : chunk.corners)
+		{
+			mesh.indices.push_back(table.Insert(corner, unique));
+		}
+	}
+
+	// gather the vertex attributes in parallel, every vertex is written by exactly one thread
+	mesh.vertices.resize(unique.size());
+	U32 numGatherTasks = unique.size() < MIN_GATHER_VERTICES ? 1 : numThreads;
+	RunParallel(numGatherTasks, [&](U32 task)
+	{
+		size_t first = unique.size() * task / numGatherTasks;
+		size_t last = unique.size() * (task + 1) / numGatherTasks;
+		for (size_t i = first; i < last; ++i)
+		{
+			const Corner& corner = unique[i];
+			MeshVertex& vertex = mesh.vertices[i];
+
+			const float* pos = ChunkElement(chunks, &OBJChunk::positions, &OBJChunk::basePositions, corner.v, 3);
+			const float* col = ChunkElement(chunks, &OBJChunk::colors, &OBJChunk::basePositions, corner.v, 3);
+			vertex.x = pos[0];
+			vertex.y = pos[1];
+			vertex.z = pos[2];
+			vertex.color = PackMeshColor(col[0], col[1], col[2], 1.f);
+
+			if (corner.vn != MISSING_INDEX)
+			{
+				const float* n = ChunkElement(chunks, &OBJChunk::normals, &OBJChunk::baseNormals, corner.vn, 3);
+				vertex.nx = n[0];
+				vertex.ny = n[1];
+				vertex.nz = n[2];
+			}
+			else
+			{
+				vertex.nx = vertex.ny = vertex.nz = 0.f;
+			}
+
+			if (corner.vt != MISSING_INDEX)
+			{
+				const float* uv = ChunkElement(chunks, &OBJChunk::texcoords, &OBJChunk::baseTexcoords, corner.vt, 2);
+				vertex.u = uv[0];
+				vertex.v = uv[1];
+			}
+			else
+			{
+				vertex.u = vertex.v = 0.f;
+			}
+		}
+	});
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "MeshCook.h"
+#include <stddef.h>
+
+
+// Multithreaded OBJ parser for the cooker. The text is split at line boundaries and each chunk is parsed on its
+// own thread, then corners are deduplicated through a flat open addressing table. The output matches what
+// OBJLoader and tinyobj produce: vertices in order of first use, polygons fanned into triangles.
+// Missing normals and UVs come out as zero and missing colours as white, indices outside the file are an error.
+class OBJImporter
+{
+public:
+	// 0 threads uses every hardware thread
+	static bool Parse(const char* text, size_t size, CookedMesh& mesh, U32 numThreads = 0, const char* name = "obj");
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "PackageWriter.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <stdio.h>
+
+
+static bool ReadWholeFile(const std::string& path, std::vector<U8>& data)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr)
+	{
+		printf("error: could not open %s\n", path.c_str());
+		return false;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	data.resize(size > 0 ? (size_t)size : 0);
+	bool read = size >= 0 && fread(data.data(), 1, data.size(), file) == data.size();
+	fclose(file);
+
+	if (!read)
+	{
+		printf("error: failed reading %s\n", path.c_str());
+	}
+	return read;
+}
+
+
+static bool WritePadding(FILE* file, U64& offset)
+{
+	static const U8 zeros[PACKAGE_FILE_ALIGNMENT] = {};
+
+	U64 aligned = AlignPackageOffset(offset);
+	size_t padding = (size_t)(aligned - offset);
+	offset = aligned;
+	return fwrite(zeros, 1, padding, file) == padding;
+}
+
+
+bool WritePackageFile(const char* path, const std::vector<PackageSource>& sources)
+{
+	std::vector<const PackageSource*> sorted;
+	for (const PackageSource& source : sources)
+	{
+		sorted.push_back(&source);
+	}
+
+	std::sort(sorted.begin(), sorted.end(), [](const PackageSource* a, const PackageSource* b)
+	{
+		return StringHash(a->path.c_str()) < StringHash(b->path.c_str());
+	});
+
+	for (size_t i = 1; i < sorted.size(); ++i)
+	{
+		if (StringHash(sorted[i]->path.c_str()) == StringHash(sorted[i - 1]->path.c_str()))
+		{
+			printf("error: %s and %s have the same key, rename one\n", sorted[i - 1]->path.c_str(), sorted[i]->path.c_str());
+			return false;
+		}
+	}
+
+	std::vector<PackageEntry> entries(sorted.size());
+	std::string names;
+	for (size_t i = 0; i < sorted.size(); ++i)
+	{
+		entries[i].key = StringHash(sorted[i]->path.c_str());
+		entries[i].nameOffset = (U32)names.size();
+		names.append(sorted[i]->path.c_str(), sorted[i]->path.size() + 1);
+	}
+
+	PackageFileHeader header = {};
+	header.magic = PACKAGE_FILE_MAGIC;
+	header.version = PACKAGE_FILE_VERSION;
+	header.numEntries = (U32)entries.size();
+	header.namesSize = (U32)names.size();
+	header.entriesOffset = sizeof(PackageFileHeader);
+	header.namesOffset = header.entriesOffset + entries.size() * sizeof(PackageEntry);
+
+	// sizes first so the table of contents can go ahead of the data
+	std::vector<std::vector<U8>> data(sorted.size());
+	U64 offset = header.namesOffset + header.namesSize;
+	for (size_t i = 0; i < sorted.size(); ++i)
+	{
+		if (!ReadWholeFile(sorted[i]->file, data[i]))
+		{
+			return false;
+		}
+
+		offset = AlignPackageOffset(offset);
+		entries[i].offset = offset;
+		entries[i].size = data[i].size();
+		entries[i].modifiedTime = GetFileModifiedTime(sorted[i]->file.c_str());
+		offset += data[i].size();
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		printf("error: could not open %s for writing\n", path);
+		return false;
+	}
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(entries.data(), sizeof(PackageEntry), entries.size(), file) == entries.size() &&
+		fwrite(names.data(), 1, names.size(), file) == names.size();
+
+	offset = header.namesOffset + header.namesSize;
+	for (const std::vector<U8>& bytes : data)
+	{
+		written = written && WritePadding(file, offset) && fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+		offset += bytes.size();
+	}
+
+	written = fclose(file) == 0 && written;
+	if (!written)
+	{
+		printf("error: failed writing %s\n", path);
+	}
+
+	return written;
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "PackageFile.h"
+#include <string>
+#include <vector>
+
+
+// a file going into a package
+struct PackageSource
+{
+	std::string path;		// the path the engine loads it by, relative with forward slashes, e.g. "Assets/cube.mesh"
+	std::string file;		// where the cooker reads it from
+};
+
+
+// entries are sorted by the key of their path, fails when two paths hash to the same key or a file can't be read
+bool WritePackageFile(const char* path, const std::vector<PackageSource>& sources);
\ No newline at end of file
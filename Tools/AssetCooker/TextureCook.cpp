@@ -0,0 +1,354 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "TextureCook.h"
+#include "BCEncoder.h"
+#include "MappedFile.h"
+#include <math.h>
+#include <stdio.h>
+
+
+static const U32 TGA_HEADER_SIZE = 18;
+static const U8 TGA_TYPE_TRUE_COLOR = 2;
+static const U8 TGA_TYPE_TRUE_COLOR_RLE = 10;
+static const U8 TGA_DESCRIPTOR_RIGHT_TO_LEFT = 0x10;
+static const U8 TGA_DESCRIPTOR_TOP_TO_BOTTOM = 0x20;
+
+
+// source texels one destination texel covers along an axis and by how much, the weights sum to one
+struct FilterTap
+{
+	U32 index;
+	float weight;
+};
+
+
+bool ImportTGA(const char* path, TextureImage& image)
+{
+	MappedFile file;
+	if (!file.Open(path))
+	{
+		return false;
+	}
+
+	const U8* data = file.GetData();
+	size_t size = file.GetSize();
+	if (size < TGA_HEADER_SIZE)
+	{
+		printf("error: %s is too small to be a TGA\n", path);
+		return false;
+	}
+
+	U8 idLength = data[0];
+	U8 colorMapType = data[1];
+	U8 imageType = data[2];
+	U32 width = data[12] | (data[13] << 8);
+	U32 height = data[14] | (data[15] << 8);
+	U32 bytesPerTexel = data[16] / 8;
+	U8 descriptor = data[17];
+	if (colorMapType != 0 || (imageType != TGA_TYPE_TRUE_COLOR && imageType != TGA_TYPE_TRUE_COLOR_RLE) ||
+		(bytesPerTexel != 3 && bytesPerTexel != 4) || width == 0 || height == 0)
+	{
+		printf("error: %s is not a 24 or 32 bit true colour TGA\n", path);
+		return false;
+	}
+
+	image.width = width;
+	image.height = height;
+	image.texels.resize((size_t)width * height * 4);
+
+	const U8* read = data + TGA_HEADER_SIZE + idLength;
+	const U8* end = data + size;
+	size_t numTexels = (size_t)width * height;
+	size_t texel = 0;
+	bool allZeroAlpha = bytesPerTexel == 4;
+
+	auto store = [&](const U8* bgra)
+	{
+		// rows are stored bottom up unless the descriptor says otherwise
+		size_t row = texel / width;
+		size_t column = texel % width;
+		size_t y = (descriptor & TGA_DESCRIPTOR_TOP_TO_BOTTOM) ? row : height - 1 - row;
+		size_t x = (descriptor & TGA_DESCRIPTOR_RIGHT_TO_LEFT) ? width - 1 - column : column;
+
+		U8* dest = &image.texels[(y * width + x) * 4];
+		dest[0] = bgra[2];
+		dest[1] = bgra[1];
+		dest[2] = bgra[0];
+		dest[3] = bytesPerTexel == 4 ? bgra[3] : 255;
+		allZeroAlpha = allZeroAlpha && dest[3] == 0;
+		++texel;
+	};
+
+	while (texel < numTexels)
+	{
+		size_t count = 1;
+		bool run = false;
+		if (imageType == TGA_TYPE_TRUE_COLOR_RLE)
+		{
+			if (read >= end)
+			{
+				break;
+			}
+			run = (*read & 0x80) != 0;
+			count = (*read & 0x7f) + 1;
+			++read;
+		}
+		else
+		{
+			count = numTexels;
+		}
+
+		count = count < numTexels - texel ? count : numTexels - texel;
+		size_t needed = (run ? 1 : count) * bytesPerTexel;
+		if ((size_t)(end - read) < needed)
+		{
+			break;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			store(run ? read : read + i * bytesPerTexel);
+		}
+		read += needed;
+	}
+
+	if (texel < numTexels)
+	{
+		printf("error: %s is truncated\n", path);
+		return false;
+	}
+
+	// exporters that don't write alpha often leave it zero, treated as opaque like the DirectXTex loader does
+	if (allZeroAlpha)
+	{
+		for (size_t i = 0; i < numTexels; ++i)
+		{
+			image.texels[i * 4 + 3] = 255;
+		}
+	}
+
+	return true;
+}
+
+
+static void BuildFilterTaps(U32 srcSize, U32 dstSize, std::vector<std::vector<FilterTap>>& taps)
+{
+	float scale = (float)srcSize / dstSize;
+	taps.resize(dstSize);
+	for (U32 d = 0; d < dstSize; ++d)
+	{
+		float start = d * scale;
+		float end = (d + 1) * scale;
+		taps[d].clear();
+		for (U32 s = (U32)start; s < srcSize && (float)s < end; ++s)
+		{
+			float overlap = fminf(end, s + 1.f) - fmaxf(start, (float)s);
+			if (overlap > 0.f)
+			{
+				taps[d].push_back({ s, overlap / scale });
+			}
+		}
+	}
+}
+
+
+static U8 LinearToSRGB(float linear)
+{
+	linear = linear < 0.f ? 0.f : (linear > 1.f ? 1.f : linear);
+	float srgb = linear <= 0.0031308f ? linear * 12.92f : 1.055f * powf(linear, 1.f / 2.4f) - 0.055f;
+	return (U8)(srgb * 255.f + 0.5f);
+}
+
+
+void GenerateMips(const TextureImage& image, std::vector<TextureImage>& mips)
+{
+	float toLinear[256];
+	for (int i = 0; i < 256; ++i)
+	{
+		float srgb = i / 255.f;
+		toLinear[i] = srgb <= 0.04045f ? srgb / 12.92f : powf((srgb + 0.055f) / 1.055f, 2.4f);
+	}
+
+	mips.clear();
+	mips.push_back(image);
+
+	// each level is filtered from the float texels of the one above so rounding doesn't build up down the chain,
+	// alpha isn't gamma encoded and is filtered as it is
+	U32 width = image.width;
+	U32 height = image.height;
+	std::vector<float> level((size_t)width * height * 4);
+	for (size_t i = 0; i < (size_t)width * height; ++i)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			level[i * 4 + c] = toLinear[image.texels[i * 4 + c]];
+		}
+		level[i * 4 + 3] = image.texels[i * 4 + 3] / 255.f;
+	}
+
+	std::vector<std::vector<FilterTap>> tapsX;
+	std::vector<std::vector<FilterTap>> tapsY;
+	std::vector<float> rows;
+	std::vector<float> next;
+	while ((width > 1 || height > 1) && mips.size() < MAX_TEXTURE_MIPS)
+	{
+		U32 nextWidth = width > 1 ? width / 2 : 1;
+		U32 nextHeight = height > 1 ? height / 2 : 1;
+		BuildFilterTaps(width, nextWidth, tapsX);
+		BuildFilterTaps(height, nextHeight, tapsY);
+
+		rows.assign((size_t)nextWidth * height * 4, 0.f);
+		for (U32 y = 0; y < height; ++y)
+		{
+			for (U32 x = 0; x < nextWidth; ++x)
+			{
+				float* dest = &rows[((size_t)y * nextWidth + x) * 4];
+				for (const FilterTap& tap : tapsX[x])
+				{
+					const float* src = &level[((size_t)y * width + tap.index) * 4];
+					for (int c = 0; c < 4; ++c)
+					{
+						dest[c] += src[c] * tap.weight;
+					}
+				}
+			}
+		}
+
+		next.assign((size_t)nextWidth * nextHeight * 4, 0.f);
+		for (U32 y = 0; y < nextHeight; ++y)
+		{
+			for (const FilterTap& tap : tapsY[y])
+			{
+				const float* src = &rows[(size_t)tap.index * nextWidth * 4];
+				float* dest = &next[(size_t)y * nextWidth * 4];
+				for (U32 i = 0; i < nextWidth * 4; ++i)
+				{
+					dest[i] += src[i] * tap.weight;
+				}
+			}
+		}
+
+		TextureImage mip;
+		mip.width = nextWidth;
+		mip.height = nextHeight;
+		mip.texels.resize(next.size());
+		for (size_t i = 0; i < (size_t)nextWidth * nextHeight; ++i)
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				mip.texels[i * 4 + c] = LinearToSRGB(next[i * 4 + c]);
+			}
+			float alpha = next[i * 4 + 3];
+			mip.texels[i * 4 + 3] = (U8)((alpha < 0.f ? 0.f : (alpha > 1.f ? 1.f : alpha)) * 255.f + 0.5f);
+		}
+
+		mips.push_back(std::move(mip));
+		level.swap(next);
+		width = nextWidth;
+		height = nextHeight;
+	}
+}
+
+
+TextureFileFormat ChooseTextureFormat(const TextureImage& image)
+{
+	if (image.width % 4 != 0 || image.height % 4 != 0)
+	{
+		return TEXTURE_FORMAT_RGBA8;
+	}
+
+	for (size_t i = 3; i < image.texels.size(); i += 4)
+	{
+		if (image.texels[i] != 255)
+		{
+			return TEXTURE_FORMAT_BC3;
+		}
+	}
+
+	return TEXTURE_FORMAT_BC1;
+}
+
+
+void CookTexture(const std::vector<TextureImage>& mips, TextureFileFormat format, CookedTexture& texture, U32 numThreads)
+{
+	texture.format = format;
+	texture.flags = TEXTURE_FILE_SRGB;
+	texture.width = mips[0].width;
+	texture.height = mips[0].height;
+	texture.mips.resize(mips.size());
+
+	for (size_t i = 0; i < mips.size(); ++i)
+	{
+		if (format == TEXTURE_FORMAT_RGBA8)
+		{
+			texture.mips[i] = mips[i].texels;
+		}
+		else
+		{
+			BCEncoder::Encode(mips[i], format, texture.mips[i], numThreads);
+		}
+	}
+}
+
+
+static bool WritePadding(FILE* file, U64& offset)
+{
+	static const U8 zeros[TEXTURE_FILE_ALIGNMENT] = {};
+
+	U64 aligned = AlignTextureOffset(offset);
+	size_t padding = (size_t)(aligned - offset);
+	offset = aligned;
+	return fwrite(zeros, 1, padding, file) == padding;
+}
+
+
+bool WriteTextureFile(const char* path, const CookedTexture& texture)
+{
+	if (texture.mips.empty() || texture.mips.size() > MAX_TEXTURE_MIPS)
+	{
+		printf("error: %s has %zu mips\n", path, texture.mips.size());
+		return false;
+	}
+
+	TextureFileHeader header = {};
+	header.magic = TEXTURE_FILE_MAGIC;
+	header.version = TEXTURE_FILE_VERSION;
+	header.format = texture.format;
+	header.flags = texture.flags;
+	header.width = texture.width;
+	header.height = texture.height;
+	header.numMips = (U32)texture.mips.size();
+
+	U64 offset = sizeof(TextureFileHeader);
+	for (U32 i = 0; i < header.numMips; ++i)
+	{
+		offset = AlignTextureOffset(offset);
+		header.mips[i].offset = offset;
+		header.mips[i].size = (U32)texture.mips[i].size();
+		header.mips[i].rowPitch = GetTextureRowPitch(texture.format, GetTextureMipDimension(texture.width, i));
+		offset += header.mips[i].size;
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr)
+	{
+		printf("error: could not open %s for writing\n", path);
+		return false;
+	}
+
+	offset = sizeof(header);
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	for (const std::vector<U8>& mip : texture.mips)
+	{
+		written = written && WritePadding(file, offset) && fwrite(mip.data(), 1, mip.size(), file) == mip.size();
+		offset += mip.size();
+	}
+
+	written = fclose(file) == 0 && written;
+	if (!written)
+	{
+		printf("error: failed writing %s\n", path);
+	}
+
+	return written;
+}
\ No newline at end of file
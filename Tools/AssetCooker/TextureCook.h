@@ -0,0 +1,39 @@
+#pragma once
+
+#include "TextureFile.h"
+#include <vector>
+
+
+// an uncompressed image, texels are R, G, B, A bytes in rows from the top
+struct TextureImage
+{
+	U32 width = 0;
+	U32 height = 0;
+	std::vector<U8> texels;
+};
+
+
+// a texture on its way to a cooked file, mips hold the runtime data from the largest down
+struct CookedTexture
+{
+	TextureFileFormat format = TEXTURE_FORMAT_RGBA8;
+	U32 flags = 0;
+	U32 width = 0;
+	U32 height = 0;
+	std::vector<std::vector<U8>> mips;
+};
+
+
+// uncompressed and run length encoded true colour TGA at 24 or 32 bits, the formats the engine's textures use
+bool ImportTGA(const char* path, TextureImage& image);
+
+// the full chain down to 1x1 with mips[0] a copy of image. texels are taken as sRGB and every level is filtered from
+// the one above in linear light, odd sizes weight each source texel by how much of it the destination texel covers
+void GenerateMips(const TextureImage& image, std::vector<TextureImage>& mips);
+
+// BC3 when any texel isn't opaque, BC1 otherwise, RGBA8 when the top level isn't a whole number of blocks which
+// block compressed textures must be. 0 threads uses every hardware thread
+TextureFileFormat ChooseTextureFormat(const TextureImage& image);
+void CookTexture(const std::vector<TextureImage>& mips, TextureFileFormat format, CookedTexture& texture, U32 numThreads = 0);
+
+bool WriteTextureFile(const char* path, const CookedTexture& texture);
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "VertexQuantizer.h"
+#include <math.h>
+#include <string.h>
+
+
+static const float UNORM16_MAX = 65535.f;
+static const float SNORM16_MAX = 32767.f;
+static const float RADIANS_TO_DEGREES = 57.2957795f;
+
+
+static float SNorm16ToFloat(I16 q)
+{
+	float f = q / SNORM16_MAX;
+	return f < -1.f ? -1.f : f;
+}
+
+
+// matches DecodeOctahedral in the shaders
+static void DecodeOctahedral(I16 qx, I16 qy, float n[3])
+{
+	float x = SNorm16ToFloat(qx);
+	float y = SNorm16ToFloat(qy);
+	float z = 1.f - fabsf(x) - fabsf(y);
+	float t = z < 0.f ? -z : 0.f;
+	x += x >= 0.f ? -t : t;
+	y += y >= 0.f ? -t : t;
+
+	float length = sqrtf(x * x + y * y + z * z);
+	n[0] = x / length;
+	n[1] = y / length;
+	n[2] = z / length;
+}
+
+
+// projects onto the octahedron and folds the lower half over, then picks whichever of the four neighbouring
+// grid points decodes closest to the input rather than plain rounding
+static void EncodeOctahedral(const float n[3], I16& qx, I16& qy)
+{
+	float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+	if (l1 == 0.f)
+	{
+		qx = 0;
+		qy = 0;
+		return;
+	}
+
+	float x = n[0] / l1;
+	float y = n[1] / l1;
+	if (n[2] < 0.f)
+	{
+		float fx = (1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f);
+		float fy = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+		x = fx;
+		y = fy;
+	}
+
+	const float unit[3] = { n[0] / l1, n[1] / l1, n[2] / l1 };
+	float bestDot = -2.f;
+	for (int i = 0; i < 4; ++i)
+	{
+		float cx = (i & 1) ? ceilf(x * SNORM16_MAX) : floorf(x * SNORM16_MAX);
+		float cy = (i & 2) ? ceilf(y * SNORM16_MAX) : floorf(y * SNORM16_MAX);
+		I16 cqx = (I16)(cx < -SNORM16_MAX ? -SNORM16_MAX : (cx > SNORM16_MAX ? SNORM16_MAX : cx));
+		I16 cqy = (I16)(cy < -SNORM16_MAX ? -SNORM16_MAX : (cy > SNORM16_MAX ? SNORM16_MAX : cy));
+
+		float decoded[3];
+		DecodeOctahedral(cqx, cqy, decoded);
+		float dot = decoded[0] * unit[0] + decoded[1] * unit[1] + decoded[2] * unit[2];
+		if (dot > bestDot)
+		{
+			bestDot = dot;
+			qx = cqx;
+			qy = cqy;
+		}
+	}
+}
+
+
+U16 VertexQuantizer::FloatToHalf(float f)
+{
+	U32 bits;
+	memcpy(&bits, &f, sizeof(bits));
+
+	U32 sign = (bits >> 16) & 0x8000;
+	U32 absBits = bits & 0x7fffffff;
+
+	// infinity and nan, nan keeps a mantissa bit
+	if (absBits >= 0x7f800000)
+	{
+		return (U16)(sign | 0x7c00 | (absBits > 0x7f800000 ? 0x200 : 0));
+	}
+
+	// 65520 and up round to infinity
+	if (absBits >= 0x477ff000)
+	{
+		return (U16)(sign | 0x7c00);
+	}
+
+	// below the smallest normal half, denormals are multiples of 2^-24 and the rounding mode is nearest even
+	if (absBits < 0x38800000)
+	{
+		float magnitude;
+		memcpy(&magnitude, &absBits, sizeof(magnitude));
+		return (U16)(sign | (U32)nearbyintf(magnitude * 16777216.f));
+	}
+
+	U32 half = (((absBits >> 23) - 112) << 10) | ((absBits & 0x7fffff) >> 13);
+	U32 remainder = absBits & 0x1fff;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+	{
+		++half;
+	}
+
+	return (U16)(sign | half);
+}
+
+
+float VertexQuantizer::HalfToFloat(U16 h)
+{
+	U32 sign = (U32)(h & 0x8000) << 16;
+	U32 exponent = (h >> 10) & 0x1f;
+	U32 mantissa = h & 0x3ff;
+
+	if (exponent == 0)
+	{
+		float magnitude = mantissa / 16777216.f;
+		return sign ? -magnitude : magnitude;
+	}
+
+	U32 bits = sign | (exponent == 31 ? 0x7f800000 : (exponent + 112) << 23) | (mantissa << 13);
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+
+void VertexQuantizer::Encode(const CookedMesh& mesh, std::vector<MeshVertexQuantized>& quantized)
+{
+	float scale[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		float extent = mesh.boundsMax[i] - mesh.boundsMin[i];
+		scale[i] = extent > 0.f ? UNORM16_MAX / extent : 0.f;
+	}
+
+	quantized.resize(mesh.vertices.size());
+	for (size_t i = 0; i < mesh.vertices.size(); ++i)
+	{
+		const MeshVertex& v = mesh.vertices[i];
+		MeshVertexQuantized& q = quantized[i];
+
+		const float pos[3] = { v.x, v.y, v.z };
+		U16* qpos = &q.x;
+		for (int a = 0; a < 3; ++a)
+		{
+			float f = (pos[a] - mesh.boundsMin[a]) * scale[a] + 0.5f;
+			qpos[a] = (U16)(f < 0.f ? 0.f : (f > UNORM16_MAX ? UNORM16_MAX : f));
+		}
+		q.w = (U16)UNORM16_MAX;
+
+		const float normal[3] = { v.nx, v.ny, v.nz };
+		EncodeOctahedral(normal, q.nx, q.ny);
+
+		q.u = FloatToHalf(v.u);
+		q.v = FloatToHalf(v.v);
+		q.color = v.color;
+	}
+}
+
+
+MeshVertex VertexQuantizer::Decode(const MeshVertexQuantized& q, const float boundsMin[3], const float boundsMax[3])
+{
+	MeshVertex v;
+
+	const U16* qpos = &q.x;
+	float* pos = &v.x;
+	for (int a = 0; a < 3; ++a)
+	{
+		pos[a] = qpos[a] / UNORM16_MAX * (boundsMax[a] - boundsMin[a]) + boundsMin[a];
+	}
+
+	DecodeOctahedral(q.nx, q.ny, &v.nx);
+	v.u = HalfToFloat(q.u);
+	v.v = HalfToFloat(q.v);
+	v.color = q.color;
+	return v;
+}
+
+
+QuantizationError VertexQuantizer::Measure(const CookedMesh& mesh, const std::vector<MeshVertexQuantized>& quantized)
+{
+	QuantizationError error;
+
+	double positionSum = 0.0;
+	double normalSum = 0.0;
+	size_t numNormals = 0;
+	for (size_t i = 0; i < mesh.vertices.size() && i < quantized.size(); ++i)
+	{
+		const MeshVertex& v = mesh.vertices[i];
+		MeshVertex d = Decode(quantized[i], mesh.boundsMin, mesh.boundsMax);
+
+		float dx = d.x - v.x;
+		float dy = d.y - v.y;
+		float dz = d.z - v.z;
+		float positionError = sqrtf(dx * dx + dy * dy + dz * dz);
+		error.maxPosition = positionError > error.maxPosition ? positionError : error.maxPosition;
+		positionSum += (double)positionError * positionError;
+
+		float length = sqrtf(v.nx * v.nx + v.ny * v.ny + v.nz * v.nz);
+		if (length > 0.f)
+		{
+			float dot = (v.nx * d.nx + v.ny * d.ny + v.nz * d.nz) / length;
+			float degrees = acosf(dot > 1.f ? 1.f : (dot < -1.f ? -1.f : dot)) * RADIANS_TO_DEGREES;
+			error.maxNormalDegrees = degrees > error.maxNormalDegrees ? degrees : error.maxNormalDegrees;
+			normalSum += (double)degrees * degrees;
+			++numNormals;
+		}
+
+		float du = fabsf(d.u - v.u);
+		float dv = fabsf(d.v - v.v);
+		float uvError = du > dv ? du : dv;
+		error.maxUV = uvError > error.maxUV ? uvError : error.maxUV;
+	}
+
+	error.rmsPosition = mesh.vertices.empty() ? 0.f : (float)sqrt(positionSum / mesh.vertices.size());
+	error.rmsNormalDegrees = numNormals == 0 ? 0.f : (float)sqrt(normalSum / numNormals);
+	return error;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "MeshCook.h"
+
+
+// how far quantized vertices land from the float ones once the vertex shader has decoded them
+struct QuantizationError
+{
+	float maxPosition = 0.f;		// in mesh units
+	float rmsPosition = 0.f;
+	float maxNormalDegrees = 0.f;	// angle between the source normal and the decoded one, zero length normals are skipped
+	float rmsNormalDegrees = 0.f;
+	float maxUV = 0.f;
+};
+
+
+// encodes cooked vertices into MeshVertexQuantized and decodes them exactly like the QUANTIZED_VERTICES shaders
+class VertexQuantizer
+{
+public:
+	// positions are quantized across mesh.boundsMin/Max, which must be current
+	static void Encode(const CookedMesh& mesh, std::vector<MeshVertexQuantized>& quantized);
+	static MeshVertex Decode(const MeshVertexQuantized& vertex, const float boundsMin[3], const float boundsMax[3]);
+
+	static QuantizationError Measure(const CookedMesh& mesh, const std::vector<MeshVertexQuantized>& quantized);
+
+	// round to nearest even, out of range values become infinity
+	static U16 FloatToHalf(float f);
+	static float HalfToFloat(U16 h);
+};
\ No newline at end of file